@@ -202,6 +202,14 @@ void printStatus()
       Serial.println(F("computed CRC8 not match received CRC8, this feature supported only by AHT2x sensors"));
       break;
 
+    case AHTXX_BUS_ERROR:
+      Serial.println(F("I2C bus was stuck & cleared, measurement lost, check wiring & power if it repeats"));
+      break;
+
+    case AHTXX_NO_DATA_ERROR:
+      Serial.println(F("no measurement yet, read with AHTXX_FORCE_READ_DATA first"));
+      break;
+
     default:
       Serial.println(F("unknown status"));    
       break;
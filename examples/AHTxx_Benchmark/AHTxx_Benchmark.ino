@@ -0,0 +1,408 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino example for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   On-target benchmark of driver calls, timed with "micros()" on real "Wire":
+   - begin, soft reset, blocking read, asynchronous read (total & CPU
+     time inside library calls), read from previous data, raw decode,
+     frame check with & without CRC
+   - prints report between "#AHTXX_BENCHMARK" & "#END" lines, compare
+     reports of many boards with "extras/benchmark/AHTxxBoardReport.cpp"
+   - report line "metric,calls,min_ns,avg_ns,max_ns,errors", fast calls
+     are timed in batches, min/max are batch averages
+   - frame check runs on in-memory frame, no sensor needed, CRC cost is
+     difference of AHT2x & AHT1x frame check
+
+   NOTE:
+   - "micros()" resolution is 4usec on 16MHz AVR, 8usec on 8MHz AVR,
+     single bus calls are averaged over BENCHMARK_RUNS
+   - takes ~10sec, self-heating doesn't matter, values aren't used
+
+   This device uses I2C bus to communicate, specials pins are required to interface
+   Board:                                    SDA              SCL              Level
+   Uno, Mini, Pro, ATmega168, ATmega328..... A4               A5               5v
+   Mega2560................................. 20               21               5v
+   Due, SAM3X8E............................. 20               21               3.3v
+   Leonardo, Micro, ATmega32U4.............. 2                3                5v
+   Digistump, Trinket, ATtiny85............. PB0              PB2              5v
+   Blue Pill, STM32F103xxxx boards.......... PB7              PB6              3.3v/5v
+   ESP8266 ESP-01........................... GPIO0/D5         GPIO2/D3         3.3v/5v
+   NodeMCU 1.0, WeMos D1 Mini............... GPIO4/D2         GPIO5/D1         3.3v/5v
+   ESP32.................................... GPIO21/D21       GPIO22/D22       3.3v
+
+   Frameworks & Libraries:
+   ATtiny  Core          - https://github.com/SpenceKonde/ATTinyCore
+   ESP32   Core          - https://github.com/espressif/arduino-esp32
+   ESP8266 Core          - https://github.com/esp8266/Arduino
+   STM32   Core          - https://github.com/stm32duino/Arduino_Core_STM32
+                         - https://github.com/rogerclarkmelbourne/Arduino_STM32
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <Wire.h>
+#include <AHTxx.h>
+
+#define BENCHMARK_SENSOR  AHT2x_SENSOR //type of connected sensor, AHT1x_SENSOR or AHT2x_SENSOR
+#define BENCHMARK_RUNS    10           //runs per metric
+#define BENCHMARK_BATCH   100          //calls per run of fast metrics, without I2C
+
+#if   defined(ESP32)
+#define BENCHMARK_BOARD   "ESP32"
+#elif defined(ESP8266)
+#define BENCHMARK_BOARD   "ESP8266"
+#elif defined(_VARIANT_ARDUINO_STM32_) || defined(ARDUINO_ARCH_STM32)
+#define BENCHMARK_BOARD   "STM32"
+#elif defined(__AVR__)
+#define BENCHMARK_BOARD   "AVR"
+#else
+#define BENCHMARK_BOARD   "other"
+#endif
+
+
+struct Result
+{
+  uint32_t minTime; //in nanoseconds
+  uint32_t maxTime;
+  uint64_t sumTime;
+  uint16_t runs;
+  uint16_t calls;
+  uint16_t errors;
+};
+
+
+/* completes every transfer before return & always answers with same frame, no I2C */
+class FrameTransport : public AHTxxTransport
+{
+  public:
+
+   FrameTransport(const uint8_t *frame) : _frame(frame) {}
+
+   bool write(uint8_t, const uint8_t *, uint8_t, AHTxxTransportCallback callback, void *context)
+   {
+     callback(context, AHTXX_NO_ERROR);
+
+     return true;
+   }
+
+   bool read(uint8_t, uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context)
+   {
+     memcpy(data, _frame, length);
+
+     callback(context, AHTXX_NO_ERROR);
+
+     return true;
+   }
+
+
+  private:
+   const uint8_t *_frame;
+};
+
+
+const uint8_t frame[7] = {0x18, 0x66, 0x66, 0x65, 0xC2, 0x8F, 0xDE}; //RH 40%, T 26C, CRC8 of first 6 bytes
+
+volatile uint32_t sink; //keeps optimizer from dropping timed calls
+
+AHTxx aht(AHTXX_ADDRESS_X38, BENCHMARK_SENSOR); //sensor address, sensor type
+
+
+
+/**************************************************************************/
+/*
+    setup()
+
+    Main setup
+*/
+/**************************************************************************/
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+
+  while (aht.begin() != true)
+  {
+    Serial.println(F("AHTxx not connected or fail to load calibration coefficient")); //(F()) save string to flash & keeps dynamic memory free
+
+    delay(5000);
+  }
+
+  Serial.println(F("#AHTXX_BENCHMARK,1"));
+  Serial.print(F("board,"));
+  Serial.println(F(BENCHMARK_BOARD));
+  #if defined(F_CPU)
+  Serial.print(F("f_cpu,"));
+  Serial.println((uint32_t)F_CPU);
+  #endif
+  Serial.print(F("i2c_speed,"));
+  Serial.println((uint32_t)AHTXX_I2C_SPEED_100KHZ);
+  Serial.print(F("sensor,"));
+  Serial.println((BENCHMARK_SENSOR == AHT1x_SENSOR) ? F("AHT1x") : F("AHT2x"));
+  Serial.println(F("metric,calls,min_ns,avg_ns,max_ns,errors"));
+
+  Result result;
+
+  /* I2C calls */
+  measure(result, callBegin, 1);
+  printResult(F("begin"), result);
+
+  measure(result, callSoftReset, 1);
+  printResult(F("soft_reset"), result);
+
+  measure(result, callReadForce, 1);
+  printResult(F("read_force"), result);
+
+  Result cpuResult;
+
+  measureAsync(result, cpuResult);
+  printResult(F("read_async"), result);
+  printResult(F("read_async_cpu"), cpuResult);
+
+  /* data of last measurement, no I2C */
+  aht.readRawHumidity();
+
+  measure(result, callReadCached, BENCHMARK_BATCH);
+  printResult(F("read_cached"), result);
+
+  measure(result, callDecode, BENCHMARK_BATCH);
+  printResult(F("decode_raw"), result);
+
+  /* frame check, no sensor */
+  Result crcResult;
+
+  measureFrame(result, AHT1x_SENSOR);
+  printResult(F("frame_aht1x"), result);
+
+  measureFrame(crcResult, AHT2x_SENSOR);
+  printResult(F("frame_aht2x"), crcResult);
+
+  uint32_t frameTime = result.sumTime / result.runs;
+  uint32_t crcTime   = crcResult.sumTime / crcResult.runs;
+
+  crcResult.minTime = crcResult.maxTime = crcResult.sumTime = (crcTime > frameTime) ? (crcTime - frameTime) : 0; //difference of averages
+
+  crcResult.runs    = 1;
+  crcResult.calls   = BENCHMARK_RUNS;
+  crcResult.errors += result.errors;
+
+  printResult(F("crc"), crcResult);
+
+  Serial.println(F("#END"));
+}
+
+
+/**************************************************************************/
+/*
+    loop()
+
+     Main loop
+*/
+/**************************************************************************/
+void loop()
+{
+  //empty
+}
+
+
+/**************************************************************************/
+/*
+    timed calls, return false on error
+*/
+/**************************************************************************/
+bool callBegin()
+{
+  return aht.begin();
+}
+
+bool callSoftReset()
+{
+  return aht.softReset();
+}
+
+bool callReadForce()
+{
+  return aht.readTemperature() != AHTXX_ERROR; //read 6/7-bytes via I2C
+}
+
+bool callReadCached()
+{
+  float value = aht.readHumidity(AHTXX_USE_READ_DATA); //raw to float, use data from previous read
+
+  sink += (uint32_t)value;
+
+  return value != AHTXX_ERROR;
+}
+
+bool callDecode()
+{
+  uint32_t humidity    = aht.readRawHumidity(AHTXX_USE_READ_DATA);
+  uint32_t temperature = aht.readRawTemperature(AHTXX_USE_READ_DATA);
+
+  sink += humidity + temperature;
+
+  return humidity != AHTXX_RAW_ERROR;
+}
+
+
+/**************************************************************************/
+/*
+    measure()
+
+    Time BENCHMARK_RUNS runs of "calls" calls each, value is average
+    call time of run, in nanoseconds
+
+    NOTE:
+    - run must be shorter than 4.2sec, "(micros() * 1000)" overflow
+*/
+/**************************************************************************/
+void measure(Result &result, bool (*call)(), uint16_t calls)
+{
+  clearResult(result, calls);
+
+  for (uint8_t run = 0; run < BENCHMARK_RUNS; run++)
+  {
+    uint16_t errors    = 0;
+    uint32_t startTime = micros();
+
+    for (uint16_t i = 0; i < calls; i++)
+    {
+      if (call() != true) errors++;
+    }
+
+    uint32_t time = micros() - startTime;
+
+    addResult(result, time * 1000 / calls, errors);
+  }
+}
+
+
+/**************************************************************************/
+/*
+    measureAsync()
+
+    Time asynchronous measurement, start to ready & CPU time spent in
+    "startMeasurementAsync()" & "updateAsync()", in nanoseconds
+
+    NOTE:
+    - CPU time includes "micros()" overhead of every poll
+*/
+/**************************************************************************/
+void measureAsync(Result &result, Result &cpuResult)
+{
+  clearResult(result, 1);
+  clearResult(cpuResult, 1);
+
+  for (uint8_t run = 0; run < BENCHMARK_RUNS; run++)
+  {
+    uint32_t startTime = micros();
+
+    aht.startMeasurementAsync();
+
+    uint32_t cpuTime = micros() - startTime;
+    uint8_t  state   = AHTXX_ASYNC_IDLE;
+
+    while ((state != AHTXX_ASYNC_READY) && ((micros() - startTime) < 1000000)) //1sec timeout
+    {
+      uint32_t callTime = micros();
+
+      state = aht.updateAsync();
+
+      cpuTime += micros() - callTime;
+    }
+
+    uint32_t time   = micros() - startTime;
+    uint16_t errors = ((state != AHTXX_ASYNC_READY) || (aht.getStatus() != AHTXX_NO_ERROR)) ? 1 : 0;
+
+    addResult(result,    time    * 1000, errors);
+    addResult(cpuResult, cpuTime * 1000, errors);
+  }
+}
+
+
+/**************************************************************************/
+/*
+    measureFrame()
+
+    Time busy bit & CRC check of received frame, in nanoseconds
+
+    NOTE:
+    - second "updateAsync()" after conversion delay checks frame,
+      first one submits read, transfers complete instantly
+*/
+/**************************************************************************/
+void measureFrame(Result &result, AHTXX_I2C_SENSOR sensorType)
+{
+  FrameTransport transport(frame);
+  AHTxx          sensor(AHTXX_ADDRESS_X38, sensorType);
+
+  sensor.setTransport(&transport);
+
+  clearResult(result, 1);
+
+  for (uint8_t run = 0; run < BENCHMARK_RUNS; run++)
+  {
+    sensor.startMeasurementAsync();
+
+    delay(AHTXX_MEASUREMENT_DELAY + 1); //conversion time
+
+    sensor.updateAsync();               //submit read
+
+    uint32_t startTime = micros();
+
+    uint8_t state = sensor.updateAsync(); //busy bit & CRC check
+
+    uint32_t time = micros() - startTime;
+
+    addResult(result, time * 1000, ((state != AHTXX_ASYNC_READY) || (sensor.getStatus() != AHTXX_NO_ERROR)) ? 1 : 0);
+  }
+}
+
+
+/**************************************************************************/
+/*
+    clearResult(), addResult(), printResult()
+
+    Collect min/avg/max of runs & print report line
+*/
+/**************************************************************************/
+void clearResult(Result &result, uint16_t calls)
+{
+  result.minTime = 0xFFFFFFFF;
+  result.maxTime = 0;
+  result.sumTime = 0;
+  result.runs    = 0;
+  result.calls   = calls;
+  result.errors  = 0;
+}
+
+void addResult(Result &result, uint32_t time, uint16_t errors)
+{
+  if (time < result.minTime) result.minTime = time;
+  if (time > result.maxTime) result.maxTime = time;
+
+  result.sumTime += time;
+  result.errors  += errors;
+
+  result.runs++;
+}
+
+void printResult(const __FlashStringHelper *name, const Result &result)
+{
+  Serial.print(name);
+  Serial.print(',');
+  Serial.print((uint32_t)result.runs * result.calls);
+  Serial.print(',');
+  Serial.print(result.minTime);
+  Serial.print(',');
+  Serial.print((uint32_t)(result.sumTime / result.runs));
+  Serial.print(',');
+  Serial.print(result.maxTime);
+  Serial.print(',');
+  Serial.println(result.errors);
+}
@@ -0,0 +1,194 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino example for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Measurement control byte characterization:
+   - for every candidate control byte sent after start measurement
+     command (0xAC, ctrl, 0x00) measures conversion time by polling
+     busy bit & noise of raw T/RH data
+   - prints CSV report, default library value is 0x33
+   - keep sensor in stable conditions, any T/RH change looks like noise
+
+   This device uses I2C bus to communicate, specials pins are required to interface
+   Board:                                    SDA              SCL              Level
+   Uno, Mini, Pro, ATmega168, ATmega328..... A4               A5               5v
+   Mega2560................................. 20               21               5v
+   Due, SAM3X8E............................. 20               21               3.3v
+   Leonardo, Micro, ATmega32U4.............. 2                3                5v
+   Digistump, Trinket, ATtiny85............. PB0              PB2              5v
+   Blue Pill, STM32F103xxxx boards.......... PB7              PB6              3.3v/5v
+   ESP8266 ESP-01........................... GPIO0/D5         GPIO2/D3         3.3v/5v
+   NodeMCU 1.0, WeMos D1 Mini............... GPIO4/D2         GPIO5/D1         3.3v/5v
+   ESP32.................................... GPIO21/D21       GPIO22/D22       3.3v
+
+   Frameworks & Libraries:
+   ATtiny  Core          - https://github.com/SpenceKonde/ATTinyCore
+   ESP32   Core          - https://github.com/espressif/arduino-esp32
+   ESP8266 Core          - https://github.com/esp8266/Arduino
+   STM32   Core          - https://github.com/stm32duino/Arduino_Core_STM32
+                         - https://github.com/rogerclarkmelbourne/Arduino_STM32
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <Wire.h>
+#include <AHTxx.h>
+
+#define SAMPLES            16     //samples per control byte
+#define SAMPLE_INTERVAL    2000   //measurement with high frequency leads to heating of the sensor, in milliseconds
+#define CONVERSION_TIMEOUT 500000 //max conversion time, in microseconds
+
+const uint8_t candidates[] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77}; //0x33 is library default
+
+AHTxx aht(AHTXX_ADDRESS_X38, AHT2x_SENSOR); //sensor address, sensor type
+
+
+
+/**************************************************************************/
+/*
+    setup()
+
+    Main setup
+*/
+/**************************************************************************/
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+
+  while (aht.begin() != true)
+  {
+    Serial.println(F("AHTxx not connected or fail to load calibration coefficient")); //(F()) save string to flash & keeps dynamic memory free
+
+    delay(5000);
+  }
+
+  Serial.println(F("ctrl,conversion_us,rh_mean_raw,rh_std_raw,t_mean_raw,t_std_raw,errors"));
+
+  for (uint8_t i = 0; i < sizeof(candidates); i++)
+  {
+    characterize(candidates[i]);
+  }
+
+  aht.setMeasurementControl(); //restore default control byte
+
+  Serial.println(F("done"));
+}
+
+
+/**************************************************************************/
+/*
+    loop()
+
+     Main loop
+*/
+/**************************************************************************/
+void loop()
+{
+  //empty
+}
+
+
+/**************************************************************************/
+/*
+    characterize()
+
+    Measure conversion time & noise for control byte & print CSV line
+*/
+/**************************************************************************/
+void characterize(uint8_t ctrl)
+{
+  uint32_t conversionTime = measureConversionTime(ctrl);
+
+  delay(SAMPLE_INTERVAL);
+
+  aht.setMeasurementControl(ctrl);
+
+  float   humidityMean    = 0; //Welford's online mean & variance
+  float   humidityM2      = 0;
+  float   temperatureMean = 0;
+  float   temperatureM2   = 0;
+  uint8_t count           = 0;
+  uint8_t errors          = 0;
+
+  for (uint8_t i = 0; i < SAMPLES; i++)
+  {
+    uint32_t humidity    = aht.readRawHumidity();                      //read 6/7-bytes via I2C
+    uint32_t temperature = aht.readRawTemperature(AHTXX_USE_READ_DATA); //use same bytes
+
+    if (humidity == AHTXX_RAW_ERROR)
+    {
+      errors++;
+    }
+    else
+    {
+      count++;
+
+      float delta      = humidity - humidityMean;
+      humidityMean    += delta / count;
+      humidityM2      += delta * (humidity - humidityMean);
+
+            delta      = temperature - temperatureMean;
+      temperatureMean += delta / count;
+      temperatureM2   += delta * (temperature - temperatureMean);
+    }
+
+    delay(SAMPLE_INTERVAL);
+  }
+
+  Serial.print(F("0x"));
+  Serial.print(ctrl, HEX);
+  Serial.print(',');
+  Serial.print(conversionTime);
+  Serial.print(',');
+  Serial.print(humidityMean, 1);
+  Serial.print(',');
+  Serial.print((count > 1) ? sqrt(humidityM2 / (count - 1)) : 0, 1);
+  Serial.print(',');
+  Serial.print(temperatureMean, 1);
+  Serial.print(',');
+  Serial.print((count > 1) ? sqrt(temperatureM2 / (count - 1)) : 0, 1);
+  Serial.print(',');
+  Serial.println(errors);
+}
+
+
+/**************************************************************************/
+/*
+    measureConversionTime()
+
+    Start measurement with control byte & poll busy bit until
+    measurement is completed, in microseconds
+
+    NOTE:
+    - every poll is 1-byte I2C read, ~100usec at 100KHz
+    - returns 0 if sensor didn't return ACK or timeout
+*/
+/**************************************************************************/
+uint32_t measureConversionTime(uint8_t ctrl)
+{
+  Wire.beginTransmission(AHTXX_ADDRESS_X38);
+
+  Wire.write(AHTXX_START_MEASUREMENT_REG);
+  Wire.write(ctrl);
+  Wire.write(AHTXX_START_MEASUREMENT_CTRL_NOP);
+
+  if (Wire.endTransmission(true) != 0) return 0; //sensor didn't return ACK
+
+  uint32_t startTime = micros();
+
+  while ((micros() - startTime) < CONVERSION_TIMEOUT)
+  {
+    Wire.requestFrom(AHTXX_ADDRESS_X38, 1);
+
+    if ((Wire.available() == 1) && ((Wire.read() & AHTXX_STATUS_CTRL_BUSY) == 0)) return micros() - startTime;
+  }
+
+  return 0;
+}
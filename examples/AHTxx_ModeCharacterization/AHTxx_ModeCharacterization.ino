@@ -0,0 +1,268 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino example for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Normal, cycle & command mode characterization, for AHT1x only:
+   - latency, time of blocking read call, in cycle mode read doesn't
+     send measurement command & doesn't wait for conversion
+   - read rate & fresh rate of back-to-back reads, fresh sample is raw
+     data different from previous read, change period is time between
+     fresh samples, in cycle mode it is sensor's own measurement period
+   - busy duty, share of 1msec status polls with busy bit set while
+     reading every DUTY_INTERVAL, current estimate is sleep current +
+     duty * measurement current of part descriptor
+   - prints CSV report, compare with "extras/simulator/AHTxxModes.cpp"
+     & tune AHTXX_CYCLE_PERIOD for "setModePolicy()"
+
+   NOTE:
+   - busy bit may stay 0 in cycle mode, then duty doesn't show current,
+     put meter or shunt in VDD line, "# mode" lines mark start of every
+     mode, back-to-back reads phase lasts RATE_WINDOW
+   - keep sensor in stable conditions, rare raw data repeat lowers
+     fresh rate
+
+   This device uses I2C bus to communicate, specials pins are required to interface
+   Board:                                    SDA              SCL              Level
+   Uno, Mini, Pro, ATmega168, ATmega328..... A4               A5               5v
+   Mega2560................................. 20               21               5v
+   Due, SAM3X8E............................. 20               21               3.3v
+   Leonardo, Micro, ATmega32U4.............. 2                3                5v
+   Digistump, Trinket, ATtiny85............. PB0              PB2              5v
+   Blue Pill, STM32F103xxxx boards.......... PB7              PB6              3.3v/5v
+   ESP8266 ESP-01........................... GPIO0/D5         GPIO2/D3         3.3v/5v
+   NodeMCU 1.0, WeMos D1 Mini............... GPIO4/D2         GPIO5/D1         3.3v/5v
+   ESP32.................................... GPIO21/D21       GPIO22/D22       3.3v
+
+   Frameworks & Libraries:
+   ATtiny  Core          - https://github.com/SpenceKonde/ATTinyCore
+   ESP32   Core          - https://github.com/espressif/arduino-esp32
+   ESP8266 Core          - https://github.com/esp8266/Arduino
+   STM32   Core          - https://github.com/stm32duino/Arduino_Core_STM32
+                         - https://github.com/rogerclarkmelbourne/Arduino_STM32
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <Wire.h>
+#include <AHTxx.h>
+
+#define LATENCY_READS    20     //reads per latency test
+#define READ_INTERVAL    250    //time between latency reads, in milliseconds
+#define RATE_WINDOW      3000   //back-to-back reads time, in milliseconds
+#define DUTY_WINDOW      10000  //busy duty time, in milliseconds
+#define DUTY_INTERVAL    1000   //time between reads during busy duty test, in milliseconds
+#define SLEEP_CURRENT    0.25   //sensor sleep current, in microamperes
+
+const uint8_t modes[] = {AHTXX_NORMAL_MODE, AHTXX_CYCLE_MODE, AHTXX_COMMAND_MODE};
+
+AHTxx aht(AHTXX_ADDRESS_X38, AHT10_PART); //sensor address, exact part number
+
+
+
+/**************************************************************************/
+/*
+    setup()
+
+    Main setup
+*/
+/**************************************************************************/
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+
+  while (aht.begin() != true)
+  {
+    Serial.println(F("AHT1x not connected or fail to load calibration coefficient")); //(F()) save string to flash & keeps dynamic memory free
+
+    delay(5000);
+  }
+
+  Serial.println(F("mode,latency_mean_us,latency_max_us,read_rate_hz,fresh_rate_hz,change_period_ms,busy_duty,est_current_ua,errors"));
+
+  for (uint8_t i = 0; i < sizeof(modes); i++)
+  {
+    characterize(modes[i]);
+  }
+
+  aht.setNormalMode(); //restore default mode
+
+  Serial.println(F("done"));
+}
+
+
+/**************************************************************************/
+/*
+    loop()
+
+     Main loop
+*/
+/**************************************************************************/
+void loop()
+{
+  //empty
+}
+
+
+/**************************************************************************/
+/*
+    characterize()
+
+    Measure latency, read rate & busy duty of mode & print CSV line
+*/
+/**************************************************************************/
+void characterize(uint8_t mode)
+{
+  Serial.print(F("# mode "));
+  Serial.println(mode);
+
+  if (setMode(mode) != true)
+  {
+    Serial.println(F("can't set mode, I2C error"));
+
+    return;
+  }
+
+  delay(2 * AHTXX_CYCLE_PERIOD); //first cycle mode data
+
+  uint16_t errors = 0;
+
+  /* latency */
+  uint32_t latencySum = 0;
+  uint32_t latencyMax = 0;
+
+  for (uint8_t i = 0; i < LATENCY_READS; i++)
+  {
+    uint32_t startTime = micros();
+
+    if (aht.readRawTemperature() == AHTXX_RAW_ERROR) errors++;
+
+    uint32_t latency = micros() - startTime;
+
+    latencySum += latency;
+
+    if (latency > latencyMax) latencyMax = latency;
+
+    delay(READ_INTERVAL);
+  }
+
+  /* back-to-back reads */
+  uint32_t reads     = 0;
+  uint32_t fresh     = 0;
+  uint32_t previous  = AHTXX_RAW_ERROR;
+  uint32_t startTime = millis();
+
+  while ((millis() - startTime) < RATE_WINDOW)
+  {
+    uint32_t raw = aht.readRawTemperature();
+
+    reads++;
+
+    if (raw == AHTXX_RAW_ERROR)
+    {
+      errors++;
+
+      continue;
+    }
+
+    if (raw != previous) fresh++;
+
+    previous = raw;
+  }
+
+  /* busy duty */
+  float duty = measureBusyDuty();
+
+  AHTxxPart part;
+
+  aht.getPartInfo(&part);
+
+  Serial.print(mode);
+  Serial.print(',');
+  Serial.print(latencySum / LATENCY_READS);
+  Serial.print(',');
+  Serial.print(latencyMax);
+  Serial.print(',');
+  Serial.print(reads * 1000.0 / RATE_WINDOW, 2);
+  Serial.print(',');
+  Serial.print(fresh * 1000.0 / RATE_WINDOW, 2);
+  Serial.print(',');
+  Serial.print((fresh != 0) ? (float)RATE_WINDOW / fresh : 0, 1);
+  Serial.print(',');
+  Serial.print(duty, 4);
+  Serial.print(',');
+  Serial.print(SLEEP_CURRENT + duty * (part.maxCurrent - SLEEP_CURRENT), 2);
+  Serial.print(',');
+  Serial.println(errors);
+}
+
+
+/**************************************************************************/
+/*
+    measureBusyDuty()
+
+    Read every DUTY_INTERVAL with asynchronous measurement & poll busy
+    bit every 1msec, return share of polls with busy bit set
+*/
+/**************************************************************************/
+float measureBusyDuty()
+{
+  uint32_t polls     = 0;
+  uint32_t busy      = 0;
+  uint32_t startTime = millis();
+  uint32_t readTime  = startTime - DUTY_INTERVAL;
+
+  while ((millis() - startTime) < DUTY_WINDOW)
+  {
+    if ((millis() - readTime) >= DUTY_INTERVAL)
+    {
+      readTime = millis();
+
+      aht.startMeasurementAsync();
+    }
+
+    aht.updateAsync();
+
+    Wire.requestFrom(AHTXX_ADDRESS_X38, 1); //status byte
+
+    if (Wire.available() == 1)
+    {
+      if ((Wire.read() & AHTXX_STATUS_CTRL_BUSY) != 0) busy++;
+
+      polls++;
+    }
+
+    delay(1);
+  }
+
+  return (polls != 0) ? (float)busy / polls : 0;
+}
+
+
+/**************************************************************************/
+/*
+    setMode()
+
+    Set measurement mode, true=success, false=I2C error
+*/
+/**************************************************************************/
+bool setMode(uint8_t mode)
+{
+  switch (mode)
+  {
+    case AHTXX_CYCLE_MODE:
+      return aht.setCycleMode();
+
+    case AHTXX_COMMAND_MODE:
+      return aht.setComandMode();
+
+    default:
+      return aht.setNormalMode();
+  }
+}
@@ -0,0 +1,253 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino example for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   On-target measurement of CPU time freed during AVR TWI transfers, see "AHTxxTWI.h":
+   - measurement command (3 bytes) & data frame (7 bytes) are queued on
+     "AHTxxTwi", loop does fixed work units until transfer is done
+   - work unit time is calibrated without transfer, CPU-free time is
+     units done during transfer * unit time, rest is TWI_vect or
+     "poll()" & waiting for next event
+   - prints report between "#AHTXX_TWI_CPU_TIME" & "#END" lines, report
+     line "transfer,bytes,runs,bus_us,free_us,free_pct,events", times
+     are averages per transfer
+
+   NOTE:
+   - AVR with TWI only, e.g. Uno, Mega2560, Leonardo
+   - interrupt mode, build with "-DAHTXX_USE_TWI_INTERRUPT" for every
+     translation unit, implies "AHTXX_NO_WIRE", don't include "Wire.h"
+     - PlatformIO: build_flags = -DAHTXX_USE_TWI_INTERRUPT
+     - arduino-cli: --build-property "compiler.cpp.extra_flags=-DAHTXX_USE_TWI_INTERRUPT"
+   - default polled mode, same sketch, "poll()" is called once per work
+     unit, transfer stalls between calls, see "AHTxxTWI.h"
+   - "micros()" resolution is 4usec on 16MHz AVR, transfer times are
+     averaged over CPU_TIME_RUNS
+
+   This device uses I2C bus to communicate, specials pins are required to interface
+   Board:                                    SDA              SCL              Level
+   Uno, Mini, Pro, ATmega168, ATmega328..... A4               A5               5v
+   Mega2560................................. 20               21               5v
+   Leonardo, Micro, ATmega32U4.............. 2                3                5v
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <AHTxx.h>
+
+#if !defined(__AVR__) || !defined(TWCR)
+#error "AVR with TWI only"
+#endif
+
+#define CPU_TIME_SENSOR       AHT2x_SENSOR //type of connected sensor, AHT1x_SENSOR or AHT2x_SENSOR
+#define CPU_TIME_RUNS         20           //transfers per metric
+#define CPU_TIME_UNIT         32           //increments per work unit, ~20usec on 16MHz AVR
+#define CPU_TIME_CALIBRATION  200000       //work unit calibration time, in microseconds
+
+#if defined(AHTXX_USE_TWI_INTERRUPT)
+#define CPU_TIME_MODE         "interrupt"
+#else
+#define CPU_TIME_MODE         "polled"
+#endif
+
+
+volatile uint8_t work;   //keeps optimizer from dropping work units
+uint32_t         unitNs; //calibrated work unit time, in nanoseconds
+
+AHTxxTWITransport twi;
+
+#if defined(AHTXX_NO_WIRE)
+AHTxx aht(twi, AHTXX_ADDRESS_X38, CPU_TIME_SENSOR); //all transfers over "AHTxxTwi"
+#else
+AHTxx aht(AHTXX_ADDRESS_X38, CPU_TIME_SENSOR);      //blocking functions over "Wire.h"
+#endif
+
+
+
+/**************************************************************************/
+/*
+    setup()
+
+    Main setup
+*/
+/**************************************************************************/
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+
+  while (aht.begin() != true)
+  {
+    Serial.println(F("AHTxx not connected or fail to load calibration coefficient")); //(F()) save string to flash & keeps dynamic memory free
+
+    delay(5000);
+  }
+
+  #if !defined(AHTXX_NO_WIRE)
+  AHTxxTwi.begin();                           //after "Wire.begin()", same speed
+  #endif
+
+  calibrate();
+
+  Serial.println(F("#AHTXX_TWI_CPU_TIME,1"));
+  Serial.print(F("mode,"));
+  Serial.println(F(CPU_TIME_MODE));
+  Serial.print(F("f_cpu,"));
+  Serial.println((uint32_t)F_CPU);
+  Serial.print(F("i2c_speed,"));
+  Serial.println((uint32_t)AHTXX_TWI_SPEED_100KHZ);
+  Serial.print(F("unit_ns,"));
+  Serial.println(unitNs);
+  Serial.println(F("transfer,bytes,runs,bus_us,free_us,free_pct,events"));
+
+  uint8_t command[3] = {AHTXX_START_MEASUREMENT_REG, AHTXX_START_MEASUREMENT_CTRL, AHTXX_START_MEASUREMENT_CTRL_NOP};
+  uint8_t frame[7];
+  uint8_t frameSize = (CPU_TIME_SENSOR == AHT1x_SENSOR) ? 6 : 7;
+
+  uint32_t busTime[2]  = {0, 0};
+  uint32_t freeTime[2] = {0, 0};
+  uint32_t events[2]   = {0, 0};
+  uint8_t  errors      = 0;
+
+  for (uint8_t run = 0; run < CPU_TIME_RUNS; run++)
+  {
+    errors += measure(false, command, sizeof(command), busTime[0], freeTime[0], events[0]);
+
+    delay(AHTXX_MEASUREMENT_DELAY);           //wait for measurement to complete
+
+    errors += measure(true, frame, frameSize, busTime[1], freeTime[1], events[1]);
+  }
+
+  printResult(F("trigger"), sizeof(command), busTime[0], freeTime[0], events[0]);
+  printResult(F("frame"),   frameSize,       busTime[1], freeTime[1], events[1]);
+
+  Serial.print(F("errors,"));
+  Serial.println(errors);
+
+  Serial.println(F("#END"));
+}
+
+
+/**************************************************************************/
+/*
+    loop()
+
+     Main loop
+*/
+/**************************************************************************/
+void loop()
+{
+  //empty
+}
+
+
+/**************************************************************************/
+/*
+    unit()
+
+    Fixed amount of application work
+*/
+/**************************************************************************/
+void unit()
+{
+  for (uint8_t i = 0; i < CPU_TIME_UNIT; i++) work++;
+}
+
+
+/**************************************************************************/
+/*
+    calibrate()
+
+    Measure work unit time without transfer
+
+    NOTE:
+    - "micros()" is called every 16 units, its cost is ~1% of result
+*/
+/**************************************************************************/
+void calibrate()
+{
+  uint32_t units     = 0;
+  uint32_t startTime = micros();
+
+  while ((micros() - startTime) < CPU_TIME_CALIBRATION)
+  {
+    for (uint8_t i = 0; i < 16; i++) unit();
+
+    units += 16;
+  }
+
+  unitNs = ((uint64_t)(micros() - startTime) * 1000) / units;
+}
+
+
+/**************************************************************************/
+/*
+    measure()
+
+    Queue one transfer & do work units until it is done
+
+    NOTE:
+    - adds transfer time, CPU-free time & TWI events to sums
+    - returns 1 on error
+*/
+/**************************************************************************/
+uint8_t measure(bool isRead, uint8_t *data, uint8_t length, uint32_t &busTime, uint32_t &freeTime, uint32_t &events)
+{
+  uint16_t startEvents = AHTxxTwi.getInterruptCount();
+  uint32_t units       = 0;
+  uint32_t startTime   = micros();
+
+  bool queued = (isRead == true) ? AHTxxTwi.read(AHTXX_ADDRESS_X38, data, length) : AHTxxTwi.write(AHTXX_ADDRESS_X38, data, length);
+
+  if (queued != true) return 1;               //no reason to continue, queue full
+
+  while (AHTxxTwi.isIdle() != true)
+  {
+    AHTxxTwi.poll();                          //does nothing in interrupt mode
+
+    unit();
+
+    units++;
+  }
+
+  busTime  += micros() - startTime;
+  freeTime += (units * unitNs) / 1000;
+  events   += (uint16_t)(AHTxxTwi.getInterruptCount() - startEvents);
+
+  return (AHTxxTwi.getResult() == AHTXX_TWI_NO_ERROR) ? 0 : 1;
+}
+
+
+/**************************************************************************/
+/*
+    printResult()
+
+    Print report line, averages per transfer
+*/
+/**************************************************************************/
+void printResult(const __FlashStringHelper *name, uint8_t bytes, uint32_t busTime, uint32_t freeTime, uint32_t events)
+{
+  uint32_t busAvg  = busTime  / CPU_TIME_RUNS;
+  uint32_t freeAvg = freeTime / CPU_TIME_RUNS;
+
+  if (freeAvg > busAvg) freeAvg = busAvg;     //last unit may end after transfer
+
+  Serial.print(name);
+  Serial.print(',');
+  Serial.print(bytes);
+  Serial.print(',');
+  Serial.print(CPU_TIME_RUNS);
+  Serial.print(',');
+  Serial.print(busAvg);
+  Serial.print(',');
+  Serial.print(freeAvg);
+  Serial.print(',');
+  Serial.print((busAvg != 0) ? (100 * freeAvg / busAvg) : 0);
+  Serial.print(',');
+  Serial.println(events / CPU_TIME_RUNS);
+}
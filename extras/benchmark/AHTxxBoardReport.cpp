@@ -0,0 +1,263 @@
+/***************************************************************************************************/
+/*
+   Comparison table of "examples/AHTxx_Benchmark" reports from many boards
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Build & run on a Linux/macOS host:
+   - g++ -O2 -std=c++11 AHTxxBoardReport.cpp -o board_report
+   - ./board_report [options] report1.txt [report2.txt ...]
+     -f min|avg|max  value column, default avg
+     -c              CSV instead of Markdown table
+   - report files are raw serial logs, "-" is stdin, every block between
+     "#AHTXX_BENCHMARK" & "#END" is one column, lines outside blocks &
+     "\r" are ignored
+
+   Output:
+   - one row per metric in order of first report, one column per board,
+     in microseconds, column title "board@MHz sensor"
+   - "(n err)" after value if any timed call failed, "-" if metric is
+     missing in report
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+
+#define REPORT_FIELD_MIN  0
+#define REPORT_FIELD_AVG  1
+#define REPORT_FIELD_MAX  2
+
+
+struct Metric
+{
+  std::string name;
+  double      value[3];                                        //min, avg, max, in nanoseconds
+  unsigned    errors;
+};
+
+struct Report
+{
+  std::string         title;
+  std::vector<Metric> metrics;
+};
+
+
+static const Metric *findMetric(const Report &report, const std::string &name)
+{
+  for (size_t i = 0; i < report.metrics.size(); i++)
+  {
+    if (report.metrics[i].name == name) return &report.metrics[i];
+  }
+
+  return 0;
+}
+
+
+/**************************************************************************/
+/*
+    Report parser
+*/
+/**************************************************************************/
+static void finishReport(Report &report, const std::string &board, const std::string &cpu, const std::string &sensor, std::vector<Report> &reports)
+{
+  report.title = board.empty() ? "unknown" : board;
+
+  if (cpu.empty() != true) report.title += "@" + std::to_string(atol(cpu.c_str()) / 1000000) + "MHz";
+  if (sensor.empty() != true) report.title += " " + sensor;
+
+  reports.push_back(report);
+}
+
+static bool loadReports(const char *path, std::vector<Report> &reports)
+{
+  FILE *file = (strcmp(path, "-") == 0) ? stdin : fopen(path, "r");
+
+  if (file == 0) return false;
+
+  char        line[256];
+  bool        active = false;
+  Report      report;
+  std::string board;
+  std::string cpu;
+  std::string sensor;
+
+  while (fgets(line, sizeof(line), file) != 0)
+  {
+    line[strcspn(line, "\r\n")] = '\0';
+
+    if (strncmp(line, "#AHTXX_BENCHMARK", 16) == 0)
+    {
+      active = true;
+
+      report = Report();
+      board.clear();
+      cpu.clear();
+      sensor.clear();
+
+      continue;
+    }
+
+    if (active != true) continue;
+
+    if (strcmp(line, "#END") == 0)
+    {
+      finishReport(report, board, cpu, sensor, reports);
+
+      active = false;
+
+      continue;
+    }
+
+    char   name[64];
+    char   text[64];
+    Metric metric;
+
+    if (sscanf(line, "%63[^,],%*u,%lf,%lf,%lf,%u", name, &metric.value[0], &metric.value[1], &metric.value[2], &metric.errors) == 5)
+    {
+      metric.name = name;
+
+      report.metrics.push_back(metric);
+    }
+    else if (sscanf(line, "%63[^,],%63s", name, text) == 2)
+    {
+      if      (strcmp(name, "board")  == 0) board  = text;
+      else if (strcmp(name, "f_cpu")  == 0) cpu    = text;
+      else if (strcmp(name, "sensor") == 0) sensor = text;
+    }
+  }
+
+  if (active == true)                                          //log cut before "#END", keep what was received
+  {
+    fprintf(stderr, "%s: report without #END\n", path);
+
+    finishReport(report, board, cpu, sensor, reports);
+  }
+
+  if (file != stdin) fclose(file);
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    Table
+*/
+/**************************************************************************/
+static std::string formatCell(const Metric *metric, uint8_t field)
+{
+  if (metric == 0) return "-";
+
+  char cell[48];
+
+  snprintf(cell, sizeof(cell), "%.3f", metric->value[field] / 1000);
+
+  if (metric->errors == 0) return cell;
+
+  return std::string(cell) + " (" + std::to_string(metric->errors) + " err)";
+}
+
+static void printTable(const std::vector<Report> &reports, uint8_t field, bool csv)
+{
+  std::vector<std::string> names;                              //union of metric names, first seen order
+
+  for (size_t i = 0; i < reports.size(); i++)
+  {
+    for (size_t j = 0; j < reports[i].metrics.size(); j++)
+    {
+      bool known = false;
+
+      for (size_t k = 0; k < names.size(); k++)
+      {
+        if (names[k] == reports[i].metrics[j].name) known = true;
+      }
+
+      if (known != true) names.push_back(reports[i].metrics[j].name);
+    }
+  }
+
+  const char *separator = (csv == true) ? "," : " | ";
+
+  printf("%s%s", (csv == true) ? "" : "| ", "metric (us)");
+
+  for (size_t i = 0; i < reports.size(); i++) printf("%s%s", separator, reports[i].title.c_str());
+
+  printf("%s\n", (csv == true) ? "" : " |");
+
+  if (csv != true)
+  {
+    printf("|---");
+
+    for (size_t i = 0; i < reports.size(); i++) printf("|--:");
+
+    printf("|\n");
+  }
+
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    printf("%s%s", (csv == true) ? "" : "| ", names[i].c_str());
+
+    for (size_t j = 0; j < reports.size(); j++)
+    {
+      printf("%s%s", separator, formatCell(findMetric(reports[j], names[i]), field).c_str());
+    }
+
+    printf("%s\n", (csv == true) ? "" : " |");
+  }
+}
+
+
+int main(int argc, char **argv)
+{
+  std::vector<Report> reports;
+  uint8_t             field = REPORT_FIELD_AVG;
+  bool                csv   = false;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if ((strcmp(argv[i], "-f") == 0) && (i + 1 < argc))
+    {
+      i++;
+
+      if      (strcmp(argv[i], "min") == 0) field = REPORT_FIELD_MIN;
+      else if (strcmp(argv[i], "avg") == 0) field = REPORT_FIELD_AVG;
+      else if (strcmp(argv[i], "max") == 0) field = REPORT_FIELD_MAX;
+      else
+      {
+        fprintf(stderr, "unknown field %s\n", argv[i]);
+
+        return 1;
+      }
+    }
+    else if (strcmp(argv[i], "-c") == 0)
+    {
+      csv = true;
+    }
+    else if (loadReports(argv[i], reports) != true)
+    {
+      fprintf(stderr, "can't read %s\n", argv[i]);
+
+      return 1;
+    }
+  }
+
+  if (reports.empty() == true)
+  {
+    fprintf(stderr, "usage: %s [-f min|avg|max] [-c] report1.txt [report2.txt ...]\n", argv[0]);
+
+    return 1;
+  }
+
+  printTable(reports, field, csv);
+
+  return 0;
+}
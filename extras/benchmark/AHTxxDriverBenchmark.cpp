@@ -0,0 +1,389 @@
+/***************************************************************************************************/
+/*
+   Host benchmark & performance-regression check of AHTxx driver
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Build & run on a Linux/macOS host:
+   - g++ -O2 -std=c++11 -I../host -I../../src AHTxxDriverBenchmark.cpp ../host/HostArduino.cpp ../host/AHTxxSimDevice.cpp
+       ../../src/AHTxx.cpp ../../src/AHTxxTransport.cpp ../../src/AHTxxTWI.cpp ../../src/AHTxxUncertainty.cpp -o driver_benchmark
+   - ./driver_benchmark [baseline.csv]           compare, exit code 1 if any exact metric regressed
+   - ./driver_benchmark baseline.csv --update    write current values as new baseline
+   - or "ctest" in CMake build against "AHTxxDriverBaseline.csv", see "CMakeLists.txt"
+
+   Metrics:
+   - bus transactions, blocking time & bus time per sample, counted by
+     "AHTxx::getTransactionCount()" & "AHTxx::getBlockingTime()" against
+     simulated sensor on virtual-time "Wire", exact on every host
+   - decode, frame check with & without CRC, host nanoseconds, only
+     relative cost, report-only, depend on host & build type, never
+     gated & not stored in baseline
+
+   NOTE:
+   - baseline file is CSV "metric,value,tolerance%,floor", floor is
+     absolute noise margin in metric units, 0 if omitted
+   - metric regressed if current value > max(value * (1 + tolerance / 100),
+     value + floor), exact metric without baseline line fails
+   - check passes in any build type, compare host timings of optimized
+     builds (-O2, CMake "Release") by hand, unoptimized are ~2x slower
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "AHTxx.h"
+#include "AHTxxSimDevice.h"
+
+
+#define BENCHMARK_SAMPLES        100      //simulated measurements
+#define BENCHMARK_ITERATIONS     2000000  //host timing loops
+#define BENCHMARK_TOLERANCE      2        //tolerance of exact metrics, in %
+
+
+struct Metric
+{
+  std::string name;
+  double      value;
+  double      tolerance;
+  double      floor;
+  bool        report;                                          //host timing, printed only, never gated
+};
+
+
+/* completes every transfer before return & always answers with same frame */
+class FrameTransport : public AHTxxTransport
+{
+  public:
+
+   FrameTransport(const uint8_t *frame) : _frame(frame) {}
+
+   bool write(uint8_t, const uint8_t *, uint8_t, AHTxxTransportCallback callback, void *context)
+   {
+     callback(context, AHTXX_NO_ERROR);
+
+     return true;
+   }
+
+   bool read(uint8_t, uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context)
+   {
+     memcpy(data, _frame, length);
+
+     callback(context, AHTXX_NO_ERROR);
+
+     return true;
+   }
+
+
+  private:
+   const uint8_t *_frame;
+};
+
+
+static volatile uint32_t sink;                                 //keeps optimizer from dropping loops
+
+
+static double nanoseconds(std::chrono::steady_clock::time_point startTime, uint32_t iterations)
+{
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count() / iterations;
+}
+
+
+/**************************************************************************/
+/*
+    Measurement path on simulated sensor, exact metrics
+*/
+/**************************************************************************/
+static void measureBlocking(std::vector<Metric> &metrics)
+{
+  AHTxxSimDevice device(true);
+  AHTxx          sensor(AHTXX_ADDRESS_X38, AHT2x_SENSOR);
+
+  Wire.detach();
+  Wire.attach(AHTXX_ADDRESS_X38, &device);
+
+  sensor.begin(100000);
+
+  sensor.resetStatistics();
+  Wire.resetStatistics();
+
+  for (uint16_t i = 0; i < BENCHMARK_SAMPLES; i++)
+  {
+    sensor.readTemperature();
+    sensor.readHumidity(AHTXX_USE_READ_DATA);
+
+    delay(AHTXX_SELF_HEATING_INTERVAL);
+  }
+
+  Metric transactions = {"blocking_transactions_per_sample", (double)sensor.getTransactionCount() / BENCHMARK_SAMPLES, BENCHMARK_TOLERANCE, 0, false};
+  Metric blocking     = {"blocking_time_us_per_sample",      (double)sensor.getBlockingTime()     / BENCHMARK_SAMPLES, BENCHMARK_TOLERANCE, 0, false};
+  Metric busTime      = {"blocking_bus_time_us_per_sample",  (double)Wire.getBusyTime()           / BENCHMARK_SAMPLES, BENCHMARK_TOLERANCE, 0, false};
+  Metric errors       = {"blocking_errors",                  (double)sensor.getErrorCount(),                            0, 0, false};
+
+  metrics.push_back(transactions);
+  metrics.push_back(blocking);
+  metrics.push_back(busTime);
+  metrics.push_back(errors);
+}
+
+static void measureAsync(std::vector<Metric> &metrics)
+{
+  AHTxxSimDevice device(true);
+  AHTxx          sensor(AHTXX_ADDRESS_X38, AHT2x_SENSOR);
+
+  Wire.detach();
+  Wire.attach(AHTXX_ADDRESS_X38, &device);
+
+  sensor.resetStatistics();
+  Wire.resetStatistics();
+
+  for (uint16_t i = 0; i < BENCHMARK_SAMPLES; i++)
+  {
+    sensor.startMeasurementAsync();
+
+    while (sensor.updateAsync() != AHTXX_ASYNC_READY) delay(1);
+
+    delay(AHTXX_SELF_HEATING_INTERVAL);
+  }
+
+  Metric transactions = {"async_transactions_per_sample",     (double)sensor.getTransactionCount() / BENCHMARK_SAMPLES, BENCHMARK_TOLERANCE, 0, false};
+  Metric blocking     = {"async_blocking_time_us_per_sample", (double)sensor.getBlockingTime()     / BENCHMARK_SAMPLES, 0, 0, false};
+  Metric busTime      = {"async_bus_time_us_per_sample",      (double)Wire.getBusyTime()           / BENCHMARK_SAMPLES, BENCHMARK_TOLERANCE, 0, false};
+  Metric errors       = {"async_errors",                      (double)sensor.getErrorCount(),                            0, 0, false};
+
+  metrics.push_back(transactions);
+  metrics.push_back(blocking);
+  metrics.push_back(busTime);
+  metrics.push_back(errors);
+}
+
+
+/**************************************************************************/
+/*
+    Host CPU time, relative cost only, report-only
+*/
+/**************************************************************************/
+static double frameCheck(AHTXX_I2C_SENSOR sensorType, const uint8_t *frame)
+{
+  FrameTransport transport(frame);
+  AHTxx          sensor(AHTXX_ADDRESS_X38, sensorType);
+
+  sensor.setTransport(&transport);
+
+  std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+  for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+  {
+    sensor.startMeasurementAsync();                            //data arrives in "_rawData[]" instantly
+
+    hostMicros += (uint32_t)AHTXX_MEASUREMENT_DELAY * 1000;    //virtual conversion time
+
+    sensor.updateAsync();                                      //submit read
+    sink += sensor.updateAsync();                              //busy & CRC check
+  }
+
+  double time = nanoseconds(startTime, BENCHMARK_ITERATIONS);
+
+  if (sensor.getErrorCount() != 0) fprintf(stderr, "frame check failed\n");
+
+  return time;
+}
+
+static void measureCpu(std::vector<Metric> &metrics)
+{
+  const uint8_t frame[7] = {0x18, 0x66, 0x66, 0x65, 0xC2, 0x8F, 0x00};            //RH 40%, T 26C
+
+  uint8_t crcFrame[7];
+
+  memcpy(crcFrame, frame, 7);
+
+  uint8_t crc = 0xFF;                                          //same CRC as "AHTxx::_checkCRC8()"
+
+  for (uint8_t i = 0; i < 6; i++)
+  {
+    crc ^= crcFrame[i];
+
+    for (uint8_t bit = 0; bit < 8; bit++) crc = (crc & 0x80) ? ((crc << 1) ^ 0x31) : (crc << 1);
+  }
+
+  crcFrame[6] = crc;
+
+  /* decode */
+  FrameTransport transport(crcFrame);
+  AHTxx          sensor(AHTXX_ADDRESS_X38, AHT2x_SENSOR);
+
+  sensor.setTransport(&transport);
+  sensor.startMeasurementAsync();
+
+  hostMicros += (uint32_t)AHTXX_MEASUREMENT_DELAY * 1000;
+
+  while (sensor.updateAsync() != AHTXX_ASYNC_READY);
+
+  std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+  for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+  {
+    sink += sensor.readRawHumidity(AHTXX_USE_READ_DATA) + sensor.readRawTemperature(AHTXX_USE_READ_DATA);
+  }
+
+  double decode  = nanoseconds(startTime, BENCHMARK_ITERATIONS);
+  double frame1  = frameCheck(AHT1x_SENSOR, frame);
+  double frame2  = frameCheck(AHT2x_SENSOR, crcFrame);
+
+  Metric decodeMetric = {"decode_ns",      decode,          0, 0, true};
+  Metric frame1Metric = {"frame_aht1x_ns", frame1,          0, 0, true};
+  Metric frame2Metric = {"frame_aht2x_ns", frame2,          0, 0, true};
+  Metric crcMetric    = {"crc_ns",         frame2 - frame1, 0, 0, true};
+
+  metrics.push_back(decodeMetric);
+  metrics.push_back(frame1Metric);
+  metrics.push_back(frame2Metric);
+  metrics.push_back(crcMetric);
+}
+
+
+/**************************************************************************/
+/*
+    Baseline
+*/
+/**************************************************************************/
+static bool loadBaseline(const char *path, std::vector<Metric> &baseline)
+{
+  FILE *file = fopen(path, "r");
+
+  if (file == 0) return false;
+
+  char line[128];
+
+  while (fgets(line, sizeof(line), file) != 0)
+  {
+    char   name[64];
+    double value;
+    double tolerance;
+    double floor = 0;
+
+    if (line[0] == '#') continue;
+
+    if (sscanf(line, "%63[^,],%lf,%lf,%lf", name, &value, &tolerance, &floor) < 3) continue;
+
+    Metric metric = {name, value, tolerance, floor, false};
+
+    baseline.push_back(metric);
+  }
+
+  fclose(file);
+
+  return true;
+}
+
+static bool saveBaseline(const char *path, const std::vector<Metric> &metrics)
+{
+  FILE *file = fopen(path, "w");
+
+  if (file == 0) return false;
+
+  fprintf(file, "# metric,value,tolerance%%,floor, generated by AHTxxDriverBenchmark --update\n");
+
+  for (size_t i = 0; i < metrics.size(); i++)
+  {
+    if (metrics[i].report == true) continue;                   //host timing, not gated
+
+    fprintf(file, "%s,%.3f,%.0f,%.0f\n", metrics[i].name.c_str(), metrics[i].value, metrics[i].tolerance, metrics[i].floor);
+  }
+
+  fclose(file);
+
+  return true;
+}
+
+
+int main(int argc, char **argv)
+{
+  std::vector<Metric> metrics;
+  std::vector<Metric> baseline;
+
+  measureBlocking(metrics);
+  measureAsync(metrics);
+  measureCpu(metrics);
+
+  const char *path   = (argc >= 2) ? argv[1] : 0;
+  bool        update = (argc >= 3) && (strcmp(argv[2], "--update") == 0);
+
+  if ((path != 0) && (update == true))
+  {
+    if (saveBaseline(path, metrics) != true)
+    {
+      fprintf(stderr, "can't write %s\n", path);
+
+      return 1;
+    }
+
+    printf("baseline saved to %s\n", path);
+
+    return 0;
+  }
+
+  if ((path != 0) && (loadBaseline(path, baseline) != true))
+  {
+    fprintf(stderr, "can't read %s\n", path);
+
+    return 1;
+  }
+
+  uint8_t regressions = 0;
+
+  printf("metric,value,baseline,limit,result\n");
+
+  for (size_t i = 0; i < metrics.size(); i++)
+  {
+    const Metric *reference = 0;
+
+    for (size_t j = 0; j < baseline.size(); j++)
+    {
+      if (baseline[j].name == metrics[i].name) reference = &baseline[j];
+    }
+
+    if ((path == 0) || (metrics[i].report == true))
+    {
+      printf("%s,%.3f,,,report\n", metrics[i].name.c_str(), metrics[i].value);
+
+      continue;
+    }
+
+    if (reference == 0)
+    {
+      printf("%s,%.3f,,,FAIL\n", metrics[i].name.c_str(), metrics[i].value);    //new metric, run --update
+
+      regressions++;
+
+      continue;
+    }
+
+    double limit = reference->value * (1 + reference->tolerance / 100);
+
+    if (limit < (reference->value + reference->floor)) limit = reference->value + reference->floor;
+
+    bool   pass  = (metrics[i].value <= limit);
+
+    if (pass != true) regressions++;
+
+    printf("%s,%.3f,%.3f,%.3f,%s\n", metrics[i].name.c_str(), metrics[i].value, reference->value, limit, (pass == true) ? "pass" : "FAIL");
+  }
+
+  if (regressions != 0)
+  {
+    fprintf(stderr, "%u metric(s) regressed\n", regressions);
+
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,142 @@
+/***************************************************************************************************/
+/*
+   Host benchmark of AHTxx fixed-point filters vs float filters
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Build & run on a Linux/macOS host:
+   - g++ -O2 -std=c++11 -I../../src AHTxxFiltersBenchmark.cpp ../../src/AHTxxFilters.cpp -o filters_benchmark
+   - ./filters_benchmark [samples]
+
+   NOTE:
+   - 32-bit integers match AVR "long", float matches AVR "double"
+   - max error is distance between fixed-point & float output, in raw units
+   - host timing only shows relative cost, on AVR float is emulated
+     & the gap is much bigger
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#include "AHTxxFilters.h"
+
+
+/* float reference filters */
+struct FloatEma
+{
+  float alpha;
+  float value;
+  bool  empty;
+
+  FloatEma(uint8_t shift) : alpha(1.0f / (1 << shift)), value(0), empty(true) {}
+
+  float update(float x)
+  {
+    if (empty) { value = x; empty = false; }
+    else       { value += (x - value) * alpha; }
+
+    return value;
+  }
+};
+
+struct FloatKalman
+{
+  float q, r, x, p;
+  bool  empty;
+
+  FloatKalman(float processNoise, float measurementNoise) : q(processNoise), r(measurementNoise), x(0), p(0), empty(true) {}
+
+  float update(float z)
+  {
+    if (empty) { x = z; p = r; empty = false; return x; }
+
+    p += q;
+
+    float k = p / (p + r);
+
+    x += k * (z - x);
+    p *= (1 - k);
+
+    return x;
+  }
+};
+
+
+template <typename F>
+static double measure(F function, size_t samples, double &checksum)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  checksum += function();
+
+  std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::nano>(stop - start).count() / samples;
+}
+
+
+int main(int argc, char **argv)
+{
+  size_t samples = (argc > 1) ? strtoul(argv[1], 0, 10) : 1000000;
+
+  /* synthetic RH stream, slow sine + 250 raw noise, 20-bit */
+  std::vector<uint32_t> input(samples);
+
+  srand(1);
+
+  for (size_t i = 0; i < samples; i++)
+  {
+    double value = 524288 + 100000 * sin(i / 5000.0) + ((rand() % 501) - 250);
+
+    input[i] = (uint32_t)value;
+  }
+
+  double checksum = 0;
+
+  /* EMA */
+  AHTxxEmaFilter ema(AHTXX_EMA_FILTER_SHIFT);
+  FloatEma       emaFloat(AHTXX_EMA_FILTER_SHIFT);
+  double         emaError = 0;
+
+  for (size_t i = 0; i < samples; i++)
+  {
+    double error = fabs((double)ema.update(input[i]) - emaFloat.update((float)input[i]));
+
+    if (error > emaError) emaError = error;
+  }
+
+  double emaFixedNs = measure([&]() { AHTxxEmaFilter f; uint64_t s = 0; for (size_t i = 0; i < samples; i++) s += f.update(input[i]); return (double)s; }, samples, checksum);
+  double emaFloatNs = measure([&]() { FloatEma f(AHTXX_EMA_FILTER_SHIFT); double s = 0; for (size_t i = 0; i < samples; i++) s += f.update((float)input[i]); return s; }, samples, checksum);
+
+  /* Kalman */
+  AHTxxKalmanFilter kalman;
+  FloatKalman       kalmanFloat(AHTXX_KALMAN_PROCESS_NOISE, AHTXX_KALMAN_MEASUREMENT_NOISE);
+  double            kalmanError = 0;
+
+  for (size_t i = 0; i < samples; i++)
+  {
+    double error = fabs((double)kalman.update(input[i]) - kalmanFloat.update((float)input[i]));
+
+    if (error > kalmanError) kalmanError = error;
+  }
+
+  double kalmanFixedNs = measure([&]() { AHTxxKalmanFilter f; uint64_t s = 0; for (size_t i = 0; i < samples; i++) s += f.update(input[i]); return (double)s; }, samples, checksum);
+  double kalmanFloatNs = measure([&]() { FloatKalman f(AHTXX_KALMAN_PROCESS_NOISE, AHTXX_KALMAN_MEASUREMENT_NOISE); double s = 0; for (size_t i = 0; i < samples; i++) s += f.update((float)input[i]); return s; }, samples, checksum);
+
+  printf("filter,implementation,ns_per_sample,max_error_raw,state_bytes\n");
+  printf("ema,fixed,%.2f,%.1f,%u\n",    emaFixedNs,    emaError,    (unsigned)sizeof(AHTxxEmaFilter));
+  printf("ema,float,%.2f,0.0,%u\n",     emaFloatNs,                 (unsigned)sizeof(FloatEma));
+  printf("kalman,fixed,%.2f,%.1f,%u\n", kalmanFixedNs, kalmanError, (unsigned)sizeof(AHTxxKalmanFilter));
+  printf("kalman,float,%.2f,0.0,%u\n",  kalmanFloatNs,              (unsigned)sizeof(FloatKalman));
+  fprintf(stderr, "checksum %.0f\n", checksum);
+
+  return 0;
+}
@@ -0,0 +1,192 @@
+/***************************************************************************************************/
+/*
+   Host accuracy & throughput benchmark of AHTxxQuantile sketch
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Build & run on a Linux/macOS host:
+   - g++ -O2 -std=c++11 -I../../src AHTxxQuantileBenchmark.cpp ../../src/AHTxxQuantile.cpp -o quantile_benchmark
+   - add -DAHTXX_QUANTILE_K=64 to this build line for bigger sketch, build-wide flag, see "AHTxxQuantile.h"
+   - ./quantile_benchmark [samples] [nodes]   default 1000000 samples, 1000 nodes
+
+   Scenarios, RH in %:
+   - daily, one node, slow sine + sensor noise
+   - spikes, one node, 40..50% with 2% of samples at 85..95%
+   - fleet, every node has own offset, node sketches are serialized &
+     merged on "gateway" sketch, same as site-wide daily percentiles
+
+   Output:
+   - CSV "scenario,k,samples,bytes,quantile,exact,sketch,error,rank_error",
+     error in %RH, rank error is |true rank of sketch value - quantile|
+   - add, merge & query time on host, relative cost only
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "AHTxxQuantile.h"
+
+
+static const float quantiles[] = {0.5, 0.95, 0.99};
+
+
+static uint32_t seed = 1;
+
+static uint32_t random32()
+{
+  seed ^= seed << 13;                                          //xorshift32
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+
+  return seed;
+}
+
+static uint32_t toRaw(double humidity)
+{
+  if (humidity < 0)   humidity = 0;
+  if (humidity > 100) humidity = 100;
+
+  return (uint32_t)(humidity / 100 * 0xFFFFF);
+}
+
+static double toHumidity(uint32_t raw)
+{
+  return (double)raw / 0x100000 * 100;
+}
+
+static double nanoseconds(std::chrono::steady_clock::time_point startTime)
+{
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+
+/* sketch against exact quantiles of all samples */
+static void report(const char *scenario, const AHTxxQuantile &sketch, std::vector<uint32_t> &samples)
+{
+  uint8_t buffer[AHTXX_QUANTILE_SERIALIZED_SIZE];
+  uint16_t bytes = sketch.serialize(buffer, sizeof(buffer));
+
+  std::sort(samples.begin(), samples.end());
+
+  for (uint8_t i = 0; i < (sizeof(quantiles) / sizeof(quantiles[0])); i++)
+  {
+    size_t   index    = (size_t)ceil(quantiles[i] * samples.size()) - 1;
+    uint32_t exact    = samples[index];
+    uint32_t estimate = sketch.getQuantile(quantiles[i]);
+    double   rank     = (double)(std::upper_bound(samples.begin(), samples.end(), estimate) - samples.begin()) / samples.size();
+
+    printf("%s,%u,%zu,%u,%.2f,%.3f,%.3f,%.3f,%.4f\n", scenario, AHTXX_QUANTILE_K, samples.size(), bytes, quantiles[i],
+           toHumidity(exact), toHumidity(estimate), toHumidity(estimate) - toHumidity(exact), fabs(rank - quantiles[i]));
+  }
+}
+
+
+int main(int argc, char **argv)
+{
+  size_t sampleCount = (argc >= 2) ? atol(argv[1]) : 1000000;
+  size_t nodeCount   = (argc >= 3) ? atol(argv[2]) : 1000;
+
+  printf("scenario,k,samples,bytes,quantile,exact,sketch,error,rank_error\n");
+
+  /* daily */
+  AHTxxQuantile         daily;
+  std::vector<uint32_t> samples;
+
+  std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+  double                                addTime   = 0;
+
+  for (size_t i = 0; i < sampleCount; i++)
+  {
+    uint32_t raw = toRaw(50 + 15 * sin(2 * M_PI * i / 8640) + (double)(random32() % 1000) / 500);
+
+    samples.push_back(raw);
+  }
+
+  startTime = std::chrono::steady_clock::now();
+
+  for (size_t i = 0; i < sampleCount; i++) daily.add(samples[i]);
+
+  addTime = nanoseconds(startTime) / sampleCount;
+
+  report("daily", daily, samples);
+
+  /* spikes */
+  AHTxxQuantile spikes;
+
+  samples.clear();
+
+  for (size_t i = 0; i < sampleCount; i++)
+  {
+    double humidity = ((random32() % 100) < 2) ? (85 + (double)(random32() % 1000) / 100) : (40 + (double)(random32() % 1000) / 100);
+
+    samples.push_back(toRaw(humidity));
+
+    spikes.add(samples.back());
+  }
+
+  report("spikes", spikes, samples);
+
+  /* fleet, serialize on node & merge on gateway */
+  AHTxxQuantile gateway;
+  size_t        perNode   = sampleCount / nodeCount;
+  uint64_t      bytes     = 0;
+  double        mergeTime = 0;
+
+  samples.clear();
+
+  for (size_t node = 0; node < nodeCount; node++)
+  {
+    AHTxxQuantile sketch;
+    double        offset = (double)(random32() % 2000) / 100 - 10;   //+-10% per node
+
+    for (size_t i = 0; i < perNode; i++)
+    {
+      uint32_t raw = toRaw(50 + offset + 15 * sin(2 * M_PI * i / perNode) + (double)(random32() % 1000) / 500);
+
+      samples.push_back(raw);
+
+      sketch.add(raw);
+    }
+
+    uint8_t  buffer[AHTXX_QUANTILE_SERIALIZED_SIZE];
+    uint16_t length = sketch.serialize(buffer, sizeof(buffer));
+
+    bytes += length;
+
+    startTime = std::chrono::steady_clock::now();
+
+    if (gateway.merge(buffer, length) != true) fprintf(stderr, "merge failed\n");
+
+    mergeTime += nanoseconds(startTime);
+  }
+
+  report("fleet", gateway, samples);
+
+  /* query */
+  startTime = std::chrono::steady_clock::now();
+
+  volatile uint32_t sink = 0;
+
+  for (uint16_t i = 0; i < 1000; i++) sink += gateway.getQuantile(0.95);
+
+  double queryTime = nanoseconds(startTime) / 1000;
+
+  printf("\nmetric,value\n");
+  printf("add_ns_per_sample,%.1f\n",        addTime);
+  printf("merge_us_per_sketch,%.2f\n",      mergeTime / nodeCount / 1000);
+  printf("query_us,%.2f\n",                 queryTime / 1000);
+  printf("node_bytes_per_sketch,%.1f\n",    (double)bytes / nodeCount);
+  printf("ram_bytes,%zu\n",                 sizeof(AHTxxQuantile));
+  printf("gateway_count,%u\n",              gateway.getCount());
+
+  return (gateway.getCount() == samples.size()) ? 0 : 1;
+}
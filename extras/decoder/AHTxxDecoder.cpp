@@ -0,0 +1,340 @@
+/***************************************************************************************************/
+/*
+   Host decoder of AHTxx binary packet streams
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Build & run on a Linux/macOS host:
+   - g++ -O2 -std=c++11 -I../../src AHTxxDecoder.cpp ../../src/AHTxxPacket.cpp -o ahtxx_decoder
+   - ./ahtxx_decoder [-b baud] input [input...]   CSV to stdout, gaps & summary to stderr
+
+   Inputs:
+   - serial port, e.g. /dev/ttyUSB0, switched to raw mode at given baud,
+     default 115200
+   - file with captured stream, "-" for stdin
+   - all inputs are read at once, packets of all nodes go to one CSV,
+     every input has own decoder, bytes of two ports are never mixed
+
+   Stream check, per node:
+   - sequence jump forward is gap, lost packets are counted
+   - sequence jump back is duplicate or reordered packet, except 0
+     which is sender restart
+   - CRC/COBS errors are counted per input, decoder resynchronizes on
+     next 0x00 delimiter
+
+   Test over pseudo-terminal without hardware, see "AHTxxStreamGenerator.cpp":
+   - ./ahtxx_generator --pty -n 3 -l 1   prints slave name, e.g. /dev/pts/5
+   - ./ahtxx_decoder /dev/pts/5
+   - or with socat pair:
+     socat -d -d pty,raw,echo=0,link=/tmp/ahtxx_tx pty,raw,echo=0,link=/tmp/ahtxx_rx &
+     ./ahtxx_decoder /tmp/ahtxx_rx & ./ahtxx_generator /tmp/ahtxx_tx
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+#include <chrono>
+#include <map>
+#include <vector>
+
+#include "AHTxxPacket.h"
+
+
+/* one serial port or file */
+struct Input
+{
+  const char        *path;
+  int                fd;
+  AHTxxPacketDecoder decoder;
+  uint32_t           packets;
+  uint32_t           cobsErrors;
+  uint32_t           crcErrors;
+  uint32_t           formatErrors;
+};
+
+/* reassembled stream of one sender */
+struct Node
+{
+  uint16_t sequence;                                           //last sequence number
+  uint32_t packets;
+  uint32_t lost;
+  uint32_t gaps;
+  uint32_t reordered;
+  uint32_t restarts;
+  uint32_t sensorErrors;
+};
+
+
+static volatile sig_atomic_t stopped = 0;
+
+
+static void onSignal(int)
+{
+  stopped = 1;
+}
+
+
+static speed_t baudRate(long baud)
+{
+  switch (baud)
+  {
+    case 9600:    return B9600;
+    case 19200:   return B19200;
+    case 38400:   return B38400;
+    case 57600:   return B57600;
+    case 115200:  return B115200;
+    case 230400:  return B230400;
+    #ifdef B460800
+    case 460800:  return B460800;
+    case 921600:  return B921600;
+    case 1000000: return B1000000;
+    case 2000000: return B2000000;
+    #endif
+    default:      return 0;
+  }
+}
+
+
+/**************************************************************************/
+/*
+    Open file or serial port, port is switched to raw 8N1
+*/
+/**************************************************************************/
+static int openInput(const char *path, speed_t speed)
+{
+  if (strcmp(path, "-") == 0) return STDIN_FILENO;
+
+  int fd = open(path, O_RDONLY | O_NOCTTY);
+
+  if ((fd < 0) || (isatty(fd) == 0)) return fd;             //regular file or error
+
+  struct termios settings;
+
+  if (tcgetattr(fd, &settings) == 0)
+  {
+    cfmakeraw(&settings);                                      //no CR/LF translation, no echo, 0x0D & 0x11 pass through
+    cfsetispeed(&settings, speed);
+    cfsetospeed(&settings, speed);
+
+    settings.c_cflag |= CLOCAL | CREAD;
+    settings.c_cc[VMIN]  = 1;
+    settings.c_cc[VTIME] = 0;
+
+    tcsetattr(fd, TCSANOW, &settings);
+  }
+
+  return fd;
+}
+
+
+/**************************************************************************/
+/*
+    Check sequence of node & print packet as CSV
+*/
+/**************************************************************************/
+static void onPacket(std::map<uint8_t, Node> &nodes, const AHTxxPacket *packet)
+{
+  std::map<uint8_t, Node>::iterator found = nodes.find(packet->node);
+
+  if (found == nodes.end())
+  {
+    Node node = {packet->sequence, 1, 0, 0, 0, 0, 0};
+
+    found = nodes.insert(std::make_pair(packet->node, node)).first;
+  }
+  else
+  {
+    Node    &node = found->second;
+    int16_t  step = (int16_t)(packet->sequence - node.sequence);    //wrap-safe
+
+    node.packets++;
+
+    if (step > 1)
+    {
+      node.lost += step - 1;
+      node.gaps++;
+
+      fprintf(stderr, "gap: node %u, sequence %u..%u, %d lost\n", packet->node, (uint16_t)(node.sequence + 1), (uint16_t)(packet->sequence - 1), step - 1);
+    }
+    else if ((step <= 0) && (packet->sequence == 0))
+    {
+      node.restarts++;
+
+      fprintf(stderr, "restart: node %u\n", packet->node);
+    }
+    else if (step <= 0)
+    {
+      node.reordered++;
+
+      fprintf(stderr, "reordered: node %u, sequence %u after %u\n", packet->node, packet->sequence, node.sequence);
+
+      return;                                                  //keep newest sequence as reference
+    }
+
+    node.sequence = packet->sequence;
+  }
+
+  uint32_t humidity    = ahtxxPacketRawHumidity(packet);
+  uint32_t temperature = ahtxxPacketRawTemperature(packet);
+
+  if (humidity == 0xFFFFFFFF)
+  {
+    found->second.sensorErrors++;
+
+    printf("%u,%u,%u,%lu,%u,,\n", packet->node, packet->sensor, packet->sequence, (unsigned long)packet->time, packet->status);
+
+    return;
+  }
+
+  printf("%u,%u,%u,%lu,%u,%.2f,%.2f\n", packet->node, packet->sensor, packet->sequence, (unsigned long)packet->time, packet->status,
+         (float)humidity / 0x100000 * 100, (float)temperature / 0x100000 * 200 - 50);
+}
+
+
+int main(int argc, char **argv)
+{
+  long                baud = 115200;
+  std::vector<Input>  inputs;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if ((strcmp(argv[i], "-b") == 0) && ((i + 1) < argc))
+    {
+      baud = atol(argv[++i]);
+
+      continue;
+    }
+
+    Input input = {argv[i], -1, AHTxxPacketDecoder(), 0, 0, 0, 0};
+
+    inputs.push_back(input);
+  }
+
+  if ((inputs.size() == 0) || (baudRate(baud) == 0))
+  {
+    fprintf(stderr, "usage: %s [-b baud] input [input...]\n", argv[0]);
+
+    return 2;
+  }
+
+  std::vector<struct pollfd> fds;
+
+  for (size_t i = 0; i < inputs.size(); i++)
+  {
+    inputs[i].fd = openInput(inputs[i].path, baudRate(baud));
+
+    if (inputs[i].fd < 0)
+    {
+      fprintf(stderr, "can't open %s: %s\n", inputs[i].path, strerror(errno));
+
+      return 1;
+    }
+
+    struct pollfd entry = {inputs[i].fd, POLLIN, 0};
+
+    fds.push_back(entry);
+  }
+
+  signal(SIGINT,  onSignal);
+  signal(SIGTERM, onSignal);
+
+  std::map<uint8_t, Node> nodes;
+  size_t                  active    = inputs.size();
+  uint64_t                bytes     = 0;
+  uint8_t                 buffer[4096];
+
+  std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+  printf("node,sensor,sequence,time_ms,status,humidity,temperature\n");
+
+  while ((active > 0) && (stopped == 0))
+  {
+    if (poll(&fds[0], fds.size(), 1000) < 0)
+    {
+      if (errno == EINTR) continue;
+
+      break;
+    }
+
+    for (size_t i = 0; i < fds.size(); i++)
+    {
+      if ((fds[i].fd < 0) || (fds[i].revents == 0)) continue;
+
+      ssize_t length = read(fds[i].fd, buffer, sizeof(buffer));
+
+      if (length <= 0)                                         //EOF or pty closed by writer
+      {
+        if ((length < 0) && ((errno == EINTR) || (errno == EAGAIN))) continue;
+
+        if (fds[i].fd != STDIN_FILENO) close(fds[i].fd);
+
+        fds[i].fd = -1;
+        active--;
+
+        continue;
+      }
+
+      bytes += length;
+
+      Input &input = inputs[i];
+
+      for (ssize_t j = 0; j < length; j++)
+      {
+        switch (input.decoder.feed(buffer[j]))
+        {
+          case AHTXX_PACKET_OK:
+            input.packets++;
+            onPacket(nodes, input.decoder.getPacket());
+            break;
+
+          case AHTXX_PACKET_COBS_ERROR:
+            input.cobsErrors++;
+            break;
+
+          case AHTXX_PACKET_CRC_ERROR:
+            input.crcErrors++;
+            break;
+
+          case AHTXX_PACKET_FORMAT_ERROR:
+            input.formatErrors++;
+            break;
+        }
+      }
+    }
+  }
+
+  fflush(stdout);
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+  fprintf(stderr, "\ninput,packets,cobs_errors,crc_errors,format_errors\n");
+
+  for (size_t i = 0; i < inputs.size(); i++)
+  {
+    fprintf(stderr, "%s,%u,%u,%u,%u\n", inputs[i].path, inputs[i].packets, inputs[i].cobsErrors, inputs[i].crcErrors, inputs[i].formatErrors);
+  }
+
+  fprintf(stderr, "\nnode,packets,lost,gaps,reordered,restarts,sensor_errors\n");
+
+  for (std::map<uint8_t, Node>::iterator i = nodes.begin(); i != nodes.end(); ++i)
+  {
+    const Node &node = i->second;
+
+    fprintf(stderr, "%u,%u,%u,%u,%u,%u,%u\n", i->first, node.packets, node.lost, node.gaps, node.reordered, node.restarts, node.sensorErrors);
+  }
+
+  fprintf(stderr, "\n%llu bytes in %.3f sec\n", (unsigned long long)bytes, seconds);
+
+  return 0;
+}
@@ -0,0 +1,249 @@
+/***************************************************************************************************/
+/*
+   Host generator of AHTxx binary packet streams
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Build & run on a Linux/macOS host:
+   - g++ -O2 -std=c++11 -I../host -I../../src AHTxxStreamGenerator.cpp ../host/HostArduino.cpp ../host/AHTxxSimDevice.cpp
+       ../../src/AHTxx.cpp ../../src/AHTxxTransport.cpp ../../src/AHTxxTWI.cpp ../../src/AHTxxUncertainty.cpp
+       ../../src/AHTxxPacket.cpp ../../src/AHTxxStream.cpp -o ahtxx_generator
+   - ./ahtxx_generator [options] --pty    new pseudo-terminal, slave name to stdout
+   - ./ahtxx_generator [options] output   file, serial port or socat pty link
+
+   Options:
+   - -n nodes, simulated senders on one stream, default 1
+   - -c count, packets per node, default 1000
+   - -l loss, % of packets dropped before output, shows up as gaps
+   - -e error, % of packets with one flipped byte, shows up as CRC errors
+   - -r rate, packets/sec of all nodes, default 0 = as fast as possible
+
+   NOTE:
+   - real "AHTxxStreamWriter" & "AHTxx" code, sensors are simulated, see
+     "../host", measurement time is virtual, only output is real-time
+   - dropped & corrupted packets are reported to stderr, compare with
+     "ahtxx_decoder" summary
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <vector>
+
+#include "AHTxx.h"
+#include "AHTxxStream.h"
+#include "AHTxxSimDevice.h"
+
+
+#define GENERATOR_DRAIN_TIMEOUT  5000   //wait for reader before pty is closed, in milliseconds
+
+
+/* file descriptor output with packet loss & corruption */
+class LossyOutput : public Print
+{
+  public:
+
+   LossyOutput(int fd, int loss, int error) : _fd(fd), _loss(loss), _error(error), _dropped(0), _corrupted(0) {}
+
+   size_t write(uint8_t value)
+   {
+     return write(&value, 1);
+   }
+
+   size_t write(const uint8_t *data, size_t length)
+   {
+     if ((rand() % 100) < _loss)
+     {
+       _dropped++;
+
+       return 0;                                               //whole packet lost
+     }
+
+     uint8_t buffer[AHTXX_PACKET_MAX_SIZE];
+
+     if (length > sizeof(buffer)) length = sizeof(buffer);
+
+     memcpy(buffer, data, length);
+
+     if ((rand() % 100) < _error)
+     {
+       buffer[rand() % (length - 1)] ^= 1 << (rand() % 8);    //delimiter stays
+
+       _corrupted++;
+     }
+
+     size_t written = 0;
+
+     while (written < length)
+     {
+       ssize_t result = ::write(_fd, buffer + written, length - written);
+
+       if ((result < 0) && (errno == EINTR)) continue;
+       if (result <= 0) break;
+
+       written += result;
+     }
+
+     return written;
+   }
+
+   uint32_t getDropped()   {return _dropped;}
+   uint32_t getCorrupted() {return _corrupted;}
+
+
+  private:
+   int      _fd;
+   int      _loss;
+   int      _error;
+   uint32_t _dropped;
+   uint32_t _corrupted;
+};
+
+
+/* one sender with own bus & sensor */
+struct Node
+{
+  TwoWire           *wire;
+  AHTxxSimDevice    *device;
+  AHTxx             *sensor;
+  AHTxxStreamWriter *writer;
+};
+
+
+static void makeRaw(int fd)
+{
+  struct termios settings;
+
+  if (tcgetattr(fd, &settings) != 0) return;
+
+  cfmakeraw(&settings);
+
+  tcsetattr(fd, TCSANOW, &settings);
+}
+
+
+int main(int argc, char **argv)
+{
+  int         nodeCount = 1;
+  long        count     = 1000;
+  int         loss      = 0;
+  int         error     = 0;
+  long        rate      = 0;
+  bool        pty       = false;
+  const char *path      = 0;
+
+  for (int i = 1; i < argc; i++)
+  {
+    bool value = (i + 1) < argc;
+
+    if      ((strcmp(argv[i], "-n") == 0) && (value == true)) nodeCount = atoi(argv[++i]);
+    else if ((strcmp(argv[i], "-c") == 0) && (value == true)) count     = atol(argv[++i]);
+    else if ((strcmp(argv[i], "-l") == 0) && (value == true)) loss      = atoi(argv[++i]);
+    else if ((strcmp(argv[i], "-e") == 0) && (value == true)) error     = atoi(argv[++i]);
+    else if ((strcmp(argv[i], "-r") == 0) && (value == true)) rate      = atol(argv[++i]);
+    else if  (strcmp(argv[i], "--pty") == 0)                  pty       = true;
+    else                                                      path      = argv[i];
+  }
+
+  if (((pty != true) && (path == 0)) || (nodeCount < 1) || (nodeCount > 255))
+  {
+    fprintf(stderr, "usage: %s [-n nodes] [-c count] [-l loss%%] [-e error%%] [-r rate] --pty|output\n", argv[0]);
+
+    return 2;
+  }
+
+  int fd    = -1;
+  int slave = -1;
+
+  if (pty == true)
+  {
+    fd = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if ((fd < 0) || (grantpt(fd) != 0) || (unlockpt(fd) != 0))
+    {
+      fprintf(stderr, "can't create pty: %s\n", strerror(errno));
+
+      return 1;
+    }
+
+    slave = open(ptsname(fd), O_RDWR | O_NOCTTY);          //raw before reader opens it, kept open so early writes are buffered
+
+    makeRaw(slave);
+
+    printf("%s\n", ptsname(fd));
+    fflush(stdout);
+  }
+  else
+  {
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_NOCTTY, 0644);
+
+    if (fd < 0)
+    {
+      fprintf(stderr, "can't open %s: %s\n", path, strerror(errno));
+
+      return 1;
+    }
+
+    if (isatty(fd) != 0) makeRaw(fd);
+  }
+
+  LossyOutput       output(fd, loss, error);
+  std::vector<Node> nodes;
+
+  for (int i = 0; i < nodeCount; i++)
+  {
+    Node node;
+
+    node.wire   = new TwoWire();
+    node.device = new AHTxxSimDevice(true, i + 1);
+    node.sensor = new AHTxx(AHTXX_ADDRESS_X38, AHT2x_SENSOR, *node.wire);
+    node.writer = new AHTxxStreamWriter(output, i);
+
+    node.wire->attach(AHTXX_ADDRESS_X38, node.device);
+    node.sensor->begin();
+
+    nodes.push_back(node);
+  }
+
+  for (long i = 0; i < count; i++)
+  {
+    for (size_t j = 0; j < nodes.size(); j++)
+    {
+      nodes[j].sensor->readTemperature();                      //virtual time, ~80msec per sample
+
+      nodes[j].writer->write(0, *nodes[j].sensor);
+
+      if (rate > 0) usleep(1000000 / rate);
+    }
+  }
+
+  if (slave >= 0)                                              //closing master drops unread data, wait for reader
+  {
+    int pending = 0;
+
+    for (uint16_t i = 0; i < GENERATOR_DRAIN_TIMEOUT; i++)
+    {
+      if ((ioctl(slave, FIONREAD, &pending) != 0) || (pending == 0)) break;
+
+      usleep(1000);
+    }
+
+    close(slave);
+  }
+
+  close(fd);
+
+  fprintf(stderr, "nodes %d, packets %ld, dropped %u, corrupted %u\n", nodeCount, count * nodeCount, output.getDropped(), output.getCorrupted());
+
+  return 0;
+}
@@ -0,0 +1,987 @@
+/***************************************************************************************************/
+/*
+   Host gateway daemon, ingest of AHTxx binary packet streams from many nodes
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Build & run on a Linux host:
+   - g++ -O2 -std=c++11 -pthread -I../../src AHTxxGateway.cpp AHTxxStateTable.cpp ../../src/AHTxxPacket.cpp -o ahtxx_gateway
+   - ./ahtxx_gateway [-w workers] [-i interval] [-b baud] input [input...]
+   - ./ahtxx_gateway --bench [-w workers] [--pty n] [--udp n] [-c count] [-s ns]
+
+   Inputs:
+   - serial port or pty, switched to raw mode, e.g. /dev/ttyUSB0
+   - "udp:port", datagrams with one or more packets, e.g. udp:5000
+   - file with captured stream, read once
+
+   Pipeline:
+   - one reader thread per input only splits bytes on 0x00 delimiter &
+     pushes raw COBS frames, no decoding, kernel buffers are drained
+     as fast as possible
+   - one lock-free MPSC queue per worker, see "AHTxxMpscQueue.h", frame
+     goes to worker "node % workers", node id is read from COBS frame
+     without decoding, so every node is always handled by same worker
+     & its state needs no locks
+   - worker thread decodes with "AHTxxPacket.h" functions, checks
+     sequence per node, keeps per-sensor state in flat table, see
+     "AHTxxStateTable.h", prints sensor table every interval
+   - -w 0 decodes & aggregates on reader threads under one mutex, old
+     single-stage design, for comparison, table is printed by timer
+     thread
+
+   Bench:
+   - local pseudo-terminals & loopback UDP sockets are fed by writer
+     threads with pre-encoded packets as fast as possible
+   - prints CSV "inputs,pty,udp,workers,packets,decoded,lost,errors,
+     stalls,seconds,frames_per_sec", without -w runs 0, 1, 2 & 4 workers
+   - UDP packets lost in kernel are counted as lost, pty never drops
+   - -s adds busy-wait per decoded frame, stand-in for storage cost,
+     shows how single-stage design stalls readers on multi-core host
+
+   NOTE:
+   - full queue is not dropped, reader retries & counts a stall, kernel
+     buffer holds data meanwhile
+   - SIGINT/SIGTERM stop readers, queued frames are still decoded
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AHTxxPacket.h"
+#include "AHTxxMpscQueue.h"
+#include "AHTxxStateTable.h"
+
+
+#define GATEWAY_QUEUE_SIZE       16384  //frames per worker queue, power of 2
+#define GATEWAY_MAX_WORKERS      16
+#define GATEWAY_SENSORS          1024   //state table reserve per worker, grows on demand
+#define GATEWAY_READ_SIZE        65536  //bytes per "read()"
+#define GATEWAY_POLL_TIMEOUT     100    //stop flag check, in milliseconds
+#define GATEWAY_UDP_BUFFER       (4 * 1024 * 1024)
+#define GATEWAY_BENCH_COUNT      200000 //packets per bench input
+#define GATEWAY_BENCH_NODES      4      //nodes per bench input
+#define GATEWAY_BENCH_DATAGRAM   32     //packets per bench UDP datagram
+#define GATEWAY_BENCH_IDLE       2000   //bench ends after no progress, in milliseconds
+
+
+/* one COBS frame without delimiter, as received */
+struct Frame
+{
+  uint8_t length;
+  uint8_t data[AHTXX_PACKET_MAX_SIZE];
+};
+
+/* sequence check of one sender, sequence number is per node, not per sensor */
+struct NodeLink
+{
+  bool     seen;
+  uint16_t sequence;
+  uint32_t lost;
+  uint32_t reordered;
+};
+
+
+static std::atomic<bool> stopped(false);
+static std::mutex        printMutex;
+static uint32_t          storageCost = 0;                      //bench only, in nanoseconds
+
+
+static void onSignal(int)
+{
+  stopped.store(true);
+}
+
+
+/**************************************************************************/
+/*
+    Aggregator, decoded packets of some nodes
+
+    NOTE:
+    - one per worker, owner thread only, no locks
+    - flat node array for sequence check, per-sensor last sample,
+      health & statistics in "AHTxxStateTable.h"
+*/
+/**************************************************************************/
+class Aggregator
+{
+  public:
+
+   Aggregator() : sensors(GATEWAY_SENSORS), decoded(0), cobsErrors(0), crcErrors(0), formatErrors(0)
+   {
+     memset(nodes, 0, sizeof(nodes));
+   }
+
+   void add(const uint8_t *frame, uint8_t length)
+   {
+     uint8_t     data[AHTXX_PACKET_MAX_SIZE];
+     AHTxxPacket packet;
+
+     uint8_t size = ahtxxCobsDecode(frame, length, data);
+
+     if (size == 0)
+     {
+       cobsErrors++;
+
+       return;
+     }
+
+     switch (ahtxxPacketParse(data, size, &packet))
+     {
+       case AHTXX_PACKET_OK:
+         break;
+
+       case AHTXX_PACKET_CRC_ERROR:
+         crcErrors++;
+         return;
+
+       default:
+         formatErrors++;
+         return;
+     }
+
+     decoded++;
+
+     NodeLink &link = nodes[packet.node];
+
+     if (link.seen == true)
+     {
+       int16_t step = (int16_t)(packet.sequence - link.sequence);   //wrap-safe
+
+       if ((step <= 0) && (packet.sequence != 0))             //0 is sender restart
+       {
+         link.reordered++;
+
+         return;
+       }
+
+       if (step > 1) link.lost += step - 1;
+     }
+
+     link.seen     = true;
+     link.sequence = packet.sequence;
+
+     sensors.update(((uint32_t)packet.node << 8) | packet.sensor, &packet);
+
+     if (storageCost != 0)
+     {
+       std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now() + std::chrono::nanoseconds(storageCost);
+
+       while (std::chrono::steady_clock::now() < endTime);
+     }
+   }
+
+   /* nodes of other worker, node ids of workers never overlap */
+   void merge(const Aggregator &other)
+   {
+     for (uint16_t i = 0; i < 256; i++)
+     {
+       if (other.nodes[i].seen == true) nodes[i] = other.nodes[i];
+     }
+
+     for (size_t i = 0; i < other.sensors.getCapacity(); i++)
+     {
+       const AHTxxStateEntry *entry = other.sensors.getEntry(i);
+
+       if (entry != 0) *sensors.insert(entry->key) = *entry;
+     }
+
+     decoded      += other.decoded;
+     cobsErrors   += other.cobsErrors;
+     crcErrors    += other.crcErrors;
+     formatErrors += other.formatErrors;
+   }
+
+   void print(FILE *file)
+   {
+     std::vector<uint32_t> keys;
+
+     for (size_t i = 0; i < sensors.getCapacity(); i++)
+     {
+       if (sensors.getEntry(i) != 0) keys.push_back(sensors.getEntry(i)->key);
+     }
+
+     std::sort(keys.begin(), keys.end());                      //table order is random
+
+     for (size_t i = 0; i < keys.size(); i++)
+     {
+       const AHTxxStateEntry *entry = sensors.find(keys[i]);
+       const NodeLink        &link  = nodes[keys[i] >> 8];
+
+       fprintf(file, "%u,%u,%u,%u,%u,%u,%lu", keys[i] >> 8, keys[i] & 0xFF, entry->health.packets, link.lost, link.reordered,
+               entry->health.errors, (unsigned long)entry->sample.time);
+
+       if (entry->sample.rawHumidity == AHTXX_RAW_ERROR)
+       {
+         fprintf(file, ",,,,\n");
+
+         continue;
+       }
+
+       fprintf(file, ",%.2f,%.2f,%.2f,%.2f\n", (float)entry->sample.rawHumidity / 0x100000 * 100, (float)entry->sample.rawTemperature / 0x100000 * 200 - 50,
+               (float)entry->stats.meanHumidity / 256 / 0x100000 * 100, (float)entry->stats.meanTemperature / 256 / 0x100000 * 200 - 50);
+     }
+   }
+
+   uint64_t lost()
+   {
+     uint64_t total = 0;
+
+     for (uint16_t i = 0; i < 256; i++) total += nodes[i].lost;
+
+     return total;
+   }
+
+   NodeLink        nodes[256];                                 //flat, node id is 8-bit
+   AHTxxStateTable sensors;
+   uint64_t        decoded;
+   uint64_t        cobsErrors;
+   uint64_t        crcErrors;
+   uint64_t        formatErrors;
+};
+
+
+typedef AHTxxMpscQueue<Frame, GATEWAY_QUEUE_SIZE> FrameQueue;
+
+
+/* worker queue, aggregator & progress visible to other threads */
+struct Worker
+{
+  FrameQueue            queue;
+  Aggregator            aggregator;
+  std::atomic<uint64_t> processed;                             //frames taken from queue
+  std::thread           thread;
+};
+
+
+struct Gateway
+{
+  std::vector<Worker *> workers;
+  Aggregator            shared;                                //-w 0 only
+  std::mutex            sharedMutex;
+  std::atomic<uint64_t> frames;                                //frames pushed or decoded inline
+  std::atomic<uint64_t> stalls;                                //push retries on full queue
+  std::atomic<bool>     readersDone;
+  uint32_t              interval;                              //node table period, in seconds, 0=only at exit
+};
+
+
+/**************************************************************************/
+/*
+    Node id straight from COBS frame
+
+    NOTE:
+    - first code byte > 2 means version & node bytes are copied as is,
+      code 2 means node byte was 0x00
+    - broken frame goes to any worker & fails there
+*/
+/**************************************************************************/
+static uint8_t frameNode(const Frame &frame)
+{
+  if ((frame.length >= 3) && (frame.data[0] > 2)) return frame.data[2];
+
+  return 0;
+}
+
+
+static void dispatch(Gateway &gateway, const Frame &frame)
+{
+  gateway.frames.fetch_add(1, std::memory_order_relaxed);
+
+  if (gateway.workers.size() == 0)                             //single-stage design
+  {
+    std::lock_guard<std::mutex> lock(gateway.sharedMutex);
+
+    gateway.shared.add(frame.data, frame.length);
+
+    return;
+  }
+
+  Worker *worker = gateway.workers[frameNode(frame) % gateway.workers.size()];
+
+  while (worker->queue.push(frame) != true)
+  {
+    gateway.stalls.fetch_add(1, std::memory_order_relaxed);
+
+    std::this_thread::yield();
+  }
+}
+
+
+/**************************************************************************/
+/*
+    Reader thread, stream input
+*/
+/**************************************************************************/
+static void readStream(Gateway &gateway, int fd)
+{
+  std::vector<uint8_t> buffer(GATEWAY_READ_SIZE);
+  Frame                frame;
+  bool                 overflow = false;
+
+  frame.length = 0;
+
+  struct pollfd entry = {fd, POLLIN, 0};
+
+  while (stopped.load() != true)
+  {
+    int ready = poll(&entry, 1, GATEWAY_POLL_TIMEOUT);
+
+    if ((ready < 0) && (errno != EINTR)) break;
+    if (ready <= 0) continue;
+
+    ssize_t length = read(fd, &buffer[0], buffer.size());
+
+    if (length < 0)
+    {
+      if ((errno == EINTR) || (errno == EAGAIN)) continue;
+
+      break;                                                   //EIO, pty closed by writer
+    }
+
+    if (length == 0) break;                                    //EOF
+
+    for (ssize_t i = 0; i < length; i++)
+    {
+      uint8_t value = buffer[i];
+
+      if (value != 0x00)
+      {
+        if (frame.length < AHTXX_PACKET_MAX_SIZE) {frame.data[frame.length++] = value;}
+        else                                      {overflow = true;}
+
+        continue;
+      }
+
+      if ((frame.length != 0) && (overflow != true)) dispatch(gateway, frame);
+
+      frame.length = 0;
+      overflow     = false;
+    }
+  }
+
+  close(fd);
+}
+
+
+/**************************************************************************/
+/*
+    Reader thread, UDP input, every datagram ends with complete packet
+*/
+/**************************************************************************/
+static void readDatagrams(Gateway &gateway, int fd)
+{
+  std::vector<uint8_t> buffer(GATEWAY_READ_SIZE);
+
+  struct pollfd entry = {fd, POLLIN, 0};
+
+  while (stopped.load() != true)
+  {
+    int ready = poll(&entry, 1, GATEWAY_POLL_TIMEOUT);
+
+    if ((ready < 0) && (errno != EINTR)) break;
+    if (ready <= 0) continue;
+
+    ssize_t length = recv(fd, &buffer[0], buffer.size(), 0);
+
+    if (length <= 0) continue;
+
+    Frame frame;
+
+    frame.length = 0;
+
+    for (ssize_t i = 0; i < length; i++)
+    {
+      if (buffer[i] != 0x00)
+      {
+        if (frame.length < AHTXX_PACKET_MAX_SIZE) frame.data[frame.length] = buffer[i];
+
+        if (frame.length < 255) frame.length++;                //too long stays too long
+
+        continue;
+      }
+
+      if ((frame.length != 0) && (frame.length <= AHTXX_PACKET_MAX_SIZE)) dispatch(gateway, frame);
+
+      frame.length = 0;
+    }
+  }
+
+  close(fd);
+}
+
+
+/**************************************************************************/
+/*
+    Node table print timer
+
+    NOTE:
+    - checked on every loop iteration, busy queue doesn't delay print
+*/
+/**************************************************************************/
+static bool printDue(const Gateway &gateway, std::chrono::steady_clock::time_point &printTime)
+{
+  if (gateway.interval == 0) return false;                     //no reason to continue, print only at exit
+
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+  if ((now - printTime) < std::chrono::seconds(gateway.interval)) return false;
+
+  printTime = now;
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    Worker thread
+*/
+/**************************************************************************/
+static void work(Gateway &gateway, Worker &worker)
+{
+  Frame    frame;
+  uint32_t idle = 0;
+
+  std::chrono::steady_clock::time_point printTime = std::chrono::steady_clock::now();
+
+  for (;;)
+  {
+    if (printDue(gateway, printTime) == true)
+    {
+      std::lock_guard<std::mutex> lock(printMutex);
+
+      worker.aggregator.print(stdout);
+
+      fflush(stdout);
+    }
+
+    if (worker.queue.pop(frame) == true)
+    {
+      worker.aggregator.add(frame.data, frame.length);
+
+      worker.processed.fetch_add(1, std::memory_order_release);
+
+      idle = 0;
+
+      continue;
+    }
+
+    if (gateway.readersDone.load(std::memory_order_acquire) == true)
+    {
+      if (worker.queue.pop(frame) == true)                     //last frames pushed before flag
+      {
+        worker.aggregator.add(frame.data, frame.length);
+
+        worker.processed.fetch_add(1, std::memory_order_release);
+
+        continue;
+      }
+
+      break;
+    }
+
+    if (++idle < 64) {std::this_thread::yield();}
+    else             {std::this_thread::sleep_for(std::chrono::microseconds(100));}   //backoff, queue is empty for a while
+  }
+}
+
+
+/**************************************************************************/
+/*
+    Print thread of -w 0, readers aggregate inline & have no timer
+*/
+/**************************************************************************/
+static void printShared(Gateway &gateway)
+{
+  std::chrono::steady_clock::time_point printTime = std::chrono::steady_clock::now();
+
+  while (gateway.readersDone.load(std::memory_order_acquire) != true)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(GATEWAY_POLL_TIMEOUT));
+
+    if (printDue(gateway, printTime) != true) continue;
+
+    std::lock_guard<std::mutex> sharedLock(gateway.sharedMutex);
+    std::lock_guard<std::mutex> printLock(printMutex);
+
+    gateway.shared.print(stdout);
+
+    fflush(stdout);
+  }
+}
+
+
+/**************************************************************************/
+/*
+    Inputs
+*/
+/**************************************************************************/
+static speed_t baudRate(long baud)
+{
+  switch (baud)
+  {
+    case 9600:    return B9600;
+    case 19200:   return B19200;
+    case 38400:   return B38400;
+    case 57600:   return B57600;
+    case 115200:  return B115200;
+    case 230400:  return B230400;
+    #ifdef B460800
+    case 460800:  return B460800;
+    case 921600:  return B921600;
+    case 1000000: return B1000000;
+    case 2000000: return B2000000;
+    #endif
+    default:      return 0;
+  }
+}
+
+static void makeRaw(int fd, speed_t speed)
+{
+  struct termios settings;
+
+  if (tcgetattr(fd, &settings) != 0) return;
+
+  cfmakeraw(&settings);                                        //no CR/LF translation, no echo, 0x0D & 0x11 pass through
+
+  if (speed != 0)
+  {
+    cfsetispeed(&settings, speed);
+    cfsetospeed(&settings, speed);
+  }
+
+  settings.c_cflag |= CLOCAL | CREAD;
+
+  tcsetattr(fd, TCSANOW, &settings);
+}
+
+static int openUdp(uint16_t port)
+{
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+  if (fd < 0) return -1;
+
+  int size = GATEWAY_UDP_BUFFER;
+
+  setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));  //burst absorber
+
+  struct sockaddr_in address;
+
+  memset(&address, 0, sizeof(address));
+
+  address.sin_family      = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port        = htons(port);
+
+  if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0)
+  {
+    close(fd);
+
+    return -1;
+  }
+
+  return fd;
+}
+
+static std::thread openInput(Gateway &gateway, const char *path, speed_t speed, bool &success)
+{
+  success = false;
+
+  if (strncmp(path, "udp:", 4) == 0)
+  {
+    int fd = openUdp(atoi(path + 4));
+
+    if (fd < 0) return std::thread();
+
+    success = true;
+
+    return std::thread(readDatagrams, std::ref(gateway), fd);
+  }
+
+  int fd = open(path, O_RDONLY | O_NOCTTY);
+
+  if (fd < 0) return std::thread();
+
+  if (isatty(fd) != 0) makeRaw(fd, speed);
+
+  success = true;
+
+  return std::thread(readStream, std::ref(gateway), fd);
+}
+
+
+static void startWorkers(Gateway &gateway, int workerCount)
+{
+  gateway.frames.store(0);
+  gateway.stalls.store(0);
+  gateway.readersDone.store(false);
+
+  for (int i = 0; i < workerCount; i++)
+  {
+    Worker *worker = new Worker();
+
+    worker->processed.store(0);
+
+    gateway.workers.push_back(worker);
+  }
+
+  for (size_t i = 0; i < gateway.workers.size(); i++)          //all queues exist before first "work()"
+  {
+    gateway.workers[i]->thread = std::thread(work, std::ref(gateway), std::ref(*gateway.workers[i]));
+  }
+}
+
+/* join workers after readers & merge totals into shared aggregator */
+static void stopWorkers(Gateway &gateway)
+{
+  gateway.readersDone.store(true, std::memory_order_release);
+
+  for (size_t i = 0; i < gateway.workers.size(); i++)
+  {
+    Worker *worker = gateway.workers[i];
+
+    worker->thread.join();
+
+    gateway.shared.merge(worker->aggregator);
+
+    delete worker;
+  }
+
+  gateway.workers.clear();
+}
+
+
+/**************************************************************************/
+/*
+    Bench, writer threads feed local pty & loopback UDP inputs
+*/
+/**************************************************************************/
+static std::vector<uint8_t> benchStream(uint8_t firstNode, uint32_t count, std::vector<uint32_t> &ends)
+{
+  std::vector<uint8_t> stream;
+  AHTxxPacket          packet;
+
+  const uint8_t frame[7] = {0x18, 0x66, 0x66, 0x65, 0xC2, 0x8F, 0x6E};   //RH 40%, T 26C
+
+  memset(&packet, 0, sizeof(packet));
+  memcpy(packet.frame, frame, sizeof(frame));
+
+  packet.length = sizeof(frame);
+
+  for (uint32_t i = 0; i < count; i++)
+  {
+    uint8_t buffer[AHTXX_PACKET_MAX_SIZE];
+
+    packet.node     = firstNode + (i % GATEWAY_BENCH_NODES);
+    packet.sequence = i / GATEWAY_BENCH_NODES;
+    packet.time     = i;
+
+    uint8_t size = ahtxxPacketEncode(&packet, buffer);
+
+    stream.insert(stream.end(), buffer, buffer + size);
+
+    ends.push_back(stream.size());                             //packet boundary for datagrams
+  }
+
+  return stream;
+}
+
+static void writePty(int fd, const std::vector<uint8_t> *stream)
+{
+  size_t written = 0;
+
+  while (written < stream->size())
+  {
+    ssize_t result = write(fd, &(*stream)[written], stream->size() - written);
+
+    if ((result < 0) && (errno == EINTR)) continue;
+    if (result <= 0) break;
+
+    written += result;
+  }
+}
+
+static void writeUdp(int fd, uint16_t port, const std::vector<uint8_t> *stream, const std::vector<uint32_t> *ends)
+{
+  struct sockaddr_in address;
+
+  memset(&address, 0, sizeof(address));
+
+  address.sin_family      = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port        = htons(port);
+
+  size_t start = 0;
+
+  for (size_t i = GATEWAY_BENCH_DATAGRAM - 1; start < stream->size(); i += GATEWAY_BENCH_DATAGRAM)
+  {
+    size_t end = (i < ends->size()) ? (*ends)[i] : stream->size();
+
+    while (sendto(fd, &(*stream)[start], end - start, 0, (struct sockaddr *)&address, sizeof(address)) < 0)
+    {
+      if ((errno != ENOBUFS) && (errno != EAGAIN) && (errno != EINTR)) return;
+
+      std::this_thread::yield();
+    }
+
+    start = end;
+  }
+}
+
+static uint16_t boundPort(int fd)
+{
+  struct sockaddr_in address;
+  socklen_t          size = sizeof(address);
+
+  getsockname(fd, (struct sockaddr *)&address, &size);
+
+  return ntohs(address.sin_port);
+}
+
+static bool bench(int workerCount, int ptyCount, int udpCount, uint32_t count)
+{
+  Gateway                          gateway;
+  std::vector<std::thread>         readers;
+  std::vector<std::thread>         writers;
+  std::vector<int>                 fds;
+  std::vector<std::vector<uint8_t> > streams(ptyCount + udpCount);
+  std::vector<std::vector<uint32_t> > ends(ptyCount + udpCount);
+
+  gateway.interval = 0;
+
+  for (int i = 0; i < (ptyCount + udpCount); i++)
+  {
+    streams[i] = benchStream(i * GATEWAY_BENCH_NODES, count, ends[i]);
+  }
+
+  startWorkers(gateway, workerCount);
+
+  std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+  bool ready = true;                                           //false=input failed, threads already started are still joined
+  int  error = 0;
+
+  for (int i = 0; i < ptyCount; i++)
+  {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (master < 0) {error = errno; ready = false; break;}
+
+    fds.push_back(master);
+
+    if ((grantpt(master) != 0) || (unlockpt(master) != 0)) {error = errno; ready = false; break;}
+
+    int slave = open(ptsname(master), O_RDONLY | O_NOCTTY);
+
+    if (slave < 0) {error = errno; ready = false; break;}
+
+    makeRaw(slave, 0);
+
+    readers.push_back(std::thread(readStream, std::ref(gateway), slave));
+    writers.push_back(std::thread(writePty, master, &streams[i]));
+  }
+
+  for (int i = 0; (i < udpCount) && (ready == true); i++)
+  {
+    int receiver = openUdp(0);                                 //any free port
+
+    if (receiver < 0) {error = errno; ready = false; break;}
+
+    int sender = socket(AF_INET, SOCK_DGRAM, 0);
+
+    if (sender < 0) {error = errno; ready = false; close(receiver); break;}
+
+    fds.push_back(sender);
+
+    readers.push_back(std::thread(readDatagrams, std::ref(gateway), receiver));
+    writers.push_back(std::thread(writeUdp, sender, boundPort(receiver), &streams[ptyCount + i], &ends[ptyCount + i]));
+  }
+
+  for (size_t i = 0; i < writers.size(); i++) writers[i].join();
+
+  /* wait until all frames are decoded or nothing moves, UDP may drop */
+  uint64_t expected = (uint64_t)count * (ptyCount + udpCount);
+  uint64_t last     = 0;
+
+  std::chrono::steady_clock::time_point progressTime = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point endTime      = progressTime;
+
+  while (ready == true)
+  {
+    uint64_t done = gateway.frames.load();
+
+    if (gateway.workers.size() != 0)
+    {
+      done = 0;
+
+      for (size_t i = 0; i < gateway.workers.size(); i++) done += gateway.workers[i]->processed.load(std::memory_order_acquire);
+    }
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    if (done != last)
+    {
+      last         = done;
+      progressTime = now;
+      endTime      = now;
+    }
+
+    if ((done >= expected) || ((now - progressTime) > std::chrono::milliseconds(GATEWAY_BENCH_IDLE))) break;
+
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+
+  double seconds = std::chrono::duration<double>(endTime - startTime).count();
+
+  stopped.store(true);
+
+  for (size_t i = 0; i < readers.size(); i++) readers[i].join();
+  for (size_t i = 0; i < fds.size(); i++)     close(fds[i]);
+
+  stopped.store(false);
+
+  stopWorkers(gateway);
+
+  if (ready != true)
+  {
+    errno = error;                                             //for caller message, "close()" may overwrite it
+
+    return false;
+  }
+
+  Aggregator &total  = gateway.shared;
+  uint64_t    errors = total.cobsErrors + total.crcErrors + total.formatErrors;
+
+  printf("%d,%d,%d,%d,%llu,%llu,%llu,%llu,%llu,%.3f,%.0f\n", ptyCount + udpCount, ptyCount, udpCount, workerCount,
+         (unsigned long long)expected, (unsigned long long)total.decoded, (unsigned long long)(expected - total.decoded),
+         (unsigned long long)errors, (unsigned long long)gateway.stalls.load(), seconds, total.decoded / seconds);
+
+  fflush(stdout);
+
+  return true;
+}
+
+
+int main(int argc, char **argv)
+{
+  int                       workerCount = -1;
+  uint32_t                  interval    = 10;
+  long                      baud        = 115200;
+  bool                      benchMode   = false;
+  int                       ptyCount    = 4;
+  int                       udpCount    = 4;
+  uint32_t                  count       = GATEWAY_BENCH_COUNT;
+  std::vector<const char *> paths;
+
+  for (int i = 1; i < argc; i++)
+  {
+    bool value = (i + 1) < argc;
+
+    if      ((strcmp(argv[i], "-w") == 0)    && (value == true)) workerCount = atoi(argv[++i]);
+    else if ((strcmp(argv[i], "-i") == 0)    && (value == true)) interval    = atoi(argv[++i]);
+    else if ((strcmp(argv[i], "-b") == 0)    && (value == true)) baud        = atol(argv[++i]);
+    else if ((strcmp(argv[i], "-c") == 0)    && (value == true)) count       = atol(argv[++i]);
+    else if ((strcmp(argv[i], "-s") == 0)    && (value == true)) storageCost = atol(argv[++i]);
+    else if ((strcmp(argv[i], "--pty") == 0) && (value == true)) ptyCount    = atoi(argv[++i]);
+    else if ((strcmp(argv[i], "--udp") == 0) && (value == true)) udpCount    = atoi(argv[++i]);
+    else if  (strcmp(argv[i], "--bench") == 0)                   benchMode   = true;
+    else                                                         paths.push_back(argv[i]);
+  }
+
+  if ((workerCount > GATEWAY_MAX_WORKERS) || (baudRate(baud) == 0) || ((benchMode != true) && (paths.size() == 0)) ||
+      ((benchMode == true) && ((ptyCount + udpCount) == 0)))
+  {
+    fprintf(stderr, "usage: %s [-w workers] [-i interval] [-b baud] input [input...]\n"
+                    "       %s --bench [-w workers] [--pty n] [--udp n] [-c count] [-s ns]\n", argv[0], argv[0]);
+
+    return 2;
+  }
+
+  if (benchMode == true)
+  {
+    const int sweep[] = {0, 1, 2, 4};
+
+    printf("inputs,pty,udp,workers,packets,decoded,lost,errors,stalls,seconds,frames_per_sec\n");
+
+    for (size_t i = 0; i < (sizeof(sweep) / sizeof(sweep[0])); i++)
+    {
+      int workers = (workerCount < 0) ? sweep[i] : workerCount;
+
+      if (bench(workers, ptyCount, udpCount, count) != true)
+      {
+        fprintf(stderr, "can't create bench inputs: %s\n", strerror(errno));
+
+        return 1;
+      }
+
+      if (workerCount >= 0) break;
+    }
+
+    return 0;
+  }
+
+  Gateway                  gateway;
+  std::vector<std::thread> readers;
+
+  gateway.interval = interval;
+
+  startWorkers(gateway, (workerCount < 0) ? 2 : workerCount);
+
+  std::thread printer;
+
+  if ((gateway.workers.size() == 0) && (interval != 0)) printer = std::thread(printShared, std::ref(gateway));
+
+  signal(SIGINT,  onSignal);
+  signal(SIGTERM, onSignal);
+
+  printf("node,sensor,packets,lost,reordered,sensor_errors,time_ms,humidity,temperature,humidity_mean,temperature_mean\n");
+
+  for (size_t i = 0; i < paths.size(); i++)
+  {
+    bool success;
+
+    readers.push_back(openInput(gateway, paths[i], baudRate(baud), success));
+
+    if (success != true) fprintf(stderr, "can't open %s: %s\n", paths[i], strerror(errno));
+  }
+
+  for (size_t i = 0; i < readers.size(); i++)
+  {
+    if (readers[i].joinable() == true) readers[i].join();      //EOF or signal
+  }
+
+  stopWorkers(gateway);
+
+  if (printer.joinable() == true) printer.join();
+
+  gateway.shared.print(stdout);
+
+  fprintf(stderr, "frames %llu, decoded %llu, lost %llu, cobs_errors %llu, crc_errors %llu, format_errors %llu, stalls %llu\n",
+          (unsigned long long)gateway.frames.load(), (unsigned long long)gateway.shared.decoded, (unsigned long long)gateway.shared.lost(),
+          (unsigned long long)gateway.shared.cobsErrors, (unsigned long long)gateway.shared.crcErrors,
+          (unsigned long long)gateway.shared.formatErrors, (unsigned long long)gateway.stalls.load());
+
+  return 0;
+}
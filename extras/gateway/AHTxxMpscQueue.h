@@ -0,0 +1,116 @@
+/***************************************************************************************************/
+/*
+   Bounded lock-free multi-producer single-consumer queue for host tools
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   NOTE:
+   - D. Vyukov bounded queue, every cell has own sequence number,
+     producers claim cells with one CAS on tail, consumer owns head
+   - no allocation after construction, no locks, no ABA
+   - size must be power of 2
+   - "push()" returns false when queue is full, caller decides to retry
+     or drop
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_MPSC_QUEUE_h
+#define AHTXX_MPSC_QUEUE_h
+
+
+#include <stddef.h>
+#include <atomic>
+
+
+#define AHTXX_CACHE_LINE  64   //padding keeps head, tail & cells of different threads apart, no over-aligned "new" in C++11
+
+
+template <typename T, size_t Size>
+class AHTxxMpscQueue
+{
+  static_assert((Size >= 2) && ((Size & (Size - 1)) == 0), "size must be power of 2");
+
+  public:
+
+   AHTxxMpscQueue()
+   {
+     for (size_t i = 0; i < Size; i++)
+     {
+       _cells[i].sequence.store(i, std::memory_order_relaxed);
+     }
+
+     _tail.store(0, std::memory_order_relaxed);
+
+     _head = 0;
+   }
+
+   /* any thread */
+   bool push(const T &value)
+   {
+     size_t position = _tail.load(std::memory_order_relaxed);
+
+     for (;;)
+     {
+       Cell     &cell     = _cells[position & (Size - 1)];
+       size_t    sequence = cell.sequence.load(std::memory_order_acquire);
+       ptrdiff_t state    = (ptrdiff_t)sequence - (ptrdiff_t)position;
+
+       if (state == 0)                                         //free cell, try to claim it
+       {
+         if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed) == true)
+         {
+           cell.value = value;
+
+           cell.sequence.store(position + 1, std::memory_order_release); //publish to consumer
+
+           return true;
+         }
+       }
+       else if (state < 0)
+       {
+         return false;                                         //full, consumer is one lap behind
+       }
+       else
+       {
+         position = _tail.load(std::memory_order_relaxed);     //other producer took it
+       }
+     }
+   }
+
+   /* consumer thread only */
+   bool pop(T &value)
+   {
+     Cell  &cell     = _cells[_head & (Size - 1)];
+     size_t sequence = cell.sequence.load(std::memory_order_acquire);
+
+     if (sequence != (_head + 1)) return false;                //empty or producer still writing
+
+     value = cell.value;
+
+     cell.sequence.store(_head + Size, std::memory_order_release);     //free for next lap
+
+     _head++;
+
+     return true;
+   }
+
+
+  private:
+   struct Cell
+   {
+     std::atomic<size_t> sequence;
+     T                   value;
+   };
+
+   Cell                _cells[Size];
+   char                _cellsPadding[AHTXX_CACHE_LINE];
+   std::atomic<size_t> _tail;
+   char                _tailPadding[AHTXX_CACHE_LINE];
+   size_t              _head;
+};
+
+#endif
@@ -0,0 +1,323 @@
+/***************************************************************************************************/
+/*
+   Flat per-sensor state table of gateway
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "AHTxxStateTable.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+static_assert(sizeof(AHTxxSample)     == 16,               "sample must be 16 bytes with padding");
+static_assert(sizeof(AHTxxStateEntry) == AHTXX_STATE_LINE, "entry must be one cache line");
+
+
+/**************************************************************************/
+/*
+    Constructor
+
+    NOTE:
+    - capacity, expected number of sensors
+*/
+/**************************************************************************/
+AHTxxStateTable::AHTxxStateTable(size_t capacity)
+{
+  _entries = 0;
+  _mask    = 0;
+  _size    = 0;
+
+  reserve(capacity);
+}
+
+AHTxxStateTable::~AHTxxStateTable()
+{
+  free(_entries);
+}
+
+
+/**************************************************************************/
+/*
+    find()
+
+    Return entry of sensor or 0 if unknown
+*/
+/**************************************************************************/
+AHTxxStateEntry *AHTxxStateTable::find(uint32_t key)
+{
+  if ((_entries == 0) || (key == AHTXX_STATE_EMPTY)) return 0;
+
+  for (size_t slot = _hash(key) & _mask; ; slot = (slot + 1) & _mask)
+  {
+    if (_entries[slot].key == key)               return &_entries[slot];
+    if (_entries[slot].key == AHTXX_STATE_EMPTY) return 0;                 //no reason to continue, end of probe chain
+  }
+}
+
+
+/**************************************************************************/
+/*
+    insert()
+
+    Return entry of sensor, new sensor gets cleared entry
+
+    NOTE:
+    - returns 0 for AHTXX_STATE_EMPTY key or out of memory
+*/
+/**************************************************************************/
+AHTxxStateEntry *AHTxxStateTable::insert(uint32_t key)
+{
+  if (key == AHTXX_STATE_EMPTY) return 0;
+
+  if (((_size + 1) * 100) > ((_mask + 1) * AHTXX_STATE_MAX_LOAD))
+  {
+    if (_resize((_mask + 1) * 2) != true) return 0;
+  }
+
+  for (size_t slot = _hash(key) & _mask; ; slot = (slot + 1) & _mask)
+  {
+    AHTxxStateEntry *entry = &_entries[slot];
+
+    if (entry->key == key) return entry;
+
+    if (entry->key == AHTXX_STATE_EMPTY)
+    {
+      clear(entry, key);
+
+      _size++;
+
+      return entry;
+    }
+  }
+}
+
+
+/**************************************************************************/
+/*
+    update()
+
+    Apply decoded packet to sensor entry, sensor is added if unknown
+*/
+/**************************************************************************/
+AHTxxStateEntry *AHTxxStateTable::update(uint32_t key, const AHTxxPacket *packet)
+{
+  AHTxxStateEntry *entry = insert(key);
+
+  if (entry != 0) apply(entry, packet);
+
+  return entry;
+}
+
+
+/**************************************************************************/
+/*
+    update()
+
+    Apply batch of packets, keys[i] is sensor of packets[i]
+
+    NOTE:
+    - packets of same sensor are applied in batch order
+    - home slots of AHTXX_STATE_BATCH keys are prefetched before first
+      one is touched
+*/
+/**************************************************************************/
+void AHTxxStateTable::update(const uint32_t *keys, const AHTxxPacket *packets, size_t count)
+{
+  for (size_t start = 0; start < count; start += AHTXX_STATE_BATCH)
+  {
+    size_t end = ((start + AHTXX_STATE_BATCH) < count) ? (start + AHTXX_STATE_BATCH) : count;
+
+    for (size_t i = start; i < end; i++)
+    {
+      __builtin_prefetch(&_entries[_hash(keys[i]) & _mask], 1);   //write, entry is updated next
+    }
+
+    for (size_t i = start; i < end; i++)
+    {
+      update(keys[i], &packets[i]);
+    }
+  }
+}
+
+
+/**************************************************************************/
+/*
+    reserve()
+
+    Make room for count sensors without rehash
+
+    NOTE:
+    - false=out of memory, table is unchanged
+*/
+/**************************************************************************/
+bool AHTxxStateTable::reserve(size_t count)
+{
+  size_t capacity = 16;
+
+  while ((capacity * AHTXX_STATE_MAX_LOAD) < (count * 100)) capacity *= 2;
+
+  if ((_entries != 0) && (capacity <= (_mask + 1))) return true;
+
+  return _resize(capacity);
+}
+
+
+/**************************************************************************/
+/*
+    getSize(), getCapacity()
+
+    Return number of sensors & number of slots
+*/
+/**************************************************************************/
+size_t AHTxxStateTable::getSize() const
+{
+  return _size;
+}
+
+size_t AHTxxStateTable::getCapacity() const
+{
+  return (_entries == 0) ? 0 : (_mask + 1);
+}
+
+
+/**************************************************************************/
+/*
+    getEntry()
+
+    Return entry in slot or 0 if slot is free
+
+    NOTE:
+    - for iteration, slot 0..getCapacity()-1, order is random
+*/
+/**************************************************************************/
+const AHTxxStateEntry *AHTxxStateTable::getEntry(size_t slot) const
+{
+  if ((_entries == 0) || (slot > _mask) || (_entries[slot].key == AHTXX_STATE_EMPTY)) return 0;
+
+  return &_entries[slot];
+}
+
+
+/**************************************************************************/
+/*
+    apply()
+
+    Update last sample, health & statistics of entry with packet
+
+    NOTE:
+    - error status or packet without frame updates health only, last
+      valid sample & statistics stay
+*/
+/**************************************************************************/
+void AHTxxStateTable::apply(AHTxxStateEntry *entry, const AHTxxPacket *packet)
+{
+  AHTxxStateHealth &health = entry->health;
+  AHTxxSample      &sample = entry->sample;
+  AHTxxStateStats  &stats  = entry->stats;
+
+  uint32_t humidity    = ahtxxPacketRawHumidity(packet);
+  uint32_t temperature = ahtxxPacketRawTemperature(packet);
+
+  health.packets++;
+
+  sample.time   = packet->time;
+  sample.status = packet->status;
+
+  if (humidity == AHTXX_RAW_ERROR)
+  {
+    health.errors++;
+
+    health.errorTime = packet->time;
+    health.lastError = packet->status;
+
+    return;                                                    //no reason to continue, no valid data
+  }
+
+  sample.rawHumidity    = humidity;
+  sample.rawTemperature = temperature;
+
+  if (stats.minHumidity == AHTXX_RAW_ERROR)                    //first valid sample
+  {
+    stats.meanHumidity    = humidity    << 8;
+    stats.meanTemperature = temperature << 8;
+  }
+  else
+  {
+    stats.meanHumidity    += ((int32_t)(humidity    << 8) - stats.meanHumidity)    >> AHTXX_STATE_EWMA_SHIFT;
+    stats.meanTemperature += ((int32_t)(temperature << 8) - stats.meanTemperature) >> AHTXX_STATE_EWMA_SHIFT;
+  }
+
+  if (humidity    < stats.minHumidity)    stats.minHumidity    = humidity;
+  if (humidity    > stats.maxHumidity)    stats.maxHumidity    = humidity;
+  if (temperature < stats.minTemperature) stats.minTemperature = temperature;
+  if (temperature > stats.maxTemperature) stats.maxTemperature = temperature;
+}
+
+
+/**************************************************************************/
+/*
+    clear()
+
+    Reset entry to new sensor without samples
+*/
+/**************************************************************************/
+void AHTxxStateTable::clear(AHTxxStateEntry *entry, uint32_t key)
+{
+  memset(entry, 0, sizeof(AHTxxStateEntry));
+
+  entry->key                  = key;
+  entry->sample.rawHumidity    = AHTXX_RAW_ERROR;
+  entry->sample.rawTemperature = AHTXX_RAW_ERROR;
+  entry->stats.minHumidity     = AHTXX_RAW_ERROR;
+  entry->stats.minTemperature  = AHTXX_RAW_ERROR;
+}
+
+
+/* murmur3 finalizer, sequential ids spread over all slots */
+uint32_t AHTxxStateTable::_hash(uint32_t key)
+{
+  key ^= key >> 16;
+  key *= 0x85EBCA6B;
+  key ^= key >> 13;
+  key *= 0xC2B2AE35;
+  key ^= key >> 16;
+
+  return key;
+}
+
+bool AHTxxStateTable::_resize(size_t capacity)
+{
+  void *memory = 0;
+
+  if (posix_memalign(&memory, AHTXX_STATE_LINE, capacity * sizeof(AHTxxStateEntry)) != 0) return false;
+
+  AHTxxStateEntry *entries = (AHTxxStateEntry *)memory;
+  size_t           mask    = capacity - 1;
+
+  for (size_t i = 0; i < capacity; i++) entries[i].key = AHTXX_STATE_EMPTY;
+
+  for (size_t i = 0; (_entries != 0) && (i <= _mask); i++)
+  {
+    if (_entries[i].key == AHTXX_STATE_EMPTY) continue;
+
+    size_t slot = _hash(_entries[i].key) & mask;
+
+    while (entries[slot].key != AHTXX_STATE_EMPTY) slot = (slot + 1) & mask;
+
+    entries[slot] = _entries[i];
+  }
+
+  free(_entries);
+
+  _entries = entries;
+  _mask    = mask;
+
+  return true;
+}
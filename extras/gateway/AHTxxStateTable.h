@@ -0,0 +1,112 @@
+/***************************************************************************************************/
+/*
+   Flat per-sensor state table of gateway
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Layout:
+   - open addressing, linear probing, power of 2 slots in one array
+   - one entry is one 64 bytes cache line, key, last sample, health &
+     rolling statistics, update touches one line when key is found
+     in home slot, next slot is next line on collision
+   - batched update hashes & prefetches whole batch first, then applies
+     it, cache misses of batch overlap instead of following each other
+
+   NOTE:
+   - key is any 32-bit sensor id except AHTXX_STATE_EMPTY, gateway uses
+     "node << 8 | sensor"
+   - table grows x2 at 70% load, reserve capacity up front to avoid
+     rehash under burst, entry pointers are valid until next insert
+   - sensors are never removed, gateway keeps state for its lifetime
+   - not thread safe, one table per worker
+   - last sample is library "AHTxxSample", same as "AHTxxSampler::read()",
+     "AHTxxSample.h" is Arduino-free, no host stand-ins needed
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_STATE_TABLE_h
+#define AHTXX_STATE_TABLE_h
+
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "AHTxxPacket.h"
+#include "AHTxxSample.h"
+
+
+#define AHTXX_STATE_EMPTY        0xFFFFFFFF  //key of free slot
+#define AHTXX_STATE_LINE         64          //entry size & alignment
+#define AHTXX_STATE_MAX_LOAD     70          //grow above, in %
+#define AHTXX_STATE_BATCH        16          //prefetched keys per batch step
+#define AHTXX_STATE_EWMA_SHIFT   4           //rolling mean weight, 1/16
+
+
+/* sensor health, 16 bytes */
+typedef struct
+{
+  uint32_t packets;
+  uint32_t errors;                           //packets with error status
+  uint32_t errorTime;                        //sender time of last error
+  uint8_t  lastError;                        //status of last error
+  uint8_t  reserved[3];
+}
+AHTxxStateHealth;
+
+/* rolling statistics of valid samples, 24 bytes */
+typedef struct
+{
+  int32_t  meanHumidity;                     //EWMA, raw * 256
+  int32_t  meanTemperature;
+  uint32_t minHumidity;                      //raw, AHTXX_RAW_ERROR=no valid sample yet
+  uint32_t maxHumidity;
+  uint32_t minTemperature;
+  uint32_t maxTemperature;
+}
+AHTxxStateStats;
+
+typedef struct
+{
+  uint32_t         key;
+  uint32_t         reserved;
+  AHTxxSample      sample;                   //last decoded sample, sender time, AHTXX_RAW_ERROR=no valid sample yet, 13 bytes + 3 bytes tail padding
+  AHTxxStateHealth health;
+  AHTxxStateStats  stats;
+}
+AHTxxStateEntry;
+
+
+class AHTxxStateTable
+{
+  public:
+
+   AHTxxStateTable(size_t capacity = 1024);
+  ~AHTxxStateTable();
+
+   AHTxxStateEntry       *find(uint32_t key);
+   AHTxxStateEntry       *insert(uint32_t key);
+   AHTxxStateEntry       *update(uint32_t key, const AHTxxPacket *packet);
+   void                   update(const uint32_t *keys, const AHTxxPacket *packets, size_t count);
+   bool                   reserve(size_t count);
+   size_t                 getSize() const;
+   size_t                 getCapacity() const;
+   const AHTxxStateEntry *getEntry(size_t slot) const;
+
+   static void            apply(AHTxxStateEntry *entry, const AHTxxPacket *packet);
+   static void            clear(AHTxxStateEntry *entry, uint32_t key);
+
+
+  private:
+   AHTxxStateEntry *_entries;
+   size_t           _mask;                    //capacity - 1
+   size_t           _size;
+
+   static uint32_t  _hash(uint32_t key);
+   bool             _resize(size_t capacity);
+};
+
+#endif
@@ -0,0 +1,199 @@
+/***************************************************************************************************/
+/*
+   Host benchmark of gateway per-sensor state table
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Build & run on a Linux/macOS host:
+   - g++ -O2 -std=c++11 -I../../src AHTxxStateTableBench.cpp AHTxxStateTable.cpp ../../src/AHTxxPacket.cpp -o state_bench
+   - ./state_bench [sensors] [updates]   default 100000 sensors, 10000000 updates
+
+   Metrics, CSV "table,sensors,updates,updates_per_sec,ns_per_update":
+   - std::map & std::unordered_map with same entry, old gateway design
+   - flat table, one update at a time & batched with prefetch
+   - sensor ids are random 32-bit, every update picks random sensor,
+     worst case for caches, same sequence for all tables
+
+   NOTE:
+   - every table ends with same per-sensor packet & error counts, exit
+     code 1 on mismatch
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "AHTxxStateTable.h"
+
+
+#define BENCH_PACKETS  4096   //distinct packets, reused
+
+
+static uint32_t seed = 1;
+
+static uint32_t random32()
+{
+  seed ^= seed << 13;                                          //xorshift32
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+
+  return seed;
+}
+
+static void report(const char *table, size_t sensors, size_t updates, std::chrono::steady_clock::time_point startTime)
+{
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+  printf("%s,%zu,%zu,%.0f,%.1f\n", table, sensors, updates, updates / seconds, seconds * 1e9 / updates);
+}
+
+static uint64_t checksum(const AHTxxStateEntry *entry)
+{
+  return ((uint64_t)entry->key * 31 + entry->health.packets) * 31 + entry->health.errors + entry->stats.maxTemperature;
+}
+
+
+int main(int argc, char **argv)
+{
+  size_t sensorCount = (argc >= 2) ? atol(argv[1]) : 100000;
+  size_t updateCount = (argc >= 3) ? atol(argv[2]) : 10000000;
+
+  /* same ids, packets & order for every table */
+  std::vector<uint32_t>    ids(sensorCount);
+  std::vector<uint32_t>    keys(updateCount);
+  std::vector<AHTxxPacket> packets(updateCount);
+  std::vector<AHTxxPacket> templates(BENCH_PACKETS);
+
+  for (size_t i = 0; i < sensorCount; i++)
+  {
+    do {ids[i] = random32();} while (ids[i] == AHTXX_STATE_EMPTY);
+  }
+
+  for (size_t i = 0; i < BENCH_PACKETS; i++)
+  {
+    AHTxxPacket &packet = templates[i];
+
+    memset(&packet, 0, sizeof(packet));
+
+    packet.time     = i * 1000;
+    packet.status   = ((i % 100) == 0) ? 0x02 : 0x00;          //1% ACK errors
+    packet.length   = 7;
+    packet.frame[0] = 0x18;
+    packet.frame[1] = random32();
+    packet.frame[2] = random32();
+    packet.frame[3] = random32();
+    packet.frame[4] = random32();
+    packet.frame[5] = random32();
+  }
+
+  for (size_t i = 0; i < updateCount; i++)
+  {
+    keys[i]    = ids[random32() % sensorCount];
+    packets[i] = templates[i % BENCH_PACKETS];
+  }
+
+  printf("table,sensors,updates,updates_per_sec,ns_per_update\n");
+
+  uint64_t reference = 0;
+  bool     pass      = true;
+
+  /* std::map */
+  {
+    std::map<uint32_t, AHTxxStateEntry> table;
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < updateCount; i++)
+    {
+      std::map<uint32_t, AHTxxStateEntry>::iterator found = table.find(keys[i]);
+
+      if (found == table.end())
+      {
+        found = table.insert(std::make_pair(keys[i], AHTxxStateEntry())).first;
+
+        AHTxxStateTable::clear(&found->second, keys[i]);
+      }
+
+      AHTxxStateTable::apply(&found->second, &packets[i]);
+    }
+
+    report("std_map", sensorCount, updateCount, startTime);
+
+    for (std::map<uint32_t, AHTxxStateEntry>::iterator i = table.begin(); i != table.end(); ++i) reference += checksum(&i->second);
+  }
+
+  /* std::unordered_map */
+  {
+    std::unordered_map<uint32_t, AHTxxStateEntry> table;
+    uint64_t                                      sum = 0;
+
+    table.reserve(sensorCount);
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < updateCount; i++)
+    {
+      std::unordered_map<uint32_t, AHTxxStateEntry>::iterator found = table.find(keys[i]);
+
+      if (found == table.end())
+      {
+        found = table.insert(std::make_pair(keys[i], AHTxxStateEntry())).first;
+
+        AHTxxStateTable::clear(&found->second, keys[i]);
+      }
+
+      AHTxxStateTable::apply(&found->second, &packets[i]);
+    }
+
+    report("std_unordered_map", sensorCount, updateCount, startTime);
+
+    for (std::unordered_map<uint32_t, AHTxxStateEntry>::iterator i = table.begin(); i != table.end(); ++i) sum += checksum(&i->second);
+
+    pass = pass && (sum == reference);
+  }
+
+  /* flat, one by one & batched */
+  for (uint8_t batched = 0; batched < 2; batched++)
+  {
+    AHTxxStateTable table(sensorCount);
+    uint64_t        sum = 0;
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    if (batched == 0)
+    {
+      for (size_t i = 0; i < updateCount; i++) table.update(keys[i], &packets[i]);
+    }
+    else
+    {
+      table.update(&keys[0], &packets[0], updateCount);
+    }
+
+    report((batched == 0) ? "flat" : "flat_batched", sensorCount, updateCount, startTime);
+
+    for (size_t i = 0; i < table.getCapacity(); i++)
+    {
+      if (table.getEntry(i) != 0) sum += checksum(table.getEntry(i));
+    }
+
+    pass = pass && (sum == reference) && (table.getSize() <= sensorCount);
+  }
+
+  if (pass != true)
+  {
+    fprintf(stderr, "tables don't match\n");
+
+    return 1;
+  }
+
+  return 0;
+}
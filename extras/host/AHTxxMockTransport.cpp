@@ -0,0 +1,386 @@
+/***************************************************************************************************/
+/*
+   Scripted "AHTxxTransport" for host tests of asynchronous measurement
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "AHTxxMockTransport.h"
+
+
+/**************************************************************************/
+/*
+    AHTxxMockTransport Constructor
+
+    NOTE:
+    - deferred completion, no failures, RH 40%, T 26C frame
+*/
+/**************************************************************************/
+AHTxxMockTransport::AHTxxMockTransport()
+{
+  _immediate       = false;
+  _queueFull       = 0;
+  _writeNack       = 0;
+  _shortRead       = 0;
+  _busyReads       = 0;
+  _stuck           = false;
+  _address         = 0;
+  _writes          = 0;
+  _reads           = 0;
+  _refused         = 0;
+
+  _pending         = false;
+  _pendingRead     = false;
+  _pendingData     = 0;
+  _pendingLength   = 0;
+  _pendingCallback = 0;
+  _pendingContext  = 0;
+
+  memset(_command, 0, sizeof(_command));
+
+  setFrame(0x66666, 0x5C28F);                          //RH 40%, T 26C
+}
+
+
+/**************************************************************************/
+/*
+    write()
+
+    Save command & queue write
+
+    NOTE:
+    - false=queue full, transfer in flight or "setQueueFull()"
+*/
+/**************************************************************************/
+bool AHTxxMockTransport::write(uint8_t address, const uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context)
+{
+  if (_submit(address, false, 0, length, callback, context) != true) return false; //no reason to continue, queue full
+
+  memcpy(_command, data, (length < sizeof(_command)) ? length : sizeof(_command));
+
+  if ((_immediate == true) && (_stuck != true)) _complete();
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    read()
+
+    Queue read
+
+    NOTE:
+    - see "write()" NOTE
+*/
+/**************************************************************************/
+bool AHTxxMockTransport::read(uint8_t address, uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context)
+{
+  if (_submit(address, true, data, length, callback, context) != true) return false; //no reason to continue, queue full
+
+  if ((_immediate == true) && (_stuck != true)) _complete();
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    poll()
+
+    Complete transfer in flight
+*/
+/**************************************************************************/
+void AHTxxMockTransport::poll()
+{
+  if ((_pending == true) && (_stuck != true)) _complete();
+}
+
+
+/**************************************************************************/
+/*
+    setImmediate()
+
+    Set completion mode
+
+    NOTE:
+    - true=callback before "write()/read()" return, false=on "poll()"
+*/
+/**************************************************************************/
+void AHTxxMockTransport::setImmediate(bool immediate)
+{
+  _immediate = immediate;
+}
+
+
+/**************************************************************************/
+/*
+    setQueueFull()
+
+    Refuse next n-submits
+*/
+/**************************************************************************/
+void AHTxxMockTransport::setQueueFull(uint8_t submits)
+{
+  _queueFull = submits;
+}
+
+
+/**************************************************************************/
+/*
+    setWriteNack()
+
+    Complete next n-writes with AHTXX_ACK_ERROR
+*/
+/**************************************************************************/
+void AHTxxMockTransport::setWriteNack(uint8_t writes)
+{
+  _writeNack = writes;
+}
+
+
+/**************************************************************************/
+/*
+    setShortRead()
+
+    Complete next n-reads with AHTXX_DATA_ERROR
+
+    NOTE:
+    - same result as "AHTxxWireTransport" when sensor sends less
+      bytes than requested, data buffer is not touched
+*/
+/**************************************************************************/
+void AHTxxMockTransport::setShortRead(uint8_t reads)
+{
+  _shortRead = reads;
+}
+
+
+/**************************************************************************/
+/*
+    setBusyReads()
+
+    Set busy bit in status byte of next n-reads
+*/
+/**************************************************************************/
+void AHTxxMockTransport::setBusyReads(uint8_t reads)
+{
+  _busyReads = reads;
+}
+
+
+/**************************************************************************/
+/*
+    setStuck()
+
+    Stop completing transfers, stuck bus or lost interrupt
+
+    NOTE:
+    - transfer in flight completes on first "poll()" after
+      "setStuck(false)"
+*/
+/**************************************************************************/
+void AHTxxMockTransport::setStuck(bool stuck)
+{
+  _stuck = stuck;
+}
+
+
+/**************************************************************************/
+/*
+    setFrame()
+
+    Set measurement frame returned by read
+
+    NOTE:
+    - status byte is calibrated & not busy
+    - 20-bit raw values, see "AHTxx::readRawHumidity()" &
+      "AHTxx::readRawTemperature()"
+    - CRC8 is same as "AHTxx::_checkCRC8()", ignored by AHT1x
+*/
+/**************************************************************************/
+void AHTxxMockTransport::setFrame(uint32_t rawHumidity, uint32_t rawTemperature)
+{
+  _frame[0] = AHTXX_STATUS_CTRL_CAL_ON | AHTXX_STATUS_CTRL_CRC;
+  _frame[1] = rawHumidity >> 12;
+  _frame[2] = rawHumidity >> 4;
+  _frame[3] = ((rawHumidity & 0x0F) << 4) | ((rawTemperature >> 16) & 0x0F);
+  _frame[4] = rawTemperature >> 8;
+  _frame[5] = rawTemperature;
+
+  uint8_t crc = 0xFF;
+
+  for (uint8_t i = 0; i < 6; i++)
+  {
+    crc ^= _frame[i];
+
+    for (uint8_t bit = 0; bit < 8; bit++) crc = (crc & 0x80) ? ((crc << 1) ^ 0x31) : (crc << 1);
+  }
+
+  _frame[6] = crc;
+}
+
+
+/**************************************************************************/
+/*
+    isPending()
+
+    Return true if transfer is in flight
+*/
+/**************************************************************************/
+bool AHTxxMockTransport::isPending() const
+{
+  return _pending;
+}
+
+
+/**************************************************************************/
+/*
+    getAddress()
+
+    Return address of last submitted transfer
+*/
+/**************************************************************************/
+uint8_t AHTxxMockTransport::getAddress() const
+{
+  return _address;
+}
+
+
+/**************************************************************************/
+/*
+    getCommand()
+
+    Return byte of last write, index 0..2
+*/
+/**************************************************************************/
+uint8_t AHTxxMockTransport::getCommand(uint8_t index) const
+{
+  return (index < sizeof(_command)) ? _command[index] : 0;
+}
+
+
+/**************************************************************************/
+/*
+    getWrites()
+
+    Return number of accepted writes
+*/
+/**************************************************************************/
+uint32_t AHTxxMockTransport::getWrites() const
+{
+  return _writes;
+}
+
+
+/**************************************************************************/
+/*
+    getReads()
+
+    Return number of accepted reads
+*/
+/**************************************************************************/
+uint32_t AHTxxMockTransport::getReads() const
+{
+  return _reads;
+}
+
+
+/**************************************************************************/
+/*
+    getRefused()
+
+    Return number of refused submits, queue full
+*/
+/**************************************************************************/
+uint32_t AHTxxMockTransport::getRefused() const
+{
+  return _refused;
+}
+
+
+/**************************************************************************/
+/*
+    _submit()
+
+    Save transfer in flight
+
+    NOTE:
+    - false=queue full
+*/
+/**************************************************************************/
+bool AHTxxMockTransport::_submit(uint8_t address, bool isRead, uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context)
+{
+  if ((_pending == true) || (_queueFull > 0))
+  {
+    if (_queueFull > 0) _queueFull--;
+
+    _refused++;
+
+    return false;
+  }
+
+  _pending         = true;
+  _pendingRead     = isRead;
+  _pendingData     = data;
+  _pendingLength   = length;
+  _pendingCallback = callback;
+  _pendingContext  = context;
+  _address         = address;
+
+  if (isRead == true) _reads++;
+  else                _writes++;
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    _complete()
+
+    Finish transfer in flight & call its callback
+*/
+/**************************************************************************/
+void AHTxxMockTransport::_complete()
+{
+  uint8_t result = AHTXX_NO_ERROR;
+
+  _pending = false;                                    //before callback, callback may submit next transfer
+
+  if (_pendingRead == true)
+  {
+    if (_shortRead > 0)
+    {
+      _shortRead--;
+
+      result = AHTXX_DATA_ERROR;                       //received data smaller than expected
+    }
+    else
+    {
+      uint8_t length = (_pendingLength < sizeof(_frame)) ? _pendingLength : sizeof(_frame);
+
+      memcpy(_pendingData, _frame, length);
+
+      if (_busyReads > 0)
+      {
+        _busyReads--;
+
+        _pendingData[0] |= AHTXX_STATUS_CTRL_BUSY;
+      }
+    }
+  }
+  else if (_writeNack > 0)
+  {
+    _writeNack--;
+
+    result = AHTXX_ACK_ERROR;                          //sensor didn't return ACK
+  }
+
+  if (_pendingCallback != 0) _pendingCallback(_pendingContext, result);
+}
@@ -0,0 +1,81 @@
+/***************************************************************************************************/
+/*
+   Scripted "AHTxxTransport" for host tests of asynchronous measurement
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   NOTE:
+   - one transfer in flight, next submit is refused like full queue
+     until "poll()" completes it, every state of "updateAsync()" is
+     observable
+   - "setImmediate(true)" completes transfer before "write()/read()"
+     return, same as "AHTxxWireTransport"
+   - failures are scripted: queue full, NACK, short read, busy frames
+     & stuck bus, transfer never completes
+   - frame is copied on read, CRC8 for AHT2x is computed by "setFrame()"
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_MOCK_TRANSPORT_h
+#define AHTXX_MOCK_TRANSPORT_h
+
+
+#include "AHTxx.h"
+
+
+class AHTxxMockTransport : public AHTxxTransport
+{
+  public:
+
+   AHTxxMockTransport();
+
+   bool     write(uint8_t address, const uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context);
+   bool     read(uint8_t address, uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context);
+   void     poll();
+
+   void     setImmediate(bool immediate);
+   void     setQueueFull(uint8_t submits);
+   void     setWriteNack(uint8_t writes);
+   void     setShortRead(uint8_t reads);
+   void     setBusyReads(uint8_t reads);
+   void     setStuck(bool stuck);
+   void     setFrame(uint32_t rawHumidity, uint32_t rawTemperature);
+
+   bool     isPending() const;
+   uint8_t  getAddress() const;
+   uint8_t  getCommand(uint8_t index) const;
+   uint32_t getWrites() const;
+   uint32_t getReads() const;
+   uint32_t getRefused() const;
+
+
+  private:
+   bool                    _immediate;
+   uint8_t                 _queueFull;
+   uint8_t                 _writeNack;
+   uint8_t                 _shortRead;
+   uint8_t                 _busyReads;
+   bool                    _stuck;
+   uint8_t                 _frame[7];
+   uint8_t                 _command[3];
+   uint8_t                 _address;
+   uint32_t                _writes;
+   uint32_t                _reads;
+   uint32_t                _refused;
+
+   bool                    _pending;
+   bool                    _pendingRead;
+   uint8_t                *_pendingData;
+   uint8_t                 _pendingLength;
+   AHTxxTransportCallback  _pendingCallback;
+   void                   *_pendingContext;
+
+   bool     _submit(uint8_t address, bool isRead, uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context);
+   void     _complete();
+};
+
+#endif
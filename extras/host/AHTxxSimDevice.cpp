@@ -0,0 +1,218 @@
+/***************************************************************************************************/
+/*
+   Simulated Aosong ASAIR AHT1x/AHT2x sensor for host builds
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "AHTxxSimDevice.h"
+
+
+AHTxxSimDevice::AHTxxSimDevice(bool crc, uint32_t seed)
+{
+  _crc            = crc;
+  _seed           = (seed != 0) ? seed : 1;
+  _status         = 0x18;                              //calibrated, normal mode, see "_readStatusRegister()" NOTE
+  _conversionTime = AHTXX_SIM_CONVERSION_TIME;
+  _cyclePeriod    = AHTXX_SIM_CYCLE_PERIOD;
+  _cycle          = false;
+  _pending        = false;
+  _startTime      = 0;
+  _readyTime      = 0;
+  _activeTime     = 0;
+  _temperature    = 22 + (_random() % 400) / 100.0;
+  _humidity       = 40 + (_random() % 2000) / 100.0;
+  _measurements   = 0;
+
+  memset(_frame, 0, sizeof(_frame));
+}
+
+/* {0xAC, ctrl, 0x00} measure, {0x71} status, {0xBE/0xE1, ctrl, 0x00} init, {0xBA} soft reset */
+bool AHTxxSimDevice::write(const uint8_t *data, uint8_t length)
+{
+  if (length == 0) return true;                        //address scan
+
+  _advance();
+
+  switch (data[0])
+  {
+    case 0xAC:
+      if ((_cycle == true) || (hostMicros < _readyTime)) return true; //free-running or busy sensor ignores new command
+
+      _start(hostMicros);
+      break;
+
+    case 0xBA:
+      _cycle     = false;
+      _pending   = false;
+      _readyTime = hostMicros + 20000;                 //soft reset takes 20msec
+      _status    = 0x18;
+      break;
+
+    case 0xBE:
+    case 0xE1:
+      if (length > 1) _status = (_status & 0x80) | 0x10 | (data[1] & 0x68);
+
+      if ((_status & 0x60) == 0x20)                    //cycle mode
+      {
+        _cycle = true;
+
+        if (_pending != true) _start(hostMicros);
+      }
+      else if (_cycle == true)
+      {
+        _cycle = false;
+
+        if ((_pending == true) && (_startTime > hostMicros))         //next cycle not started yet
+        {
+          _pending   = false;
+          _readyTime = hostMicros;
+        }
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  return true;
+}
+
+uint8_t AHTxxSimDevice::read(uint8_t *data, uint8_t length)
+{
+  _advance();
+
+  _frame[0] = _status;
+
+  if ((_cycle != true) && (hostMicros < _readyTime)) _frame[0] |= 0x80; //busy
+
+  uint8_t size = _crc ? 7 : 6;
+
+  for (uint8_t i = 0; i < length; i++)
+  {
+    data[i] = (i < size) ? _frame[i] : 0xFF;
+  }
+
+  if ((_crc == true) && (length >= 7)) data[6] = _crc8(data, 6); //CRC covers status byte as sent
+
+  return length;
+}
+
+void AHTxxSimDevice::setConversionTime(uint32_t conversionTime)
+{
+  _conversionTime = conversionTime;
+}
+
+void AHTxxSimDevice::setValues(float temperature, float humidity)
+{
+  _temperature = temperature;
+  _humidity    = humidity;
+}
+
+uint32_t AHTxxSimDevice::getMeasurements()
+{
+  return _measurements;
+}
+
+void AHTxxSimDevice::setCyclePeriod(uint32_t cyclePeriod)
+{
+  _cyclePeriod = cyclePeriod;
+}
+
+uint64_t AHTxxSimDevice::getReadyTime()
+{
+  return _readyTime;
+}
+
+uint64_t AHTxxSimDevice::getActiveTime()
+{
+  _advance();
+
+  uint64_t activeTime = _activeTime;
+
+  if ((_pending == true) && (hostMicros > _startTime)) activeTime += hostMicros - _startTime; //conversion in progress
+
+  return activeTime;
+}
+
+/* xorshift32 */
+uint32_t AHTxxSimDevice::_random()
+{
+  _seed ^= _seed << 13;
+  _seed ^= _seed >> 17;
+  _seed ^= _seed << 5;
+
+  return _seed;
+}
+
+/* schedule conversion, jitter per conversion */
+void AHTxxSimDevice::_start(uint64_t startTime)
+{
+  _startTime = startTime;
+  _readyTime = startTime + _conversionTime + (_random() % (2 * AHTXX_SIM_CONVERSION_JITTER + 1)) - AHTXX_SIM_CONVERSION_JITTER;
+  _pending   = true;
+}
+
+/* complete conversions up to now, cycle mode starts next one every cycle period */
+void AHTxxSimDevice::_advance()
+{
+  while ((_pending == true) && (_readyTime <= hostMicros))
+  {
+    _activeTime += _readyTime - _startTime;
+    _pending     = false;
+
+    _measure();
+
+    if (_cycle == true)
+    {
+      uint64_t startTime = _startTime + _cyclePeriod;
+
+      _start((startTime > _readyTime) ? startTime : _readyTime);
+    }
+  }
+}
+
+/* latch new T/RH into frame, slow sine + noise */
+void AHTxxSimDevice::_measure()
+{
+  double seconds     = hostMicros / 1000000.0;
+  double temperature = _temperature + 0.5 * sin(seconds / 600) + ((int32_t)(_random() % 21) - 10) / 1000.0;
+  double humidity    = _humidity    + 2.0 * sin(seconds / 900) + ((int32_t)(_random() % 21) - 10) / 100.0;
+
+  if (humidity < 0)   humidity = 0;
+  if (humidity > 100) humidity = 100;
+
+  uint32_t rawHumidity    = (uint32_t)(humidity / 100 * 0xFFFFF);
+  uint32_t rawTemperature = (uint32_t)((temperature + 50) / 200 * 0xFFFFF);
+
+  _frame[1] = rawHumidity >> 12;
+  _frame[2] = rawHumidity >> 4;
+  _frame[3] = ((rawHumidity & 0x0F) << 4) | ((rawTemperature >> 16) & 0x0F);
+  _frame[4] = rawTemperature >> 8;
+  _frame[5] = rawTemperature;
+
+  _measurements++;
+}
+
+/* CRC-8, polynomial 0x31, initial value 0xFF, same as "AHTxx::_checkCRC8()" */
+uint8_t AHTxxSimDevice::_crc8(const uint8_t *data, uint8_t length)
+{
+  uint8_t crc = 0xFF;
+
+  for (uint8_t i = 0; i < length; i++)
+  {
+    crc ^= data[i];
+
+    for (uint8_t bit = 0; bit < 8; bit++)
+    {
+      crc = (crc & 0x80) ? ((crc << 1) ^ 0x31) : (crc << 1);
+    }
+  }
+
+  return crc;
+}
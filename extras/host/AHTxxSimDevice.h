@@ -0,0 +1,78 @@
+/***************************************************************************************************/
+/*
+   Simulated Aosong ASAIR AHT1x/AHT2x sensor for host builds
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   NOTE:
+   - answers initialization, status, measurement & soft reset commands
+   - busy bit stays set for conversion time after measurement command
+   - T/RH follow slow sine + noise, frame carries CRC8 for AHT2x
+   - new T/RH latched at end of conversion, read during conversion
+     returns previous data with busy bit
+   - cycle mode (init register bits[6:5]=01) model, datasheet has no
+     info: conversion starts every cycle period by itself, measurement
+     command is ignored, busy bit always 0, read returns latest data
+   - "getActiveTime()" is time spent converting, times measurement
+     current is sensor charge, rest of time sensor sleeps
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_SIM_DEVICE_h
+#define AHTXX_SIM_DEVICE_h
+
+
+#include "Arduino.h"
+#include "Wire.h"
+
+
+#define AHTXX_SIM_CONVERSION_TIME  75000  //typical conversion time, in microseconds
+#define AHTXX_SIM_CONVERSION_JITTER 5000  //+- conversion time spread, in microseconds
+#define AHTXX_SIM_CYCLE_PERIOD     80000  //cycle mode conversion period, in microseconds
+
+
+class AHTxxSimDevice : public HostI2CDevice
+{
+  public:
+
+   AHTxxSimDevice(bool crc = true, uint32_t seed = 1);
+
+   bool     write(const uint8_t *data, uint8_t length);
+   uint8_t  read(uint8_t *data, uint8_t length);
+
+   void     setConversionTime(uint32_t conversionTime);
+   void     setCyclePeriod(uint32_t cyclePeriod);
+   void     setValues(float temperature, float humidity);
+   uint32_t getMeasurements();
+   uint64_t getReadyTime();
+   uint64_t getActiveTime();
+
+
+  private:
+   bool     _crc;
+   uint32_t _seed;
+   uint8_t  _status;
+   uint32_t _conversionTime;
+   uint32_t _cyclePeriod;
+   bool     _cycle;
+   bool     _pending;
+   uint64_t _startTime;
+   uint64_t _readyTime;
+   uint64_t _activeTime;
+   float    _temperature;
+   float    _humidity;
+   uint8_t  _frame[7];
+   uint32_t _measurements;
+
+   uint32_t _random();
+   void     _measure();
+   void     _start(uint64_t startTime);
+   void     _advance();
+   uint8_t  _crc8(const uint8_t *data, uint8_t length);
+};
+
+#endif
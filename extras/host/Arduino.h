@@ -0,0 +1,72 @@
+/***************************************************************************************************/
+/*
+   Host stand-in of "Arduino.h" for building AHTxx library on Linux/macOS
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   NOTE:
+   - time is virtual, "delay()" & I2C transfers advance "hostMicros"
+     instead of sleeping, see "HostArduino.cpp"
+   - only functions used by the library are provided
+   - SDA & SCL are open-drain lines with pull-ups, set "hostStuckPulses"
+     to simulate slave stuck in the middle of byte
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef HOST_ARDUINO_h
+#define HOST_ARDUINO_h
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+
+#define HIGH          0x01
+#define LOW           0x00
+#define INPUT         0x00
+#define OUTPUT        0x01
+#define INPUT_PULLUP  0x02
+
+#define SDA           0x12           //virtual pins
+#define SCL           0x13
+
+#define PROGMEM
+#define pgm_read_byte(address)  (*(const uint8_t  *)(address))
+#define pgm_read_word(address)  (*(const uint16_t *)(address))
+#define pgm_read_dword(address) (*(const uint32_t *)(address))
+#define memcpy_P                memcpy
+#define F(string)               (string)
+
+typedef uint8_t byte;
+
+extern uint64_t hostMicros;          //virtual time since start, in microseconds
+extern uint8_t  hostStuckPulses;     //slave holds SDA low until n SCL pulses, every "Wire" transfer fails
+
+unsigned long millis();
+unsigned long micros();
+void          delay(unsigned long ms);
+void          delayMicroseconds(unsigned int us);
+void          yield();
+void          pinMode(uint8_t pin, uint8_t mode);
+void          digitalWrite(uint8_t pin, uint8_t value);
+int           digitalRead(uint8_t pin);
+
+
+/* byte output base of "Serial", packet writer only needs "write()" */
+class Print
+{
+  public:
+
+   virtual ~Print() {}
+
+   virtual size_t write(uint8_t value) = 0;
+   virtual size_t write(const uint8_t *data, size_t length);
+};
+
+#endif
@@ -0,0 +1,355 @@
+/***************************************************************************************************/
+/*
+   Host stand-in of Arduino core & "Wire.h"
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "Arduino.h"
+#include "Wire.h"
+
+
+uint64_t hostMicros      = 0;
+uint8_t  hostStuckPulses = 0;
+
+static uint8_t sclMode = INPUT_PULLUP;
+
+TwoWire Wire;
+
+
+/**************************************************************************/
+/*
+    Arduino core, virtual time
+*/
+/**************************************************************************/
+unsigned long millis()
+{
+  return (unsigned long)(hostMicros / 1000);
+}
+
+unsigned long micros()
+{
+  return (unsigned long)hostMicros;
+}
+
+void delay(unsigned long ms)
+{
+  hostMicros += (uint64_t)ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  hostMicros += us;
+}
+
+void yield()
+{
+  hostMicros += 1;                                     //polling loops always move forward
+}
+
+/* SCL low->released is one clock pulse for stuck slave */
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  if (pin != SCL) return;
+
+  if ((sclMode == OUTPUT) && (mode != OUTPUT) && (hostStuckPulses > 0)) hostStuckPulses--;
+
+  sclMode = mode;
+}
+
+void digitalWrite(uint8_t, uint8_t)
+{
+}
+
+int digitalRead(uint8_t pin)
+{
+  if (pin == SCL) return (sclMode == OUTPUT) ? LOW : HIGH;
+  if (pin == SDA) return (hostStuckPulses > 0) ? LOW : HIGH;
+
+  return HIGH;                                         //pull-ups
+}
+
+
+/**************************************************************************/
+/*
+    Print
+*/
+/**************************************************************************/
+size_t Print::write(const uint8_t *data, size_t length)
+{
+  size_t written = 0;
+
+  while ((written < length) && (write(data[written]) == 1)) written++;
+
+  return written;
+}
+
+
+/**************************************************************************/
+/*
+    TwoWire
+*/
+/**************************************************************************/
+TwoWire::TwoWire()
+{
+  _speed        = 100000;
+  _address      = 0;
+  _txLength     = 0;
+  _rxLength     = 0;
+  _rxIndex      = 0;
+  _busyTime     = 0;
+  _transactions = 0;
+  _conflicts    = 0;
+}
+
+void TwoWire::begin()
+{
+}
+
+void TwoWire::begin(int, int)
+{
+}
+
+void TwoWire::end()
+{
+}
+
+void TwoWire::setClock(uint32_t speed)
+{
+  if (speed != 0) _speed = speed;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+  _address  = address;
+  _txLength = 0;
+}
+
+void TwoWire::beginTransmission(int address)
+{
+  beginTransmission((uint8_t)address);
+}
+
+size_t TwoWire::write(uint8_t value)
+{
+  if (_txLength >= HOST_WIRE_BUFFER_SIZE) return 0;
+
+  _txBuffer[_txLength++] = value;
+
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t length)
+{
+  size_t written = 0;
+
+  while ((written < length) && (write(data[written]) == 1)) written++;
+
+  return written;
+}
+
+/* 0=success, 2=NACK on address, 3=NACK on data, same as AVR "Wire.h" */
+uint8_t TwoWire::endTransmission(uint8_t)
+{
+  HostI2CDevice *device = (hostStuckPulses == 0) ? _find(_address) : 0; //START can't be sent on stuck bus
+
+  if (device == 0)
+  {
+    _transfer(0);                                      //address byte only
+
+    return 2;
+  }
+
+  _transfer(_txLength);
+
+  return (device->write(_txBuffer, _txLength) == true) ? 0 : 3;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t)
+{
+  if (quantity > HOST_WIRE_BUFFER_SIZE) quantity = HOST_WIRE_BUFFER_SIZE;
+
+  _rxLength = 0;
+  _rxIndex  = 0;
+
+  HostI2CDevice *device = (hostStuckPulses == 0) ? _find(address) : 0;
+
+  if (device == 0)
+  {
+    _transfer(0);
+
+    return 0;
+  }
+
+  _rxLength = device->read(_rxBuffer, quantity);
+
+  _transfer(quantity);
+
+  return _rxLength;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity)
+{
+  return requestFrom(address, quantity, (uint8_t)true);
+}
+
+uint8_t TwoWire::requestFrom(int address, int quantity)
+{
+  return requestFrom((uint8_t)address, (uint8_t)quantity, (uint8_t)true);
+}
+
+uint8_t TwoWire::requestFrom(int address, int quantity, int sendStop)
+{
+  return requestFrom((uint8_t)address, (uint8_t)quantity, (uint8_t)sendStop);
+}
+
+int TwoWire::available()
+{
+  return _rxLength - _rxIndex;
+}
+
+int TwoWire::read()
+{
+  if (_rxIndex >= _rxLength) return -1;
+
+  return _rxBuffer[_rxIndex++];
+}
+
+void TwoWire::attach(uint8_t address, HostI2CDevice *device)
+{
+  Device entry = {address, device};
+
+  _devices.push_back(entry);
+}
+
+void TwoWire::addMux(HostMux *mux)
+{
+  _muxes.push_back(mux);
+
+  attach(mux->getAddress(), mux);
+}
+
+void TwoWire::detach()
+{
+  _devices.clear();
+  _muxes.clear();
+}
+
+uint64_t TwoWire::getBusyTime()
+{
+  return _busyTime;
+}
+
+uint32_t TwoWire::getTransactions()
+{
+  return _transactions;
+}
+
+uint32_t TwoWire::getConflicts()
+{
+  return _conflicts;
+}
+
+void TwoWire::resetStatistics()
+{
+  _busyTime     = 0;
+  _transactions = 0;
+  _conflicts    = 0;
+}
+
+/* direct device first, then devices behind enabled mux channels, two devices answering is a conflict */
+HostI2CDevice *TwoWire::_find(uint8_t address)
+{
+  for (size_t i = 0; i < _devices.size(); i++)
+  {
+    if (_devices[i].address == address) return _devices[i].device;
+  }
+
+  HostI2CDevice *found = 0;
+  uint8_t        count = 0;
+
+  for (size_t i = 0; i < _muxes.size(); i++)
+  {
+    count += _muxes[i]->find(address, &found);
+  }
+
+  if (count > 1)
+  {
+    _conflicts++;
+
+    return 0;                                          //corrupted address phase looks like NACK
+  }
+
+  return found;
+}
+
+/* {START, address, n-bytes with ACK, STOP} */
+void TwoWire::_transfer(uint8_t bytes)
+{
+  uint64_t duration = ((((uint64_t)bytes + 1) * 9 + 2) * 1000000 + _speed - 1) / _speed;
+
+  hostMicros += duration;
+  _busyTime  += duration;
+
+  _transactions++;
+}
+
+
+/**************************************************************************/
+/*
+    HostMux
+*/
+/**************************************************************************/
+HostMux::HostMux(uint8_t address)
+{
+  _address  = address;
+  _channels = 0;
+}
+
+bool HostMux::write(const uint8_t *data, uint8_t length)
+{
+  if (length > 0) _channels = data[length - 1];
+
+  return true;
+}
+
+uint8_t HostMux::read(uint8_t *data, uint8_t length)
+{
+  for (uint8_t i = 0; i < length; i++) data[i] = _channels;
+
+  return length;
+}
+
+void HostMux::attach(uint8_t channel, uint8_t address, HostI2CDevice *device)
+{
+  Device entry = {channel, address, device};
+
+  _devices.push_back(entry);
+}
+
+uint8_t HostMux::getAddress()
+{
+  return _address;
+}
+
+uint8_t HostMux::find(uint8_t address, HostI2CDevice **device)
+{
+  uint8_t count = 0;
+
+  for (size_t i = 0; i < _devices.size(); i++)
+  {
+    if ((_devices[i].address == address) && ((_channels & (1 << _devices[i].channel)) != 0))
+    {
+      *device = _devices[i].device;
+
+      count++;
+    }
+  }
+
+  return count;
+}
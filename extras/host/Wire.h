@@ -0,0 +1,129 @@
+/***************************************************************************************************/
+/*
+   Host stand-in of "Wire.h" with simulated I2C devices & bus timing
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   NOTE:
+   - devices are attached by address, or behind TCA9548A-like mux
+   - every transfer advances virtual time by its duration at bus speed,
+     {START, address, n-bytes, STOP} = (1 + n) * 9 bits + 2 bits
+   - busy time & transaction count are kept per bus
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef HOST_WIRE_h
+#define HOST_WIRE_h
+
+
+#include <vector>
+
+#include "Arduino.h"
+
+
+#define HOST_WIRE_BUFFER_SIZE  32
+
+
+class HostI2CDevice
+{
+  public:
+
+   virtual         ~HostI2CDevice() {}
+   virtual bool    write(const uint8_t *data, uint8_t length) = 0; //false=NACK
+   virtual uint8_t read(uint8_t *data, uint8_t length) = 0;        //number of sent bytes, 0=NACK
+};
+
+
+class TwoWire
+{
+  public:
+
+   TwoWire();
+
+   void     begin();
+   void     begin(int sda, int scl);
+   void     end();
+   void     setClock(uint32_t speed);
+
+   void     beginTransmission(uint8_t address);
+   void     beginTransmission(int address);
+   size_t   write(uint8_t value);
+   size_t   write(const uint8_t *data, size_t length);
+   uint8_t  endTransmission(uint8_t sendStop = true);
+
+   uint8_t  requestFrom(uint8_t address, uint8_t quantity);
+   uint8_t  requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop);
+   uint8_t  requestFrom(int address, int quantity);
+   uint8_t  requestFrom(int address, int quantity, int sendStop);
+   int      available();
+   int      read();
+
+   /* host only */
+   void     attach(uint8_t address, HostI2CDevice *device);
+   void     detach();
+   uint64_t getBusyTime();
+   uint32_t getTransactions();
+   uint32_t getConflicts();
+   void     resetStatistics();
+   void     addMux(class HostMux *mux);
+
+
+  private:
+   struct Device
+   {
+     uint8_t        address;
+     HostI2CDevice *device;
+   };
+
+   std::vector<Device>         _devices;
+   std::vector<class HostMux*> _muxes;
+   uint32_t                    _speed;
+   uint8_t                     _address;
+   uint8_t                     _txBuffer[HOST_WIRE_BUFFER_SIZE];
+   uint8_t                     _txLength;
+   uint8_t                     _rxBuffer[HOST_WIRE_BUFFER_SIZE];
+   uint8_t                     _rxLength;
+   uint8_t                     _rxIndex;
+   uint64_t                    _busyTime;
+   uint32_t                    _transactions;
+   uint32_t                    _conflicts;
+
+   HostI2CDevice *_find(uint8_t address);
+   void           _transfer(uint8_t bytes);
+};
+
+
+/* TCA9548A-like 8 channel I2C mux, channel register is 1-byte bitmask */
+class HostMux : public HostI2CDevice
+{
+  public:
+
+   HostMux(uint8_t address);
+
+   bool     write(const uint8_t *data, uint8_t length);
+   uint8_t  read(uint8_t *data, uint8_t length);
+   void     attach(uint8_t channel, uint8_t address, HostI2CDevice *device);
+   uint8_t  getAddress();
+   uint8_t  find(uint8_t address, HostI2CDevice **device);
+
+
+  private:
+   struct Device
+   {
+     uint8_t        channel;
+     uint8_t        address;
+     HostI2CDevice *device;
+   };
+
+   uint8_t             _address;
+   uint8_t             _channels;
+   std::vector<Device> _devices;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,199 @@
+/***************************************************************************************************/
+/*
+   Host simulation of AHT1x normal, cycle & command mode, sample rate,
+   latency & current
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Build & run on a Linux/macOS host:
+   - g++ -O2 -std=c++11 -I../host -I../../src AHTxxModes.cpp ../host/HostArduino.cpp ../host/AHTxxSimDevice.cpp
+       ../../src/AHTxx.cpp ../../src/AHTxxTransport.cpp ../../src/AHTxxTWI.cpp ../../src/AHTxxUncertainty.cpp -o modes
+   - ./modes [conversion_us [cycle_period_us]]   CSV to stdout
+
+   Method:
+   - AHT10 part on simulated sensor, blocking "readRawTemperature()"
+     every interval, next read starts at once if read took longer
+   - fresh sample, raw data differs from previous read, simulated noise
+     changes raw data on every conversion
+   - current, measurement current of part descriptor while converting,
+     AHTXX_SIM_SLEEP_CURRENT rest of time
+   - energy_pick/latency_pick=1, "setModePolicy()" selects this mode
+     for interval
+
+   NOTE:
+   - cycle mode behaviour is a model, datasheet has no info, see
+     "../host/AHTxxSimDevice.h", measure real part with
+     "examples/AHTxx_ModeCharacterization" & rerun with its conversion
+     time & cycle period
+   - AHT2x has no modes, not simulated
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "AHTxx.h"
+#include "AHTxxSimDevice.h"
+
+
+#define AHTXX_SIM_SLEEP_CURRENT   0.25   //sensor sleep current, in microamperes
+#define AHTXX_SIM_MIN_SAMPLES     100    //reads per interval
+#define AHTXX_SIM_MIN_DURATION    10000  //min simulated time per interval, in milliseconds
+
+
+struct ModeResult
+{
+  uint32_t reads;
+  uint32_t fresh;
+  uint32_t errors;
+  double   duration;                                           //in seconds
+  double   meanLatency;                                        //in milliseconds
+  double   maxLatency;
+  double   meanCurrent;                                        //in microamperes
+};
+
+
+static const char *modeName(uint8_t mode)
+{
+  switch (mode)
+  {
+    case AHTXX_CYCLE_MODE:   return "cycle";
+    case AHTXX_COMMAND_MODE: return "command";
+    default:                 return "normal";
+  }
+}
+
+static bool setMode(AHTxx &sensor, uint8_t mode)
+{
+  switch (mode)
+  {
+    case AHTXX_CYCLE_MODE:   return sensor.setCycleMode();
+    case AHTXX_COMMAND_MODE: return sensor.setComandMode();
+    default:                 return sensor.setNormalMode();
+  }
+}
+
+
+/**************************************************************************/
+/*
+    One mode & interval on fresh simulated sensor
+*/
+/**************************************************************************/
+static ModeResult runMode(uint8_t mode, uint32_t interval, uint32_t conversionTime, uint32_t cyclePeriod)
+{
+  AHTxxSimDevice device(false);
+  AHTxx          sensor(AHTXX_ADDRESS_X38, AHT10_PART);
+  ModeResult     result = {0, 0, 0, 0, 0, 0, 0};
+
+  device.setConversionTime(conversionTime);
+  device.setCyclePeriod(cyclePeriod);
+
+  Wire.detach();
+  Wire.attach(AHTXX_ADDRESS_X38, &device);
+
+  sensor.begin(AHTXX_I2C_SPEED_100KHZ);
+
+  if (setMode(sensor, mode) != true) result.errors++;
+
+  delay(2 * (cyclePeriod / 1000));                             //first cycle mode data
+
+  AHTxxPart part;
+
+  sensor.getPartInfo(&part);
+
+  uint32_t count = AHTXX_SIM_MIN_SAMPLES;
+
+  if ((uint64_t)count * interval < AHTXX_SIM_MIN_DURATION) count = AHTXX_SIM_MIN_DURATION / interval;
+
+  uint64_t startTime   = hostMicros;
+  uint64_t startActive = device.getActiveTime();
+  uint64_t nextTime    = startTime;
+  uint32_t previous    = AHTXX_RAW_ERROR;
+  double   latencySum  = 0;
+
+  for (uint32_t i = 0; i < count; i++)
+  {
+    if (hostMicros < nextTime) hostMicros = nextTime;          //sleep until next sample
+
+    nextTime += (uint64_t)interval * 1000;
+
+    uint64_t readTime = hostMicros;
+    uint32_t raw      = sensor.readRawTemperature();
+    double   latency  = (hostMicros - readTime) / 1000.0;
+
+    latencySum += latency;
+
+    if (latency > result.maxLatency) result.maxLatency = latency;
+
+    result.reads++;
+
+    if (raw == AHTXX_RAW_ERROR)
+    {
+      result.errors++;
+
+      continue;
+    }
+
+    if (raw != previous) result.fresh++;
+
+    previous = raw;
+  }
+
+  if (hostMicros < nextTime) hostMicros = nextTime;            //last interval
+
+  double duration   = (hostMicros - startTime) / 1000000.0;
+  double activeTime = (device.getActiveTime() - startActive) / 1000000.0;
+
+  result.duration    = duration;
+  result.meanLatency = latencySum / result.reads;
+  result.meanCurrent = (activeTime * part.maxCurrent + (duration - activeTime) * AHTXX_SIM_SLEEP_CURRENT) / duration;
+
+  return result;
+}
+
+/* mode selected by policy, sensor without device only answers AHT2x/AHT1x check */
+static uint8_t policyMode(uint32_t interval, uint8_t policy)
+{
+  AHTxxSimDevice device(false);
+  AHTxx          sensor(AHTXX_ADDRESS_X38, AHT10_PART);
+
+  Wire.detach();
+  Wire.attach(AHTXX_ADDRESS_X38, &device);
+
+  return sensor.setModePolicy(interval, policy);
+}
+
+
+int main(int argc, char **argv)
+{
+  uint32_t conversionTime = (argc >= 2) ? strtoul(argv[1], 0, 10) : AHTXX_SIM_CONVERSION_TIME;
+  uint32_t cyclePeriod    = (argc >= 3) ? strtoul(argv[2], 0, 10) : AHTXX_SIM_CYCLE_PERIOD;
+
+  const uint32_t intervals[] = {50, 100, 250, 1000, 2000, 10000, 60000};
+  const uint8_t  modes[]     = {AHTXX_NORMAL_MODE, AHTXX_CYCLE_MODE, AHTXX_COMMAND_MODE};
+
+  printf("mode,interval_ms,reads,read_rate_hz,fresh_rate_hz,mean_latency_ms,max_latency_ms,mean_current_ua,charge_per_fresh_uc,errors,energy_pick,latency_pick\n");
+
+  for (uint8_t i = 0; i < sizeof(intervals) / sizeof(intervals[0]); i++)
+  {
+    uint8_t energyMode  = policyMode(intervals[i], AHTXX_POLICY_ENERGY);
+    uint8_t latencyMode = policyMode(intervals[i], AHTXX_POLICY_LATENCY);
+
+    for (uint8_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+    {
+      ModeResult result = runMode(modes[m], intervals[i], conversionTime, cyclePeriod);
+
+      double charge = (result.fresh != 0) ? result.meanCurrent * result.duration / result.fresh : 0;
+
+      printf("%s,%u,%u,%.2f,%.2f,%.2f,%.2f,%.2f,%.3f,%u,%u,%u\n", modeName(modes[m]), intervals[i], result.reads,
+             result.reads / result.duration, result.fresh / result.duration, result.meanLatency, result.maxLatency,
+             result.meanCurrent, charge, result.errors, (energyMode == modes[m]) ? 1 : 0, (latencyMode == modes[m]) ? 1 : 0);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,412 @@
+/***************************************************************************************************/
+/*
+   Discrete-event host simulation of many AHTxx sensors on many I2C buses
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Build & run on a Linux/macOS host:
+   - g++ -O2 -std=c++11 -I../host -I../../src AHTxxScaling.cpp ../host/HostArduino.cpp ../host/AHTxxSimDevice.cpp
+       ../../src/AHTxx.cpp ../../src/AHTxxTransport.cpp ../../src/AHTxxTWI.cpp ../../src/AHTxxUncertainty.cpp -o scaling
+   - ./scaling                      full table, CSV to stdout
+   - ./scaling sensors buses [kHz]  one topology, both modes
+
+   Topology:
+   - every bus has up to 8 TCA9548A-like muxes 0x70..0x77, every mux
+     channel has one AHT2x on 0x38, max 64 sensors per bus
+   - mux channel is switched by transport before every transfer, previous
+     mux is switched off first, otherwise sensors on same address collide
+   - buses are independent controllers, each bus is simulated on its own
+     virtual timeline from same start, sweep time is slowest bus
+
+   Modes:
+   - sequential, start & wait every sensor one by one, same I2C traffic
+     as blocking "readTemperature()"
+   - pipelined, "startMeasurementAsync()" all sensors of a bus, then
+     "updateAsync()" round-robin, conversions overlap
+
+   NOTE:
+   - real library code drives simulated sensors, see "../host"
+   - idle poll pass advances time by AHTXX_SIM_POLL_STEP, CPU time of
+     "updateAsync()" itself is not modeled
+   - latency is time from sweep start to sensor data ready
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "AHTxx.h"
+#include "AHTxxSimDevice.h"
+
+
+#define AHTXX_SIM_MUX_ADDRESS     0x70   //first mux address
+#define AHTXX_SIM_MAX_MUXES       8      //muxes per bus, 0x70..0x77
+#define AHTXX_SIM_MUX_CHANNELS    8      //channels per mux
+#define AHTXX_SIM_BUS_SENSORS     (AHTXX_SIM_MAX_MUXES * AHTXX_SIM_MUX_CHANNELS)
+#define AHTXX_SIM_POLL_STEP       100    //idle poll pass, in microseconds
+#define AHTXX_SIM_SWEEPS          4      //sweeps per topology
+#define AHTXX_SIM_TIMEOUT         1000   //sensor timeout, in milliseconds
+
+#define AHTXX_SIM_SEQUENTIAL      0
+#define AHTXX_SIM_PIPELINED       1
+
+
+/* one I2C bus with its muxes & currently enabled channel */
+struct SimBus
+{
+  TwoWire             wire;
+  AHTxxWireTransport  transport;
+  HostMux            *muxes[AHTXX_SIM_MAX_MUXES];
+  uint8_t             muxCount;
+  int8_t              selectedMux;
+  int8_t              selectedChannel;
+
+  SimBus() : transport(wire), muxCount(0), selectedMux(-1), selectedChannel(-1) {}
+};
+
+
+/* transport of one sensor behind mux channel */
+class MuxTransport final : public AHTxxTransport
+{
+  public:
+
+   MuxTransport(SimBus *bus, uint8_t mux, uint8_t channel) : _bus(bus), _mux(mux), _channel(channel) {}
+
+   bool write(uint8_t address, const uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context)
+   {
+     if (_select() != true)
+     {
+       callback(context, AHTXX_ACK_ERROR);
+
+       return true;
+     }
+
+     return _bus->transport.write(address, data, length, callback, context);
+   }
+
+   bool read(uint8_t address, uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context)
+   {
+     if (_select() != true)
+     {
+       callback(context, AHTXX_DATA_ERROR);
+
+       return true;
+     }
+
+     return _bus->transport.read(address, data, length, callback, context);
+   }
+
+
+  private:
+   SimBus  *_bus;
+   uint8_t  _mux;
+   uint8_t  _channel;
+
+   /* skip mux writes if channel is already enabled */
+   bool _select()
+   {
+     if ((_bus->selectedMux == _mux) && (_bus->selectedChannel == _channel)) return true;
+
+     if ((_bus->selectedMux >= 0) && (_bus->selectedMux != _mux))
+     {
+       if (_writeMux(_bus->selectedMux, 0x00) != true) return false;   //previous mux off
+     }
+
+     if (_writeMux(_mux, 1 << _channel) != true) return false;
+
+     _bus->selectedMux     = _mux;
+     _bus->selectedChannel = _channel;
+
+     return true;
+   }
+
+   bool _writeMux(uint8_t mux, uint8_t channels)
+   {
+     _bus->wire.beginTransmission(AHTXX_SIM_MUX_ADDRESS + mux);
+     _bus->wire.write(channels);
+
+     return (_bus->wire.endTransmission(true) == 0);
+   }
+};
+
+
+struct SimSensor
+{
+  AHTxxSimDevice *device;
+  MuxTransport   *transport;
+  AHTxx          *sensor;
+  uint64_t        readyTime;
+};
+
+
+struct SimResult
+{
+  double   sweepTime;         //slowest bus, in milliseconds
+  double   meanLatency;       //in milliseconds
+  double   maxLatency;        //in milliseconds
+  double   utilization;       //busy time / sweep time, all buses
+  uint32_t transactions;      //per sweep, all buses
+  uint32_t errors;            //sensors without valid data
+  uint32_t conflicts;         //address collisions on buses
+};
+
+
+/**************************************************************************/
+/*
+    Topology
+*/
+/**************************************************************************/
+static void buildBus(SimBus *bus, std::vector<SimSensor> &sensors, uint32_t count, uint32_t speed, uint32_t &seed)
+{
+  bus->wire.setClock(speed);
+
+  bus->muxCount = (count + AHTXX_SIM_MUX_CHANNELS - 1) / AHTXX_SIM_MUX_CHANNELS;
+
+  for (uint8_t mux = 0; mux < bus->muxCount; mux++)
+  {
+    bus->muxes[mux] = new HostMux(AHTXX_SIM_MUX_ADDRESS + mux);
+
+    bus->wire.addMux(bus->muxes[mux]);
+  }
+
+  for (uint32_t i = 0; i < count; i++)
+  {
+    SimSensor sim;
+
+    sim.device    = new AHTxxSimDevice(true, seed++);
+    sim.transport = new MuxTransport(bus, i / AHTXX_SIM_MUX_CHANNELS, i % AHTXX_SIM_MUX_CHANNELS);
+    sim.sensor    = new AHTxx(AHTXX_ADDRESS_X38, AHT2x_SENSOR);
+    sim.readyTime = 0;
+
+    bus->muxes[i / AHTXX_SIM_MUX_CHANNELS]->attach(i % AHTXX_SIM_MUX_CHANNELS, AHTXX_ADDRESS_X38, sim.device);
+    sim.sensor->setTransport(sim.transport);
+
+    sensors.push_back(sim);
+  }
+}
+
+static void freeBus(SimBus *bus, std::vector<SimSensor> &sensors)
+{
+  for (size_t i = 0; i < sensors.size(); i++)
+  {
+    delete sensors[i].sensor;
+    delete sensors[i].transport;
+    delete sensors[i].device;
+  }
+
+  for (uint8_t mux = 0; mux < bus->muxCount; mux++) delete bus->muxes[mux];
+}
+
+
+/**************************************************************************/
+/*
+    Sweep drivers, return number of sensors without valid data
+*/
+/**************************************************************************/
+static uint32_t sweepSequential(std::vector<SimSensor> &sensors)
+{
+  uint32_t errors = 0;
+
+  for (size_t i = 0; i < sensors.size(); i++)
+  {
+    AHTxx   *sensor    = sensors[i].sensor;
+    uint32_t startTime = millis();
+
+    sensor->startMeasurementAsync();
+
+    while ((sensor->updateAsync() != AHTXX_ASYNC_READY) && ((millis() - startTime) < AHTXX_SIM_TIMEOUT))
+    {
+      delayMicroseconds(AHTXX_SIM_POLL_STEP);
+    }
+
+    sensors[i].readyTime = hostMicros;
+
+    if ((sensor->updateAsync() != AHTXX_ASYNC_READY) || (sensor->getStatus() != AHTXX_NO_ERROR)) errors++;
+  }
+
+  return errors;
+}
+
+static uint32_t sweepPipelined(std::vector<SimSensor> &sensors)
+{
+  uint32_t errors    = 0;
+  uint32_t startTime = millis();
+  size_t   pending   = sensors.size();
+
+  for (size_t i = 0; i < sensors.size(); i++)
+  {
+    sensors[i].readyTime = 0;
+
+    sensors[i].sensor->startMeasurementAsync();
+  }
+
+  while ((pending > 0) && ((millis() - startTime) < AHTXX_SIM_TIMEOUT))
+  {
+    uint32_t transactions = 0;
+
+    for (size_t i = 0; i < sensors.size(); i++)
+    {
+      if (sensors[i].readyTime != 0) continue;
+
+      uint64_t time = hostMicros;
+
+      if (sensors[i].sensor->updateAsync() == AHTXX_ASYNC_READY)
+      {
+        sensors[i].readyTime = hostMicros;
+
+        pending--;
+      }
+
+      if (hostMicros != time) transactions++;           //bus was used
+    }
+
+    if (transactions == 0) delayMicroseconds(AHTXX_SIM_POLL_STEP);
+  }
+
+  for (size_t i = 0; i < sensors.size(); i++)
+  {
+    if ((sensors[i].readyTime == 0) || (sensors[i].sensor->getStatus() != AHTXX_NO_ERROR)) errors++;
+  }
+
+  return errors;
+}
+
+
+/**************************************************************************/
+/*
+    simulate()
+
+    Run AHTXX_SIM_SWEEPS sweeps of one topology & average them
+*/
+/**************************************************************************/
+static SimResult simulate(uint32_t sensorCount, uint32_t busCount, uint8_t mode, uint32_t speed)
+{
+  std::vector<double> sweepTime(AHTXX_SIM_SWEEPS, 0);
+  double              latencySum   = 0;
+  double              latencyMax   = 0;
+  uint64_t            busyTime     = 0;
+  uint64_t            transactions = 0;
+  uint32_t            errors       = 0;
+  uint32_t            conflicts    = 0;
+  uint32_t            seed         = 1;
+
+  for (uint32_t b = 0; b < busCount; b++)
+  {
+    SimBus                 bus;
+    std::vector<SimSensor> sensors;
+    uint32_t               count = sensorCount / busCount + ((b < (sensorCount % busCount)) ? 1 : 0); //spread evenly
+
+    buildBus(&bus, sensors, count, speed, seed);
+
+    hostMicros = 0;                                     //every bus starts on its own timeline
+
+    for (uint8_t sweep = 0; sweep < AHTXX_SIM_SWEEPS; sweep++)
+    {
+      uint64_t startTime = hostMicros;
+
+      bus.wire.resetStatistics();
+
+      if (mode == AHTXX_SIM_SEQUENTIAL) errors += sweepSequential(sensors);
+      else                              errors += sweepPipelined(sensors);
+
+      double duration = (hostMicros - startTime) / 1000.0;
+
+      if (duration > sweepTime[sweep]) sweepTime[sweep] = duration;
+
+      for (size_t i = 0; i < sensors.size(); i++)
+      {
+        if (sensors[i].readyTime == 0) continue;
+
+        double latency = (sensors[i].readyTime - startTime) / 1000.0;
+
+        latencySum += latency;
+
+        if (latency > latencyMax) latencyMax = latency;
+      }
+
+      busyTime     += bus.wire.getBusyTime();
+      transactions += bus.wire.getTransactions();
+      conflicts    += bus.wire.getConflicts();
+
+      delay(AHTXX_SELF_HEATING_INTERVAL);               //rest between sweeps, same for every mode
+    }
+
+    freeBus(&bus, sensors);
+  }
+
+  SimResult result;
+  double    sweepSum = 0;
+
+  for (uint8_t sweep = 0; sweep < AHTXX_SIM_SWEEPS; sweep++) sweepSum += sweepTime[sweep];
+
+  result.sweepTime    = sweepSum / AHTXX_SIM_SWEEPS;
+  result.meanLatency  = latencySum / ((double)sensorCount * AHTXX_SIM_SWEEPS);
+  result.maxLatency   = latencyMax;
+  result.utilization  = (busyTime / 1000.0) / (sweepSum * busCount);
+  result.transactions = transactions / AHTXX_SIM_SWEEPS;
+  result.errors       = errors;
+  result.conflicts    = conflicts;
+
+  return result;
+}
+
+
+static void printResult(uint32_t sensorCount, uint32_t busCount, uint8_t mode, uint32_t speed)
+{
+  SimResult result = simulate(sensorCount, busCount, mode, speed);
+
+  printf("%u,%u,%u,%s,%.1f,%.4f,%.1f,%.1f,%u,%u,%u\n",
+         sensorCount, busCount, speed / 1000, (mode == AHTXX_SIM_SEQUENTIAL) ? "sequential" : "pipelined",
+         result.sweepTime, result.utilization, result.meanLatency, result.maxLatency,
+         result.transactions, result.errors, result.conflicts);
+}
+
+
+int main(int argc, char **argv)
+{
+  printf("sensors,buses,bus_khz,mode,sweep_ms,bus_utilization,mean_latency_ms,max_latency_ms,transactions,errors,conflicts\n");
+
+  if (argc >= 3)
+  {
+    uint32_t sensorCount = strtoul(argv[1], 0, 10);
+    uint32_t busCount    = strtoul(argv[2], 0, 10);
+    uint32_t speed       = (argc >= 4) ? strtoul(argv[3], 0, 10) * 1000 : 100000;
+
+    if ((busCount == 0) || (sensorCount < busCount) || (sensorCount > busCount * AHTXX_SIM_BUS_SENSORS))
+    {
+      fprintf(stderr, "need 1..%u sensors per bus\n", AHTXX_SIM_BUS_SENSORS);
+
+      return 1;
+    }
+
+    printResult(sensorCount, busCount, AHTXX_SIM_SEQUENTIAL, speed);
+    printResult(sensorCount, busCount, AHTXX_SIM_PIPELINED,  speed);
+
+    return 0;
+  }
+
+  const uint32_t sensorCounts[] = {8, 64, 256, 1024, 4096};
+  const uint32_t busCounts[]    = {1, 4, 16, 64};
+  const uint32_t speeds[]       = {100000, 400000};
+
+  for (uint8_t s = 0; s < sizeof(speeds) / sizeof(speeds[0]); s++)
+  {
+    for (uint8_t n = 0; n < sizeof(sensorCounts) / sizeof(sensorCounts[0]); n++)
+    {
+      for (uint8_t b = 0; b < sizeof(busCounts) / sizeof(busCounts[0]); b++)
+      {
+        if ((sensorCounts[n] < busCounts[b]) || (sensorCounts[n] > busCounts[b] * AHTXX_SIM_BUS_SENSORS)) continue; //topology doesn't fit
+
+        printResult(sensorCounts[n], busCounts[b], AHTXX_SIM_SEQUENTIAL, speeds[s]);
+        printResult(sensorCounts[n], busCounts[b], AHTXX_SIM_PIPELINED,  speeds[s]);
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,617 @@
+/***************************************************************************************************/
+/*
+   Host columnar time-series store of AHTxx raw samples
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Number encoding, zigzag value "z" of signed delta:
+   - '0'                   z = 0, regular period or same value
+   - '10'    + 7 bits      jitter, sensor noise
+   - '110'   + 10 bits
+   - '1110'  + 14 bits
+   - '11110' + 21 bits     any 20-bit delta
+   - '11111' + 64 bits     time gaps
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "AHTxxStore.h"
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+
+
+#define AHTXX_STORE_FILE_HEADER  8    //magic & version
+
+
+static const uint8_t bucketPrefix[] = {0x02, 0x06, 0x0E, 0x1E, 0x1F};   //'10', '110', '1110', '11110', '11111'
+static const uint8_t bucketLength[] = {2,    3,    4,    5,    5};
+static const uint8_t bucketBits[]   = {7,    10,   14,   21,   64};
+
+
+static inline uint64_t zigzag(int64_t value)
+{
+  return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t unzigzag(uint64_t value)
+{
+  return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+
+/**************************************************************************/
+/*
+    Bit stream, MSB first
+*/
+/**************************************************************************/
+static void writeBits(std::vector<uint8_t> &payload, uint8_t &free, uint64_t value, uint8_t count)
+{
+  while (count > 0)
+  {
+    if (free == 0)
+    {
+      payload.push_back(0);
+
+      free = 8;
+    }
+
+    uint8_t length = (count < free) ? count : free;
+    uint8_t chunk  = (value >> (count - length)) & ((1 << length) - 1);
+
+    payload.back() |= chunk << (free - length);
+
+    free  -= length;
+    count -= length;
+  }
+}
+
+static void writeNumber(std::vector<uint8_t> &payload, uint8_t &free, int64_t value)
+{
+  uint64_t number = zigzag(value);
+
+  if (number == 0)
+  {
+    writeBits(payload, free, 0, 1);
+
+    return;
+  }
+
+  uint8_t bucket = 0;
+
+  while ((bucket < 4) && (number >= ((uint64_t)1 << bucketBits[bucket]))) bucket++;
+
+  writeBits(payload, free, bucketPrefix[bucket], bucketLength[bucket]);
+  writeBits(payload, free, number, bucketBits[bucket]);
+}
+
+
+struct BitReader
+{
+  const uint8_t *data;
+  uint64_t       position;                                     //in bits
+
+  uint64_t read(uint8_t count)
+  {
+    uint64_t value = 0;
+
+    while (count > 0)
+    {
+      uint8_t offset = position & 7;
+      uint8_t free   = 8 - offset;
+      uint8_t length = (count < free) ? count : free;
+      uint8_t chunk  = (data[position >> 3] >> (free - length)) & ((1 << length) - 1);
+
+      value     = (value << length) | chunk;
+      position += length;
+      count    -= length;
+    }
+
+    return value;
+  }
+
+  int64_t readNumber()
+  {
+    if (read(1) == 0) return 0;                                //most common, regular period
+
+    uint8_t bucket = 0;
+
+    while ((bucket < 4) && (read(1) == 1)) bucket++;
+
+    return unzigzag(read(bucketBits[bucket]));
+  }
+};
+
+
+
+/**************************************************************************/
+/*
+    AHTxxStoreWriter
+
+    Constructor
+*/
+/**************************************************************************/
+AHTxxStoreWriter::AHTxxStoreWriter()
+{
+  _file        = 0;
+  _sampleCount = 0;
+  _blockCount  = 0;
+  _size        = 0;
+}
+
+AHTxxStoreWriter::~AHTxxStoreWriter()
+{
+  close();
+}
+
+
+/**************************************************************************/
+/*
+    open()
+
+    Open store for append, new file is created
+
+    NOTE:
+    - false=can't open or not a store file
+*/
+/**************************************************************************/
+bool AHTxxStoreWriter::open(const char *path)
+{
+  close();
+
+  _file = fopen(path, "a+b");
+
+  if (_file == 0) return false;
+
+  fseek(_file, 0, SEEK_END);
+
+  long size = ftell(_file);
+
+  if (size == 0)
+  {
+    uint32_t header[2] = {AHTXX_STORE_MAGIC, AHTXX_STORE_VERSION};
+
+    fwrite(header, sizeof(header), 1, _file);
+
+    size = sizeof(header);
+  }
+  else
+  {
+    uint32_t header[2] = {0, 0};
+
+    fseek(_file, 0, SEEK_SET);
+
+    if ((fread(header, sizeof(header), 1, _file) != 1) || (header[0] != AHTXX_STORE_MAGIC) || (header[1] != AHTXX_STORE_VERSION))
+    {
+      fclose(_file);
+
+      _file = 0;
+
+      return false;
+    }
+
+    fseek(_file, 0, SEEK_END);                                 //"a" mode appends anyway
+  }
+
+  _size = size;
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    append()
+
+    Add sample to series
+
+    NOTE:
+    - samples of one series must come in time order, equal time is fine,
+      order against blocks written before "open()" is not checked
+    - false=not a 20-bit value, older than last sample or write error
+*/
+/**************************************************************************/
+bool AHTxxStoreWriter::append(uint32_t series, int64_t time, uint32_t rawHumidity, uint32_t rawTemperature)
+{
+  if ((_file == 0) || (rawHumidity > 0xFFFFF) || (rawTemperature > 0xFFFFF)) return false;         //no reason to continue, not a 20-bit value
+
+  Encoder *&encoder = _encoders[series];
+
+  if (encoder == 0)
+  {
+    encoder = new Encoder();
+
+    encoder->header.count = 0;
+  }
+
+  AHTxxStoreBlock &header = encoder->header;
+
+  if (header.count == 0)
+  {
+    memset(&header, 0, sizeof(header));
+
+    header.magic          = AHTXX_STORE_BLOCK_MAGIC;
+    header.series         = series;
+    header.firstTime      = time;
+    header.minHumidity    = rawHumidity;
+    header.maxHumidity    = rawHumidity;
+    header.minTemperature = rawTemperature;
+    header.maxTemperature = rawTemperature;
+
+    encoder->payload.clear();
+    encoder->bits  = 0;
+    encoder->delta = 0;
+
+    writeBits(encoder->payload, encoder->bits, rawHumidity,    20);   //first sample, time is in header
+    writeBits(encoder->payload, encoder->bits, rawTemperature, 20);
+  }
+  else
+  {
+    if (time < header.lastTime) return false;                  //no reason to continue, out of order
+
+    int64_t delta = time - header.lastTime;
+
+    writeNumber(encoder->payload, encoder->bits, delta - encoder->delta);
+    writeNumber(encoder->payload, encoder->bits, (int64_t)rawHumidity    - encoder->humidity);
+    writeNumber(encoder->payload, encoder->bits, (int64_t)rawTemperature - encoder->temperature);
+
+    encoder->delta = delta;
+
+    header.minHumidity    = std::min(header.minHumidity,    rawHumidity);
+    header.maxHumidity    = std::max(header.maxHumidity,    rawHumidity);
+    header.minTemperature = std::min(header.minTemperature, rawTemperature);
+    header.maxTemperature = std::max(header.maxTemperature, rawTemperature);
+  }
+
+  header.lastTime      = time;
+  encoder->humidity    = rawHumidity;
+  encoder->temperature = rawTemperature;
+
+  header.count++;
+
+  _sampleCount++;
+
+  if (header.count < AHTXX_STORE_BLOCK_SAMPLES) return true;
+
+  return _writeBlock(encoder);
+}
+
+
+/**************************************************************************/
+/*
+    flush()
+
+    Write open blocks of all series
+
+    NOTE:
+    - next samples start new blocks, frequent flush costs compression
+*/
+/**************************************************************************/
+bool AHTxxStoreWriter::flush()
+{
+  if (_file == 0) return false;
+
+  bool success = true;
+
+  for (std::map<uint32_t, Encoder *>::iterator i = _encoders.begin(); i != _encoders.end(); ++i)
+  {
+    if ((i->second->header.count != 0) && (_writeBlock(i->second) != true)) success = false;
+  }
+
+  if (fflush(_file) != 0) success = false;
+
+  return success;
+}
+
+
+/**************************************************************************/
+/*
+    close()
+
+    Flush & close store
+*/
+/**************************************************************************/
+void AHTxxStoreWriter::close()
+{
+  if (_file != 0)
+  {
+    flush();
+
+    fclose(_file);
+
+    _file = 0;
+  }
+
+  for (std::map<uint32_t, Encoder *>::iterator i = _encoders.begin(); i != _encoders.end(); ++i)
+  {
+    delete i->second;
+  }
+
+  _encoders.clear();
+}
+
+
+/**************************************************************************/
+/*
+    getSampleCount(), getBlockCount(), getSize()
+
+    Return samples appended, blocks written & file size in bytes
+*/
+/**************************************************************************/
+uint64_t AHTxxStoreWriter::getSampleCount() const
+{
+  return _sampleCount;
+}
+
+uint64_t AHTxxStoreWriter::getBlockCount() const
+{
+  return _blockCount;
+}
+
+uint64_t AHTxxStoreWriter::getSize() const
+{
+  return _size;
+}
+
+
+bool AHTxxStoreWriter::_writeBlock(Encoder *encoder)
+{
+  AHTxxStoreBlock &header = encoder->header;
+
+  while ((encoder->payload.size() & 7) != 0) encoder->payload.push_back(0);    //next header stays aligned
+
+  header.size = encoder->payload.size();
+
+  bool success = (fwrite(&header, sizeof(header), 1, _file) == 1) &&
+                 (fwrite(&encoder->payload[0], header.size, 1, _file) == 1);
+
+  _size += sizeof(header) + header.size;
+
+  _blockCount++;
+
+  header.count = 0;
+
+  return success;
+}
+
+
+
+/**************************************************************************/
+/*
+    AHTxxStoreReader
+
+    Constructor
+*/
+/**************************************************************************/
+AHTxxStoreReader::AHTxxStoreReader()
+{
+  _data          = 0;
+  _size          = 0;
+  _blockCount    = 0;
+  _scannedBlocks = 0;
+  _skippedBlocks = 0;
+}
+
+AHTxxStoreReader::~AHTxxStoreReader()
+{
+  close();
+}
+
+
+/**************************************************************************/
+/*
+    open()
+
+    Map store file & index block headers
+
+    NOTE:
+    - only headers are touched, ~1 header per 1024 samples
+    - truncated last block of crashed writer is ignored
+    - false=can't open or not a store file
+*/
+/**************************************************************************/
+bool AHTxxStoreReader::open(const char *path)
+{
+  close();
+
+  int fd = ::open(path, O_RDONLY);
+
+  if (fd < 0) return false;
+
+  struct stat status;
+
+  if ((fstat(fd, &status) != 0) || (status.st_size < AHTXX_STORE_FILE_HEADER))
+  {
+    ::close(fd);
+
+    return false;
+  }
+
+  void *data = mmap(0, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+  ::close(fd);                                                 //mapping stays valid
+
+  if (data == MAP_FAILED) return false;
+
+  _data = (const uint8_t *)data;
+  _size = status.st_size;
+
+  const uint32_t *header = (const uint32_t *)_data;
+
+  if ((header[0] != AHTXX_STORE_MAGIC) || (header[1] != AHTXX_STORE_VERSION))
+  {
+    close();
+
+    return false;
+  }
+
+  size_t offset = AHTXX_STORE_FILE_HEADER;
+
+  while ((offset + sizeof(AHTxxStoreBlock)) <= _size)
+  {
+    const AHTxxStoreBlock *block = (const AHTxxStoreBlock *)(_data + offset);
+
+    if ((block->magic != AHTXX_STORE_BLOCK_MAGIC) || ((offset + sizeof(AHTxxStoreBlock) + block->size) > _size)) break;
+
+    _series[block->series].push_back(block);
+
+    _blockCount++;
+
+    offset += sizeof(AHTxxStoreBlock) + block->size;
+  }
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    close()
+
+    Unmap store file
+*/
+/**************************************************************************/
+void AHTxxStoreReader::close()
+{
+  if (_data != 0) munmap((void *)_data, _size);
+
+  _data       = 0;
+  _size       = 0;
+  _blockCount = 0;
+
+  _series.clear();
+}
+
+
+/**************************************************************************/
+/*
+    query()
+
+    Call callback for every matching sample, return number of samples
+
+    NOTE:
+    - series, AHTXX_STORE_ALL_SERIES for every series
+    - field, AHTXX_STORE_FIELD_NONE for time range only, or
+      AHTXX_STORE_FIELD_HUMIDITY/TEMPERATURE with raw value range,
+      e.g. T > 30C is {TEMPERATURE, 419431, 0xFFFFF}
+    - blocks outside time range are found by binary search, blocks
+      with min/max outside value range are skipped by zone map
+    - callback may be 0, count only
+*/
+/**************************************************************************/
+uint64_t AHTxxStoreReader::query(const AHTxxStoreQuery *query, AHTxxStoreCallback callback, void *context)
+{
+  uint64_t count = 0;
+
+  if (query->series != AHTXX_STORE_ALL_SERIES)
+  {
+    std::map<uint32_t, std::vector<const AHTxxStoreBlock *> >::const_iterator found = _series.find(query->series);
+
+    if (found != _series.end()) count = _queryBlocks(found->second, query, callback, context);
+
+    return count;
+  }
+
+  for (std::map<uint32_t, std::vector<const AHTxxStoreBlock *> >::const_iterator i = _series.begin(); i != _series.end(); ++i)
+  {
+    count += _queryBlocks(i->second, query, callback, context);
+  }
+
+  return count;
+}
+
+
+/**************************************************************************/
+/*
+    getBlockCount(), getScannedBlocks(), getSkippedBlocks()
+
+    Return indexed blocks, blocks decoded & blocks skipped by queries
+    since last "resetStatistics()"
+*/
+/**************************************************************************/
+uint64_t AHTxxStoreReader::getBlockCount() const
+{
+  return _blockCount;
+}
+
+uint64_t AHTxxStoreReader::getScannedBlocks() const
+{
+  return _scannedBlocks;
+}
+
+uint64_t AHTxxStoreReader::getSkippedBlocks() const
+{
+  return _skippedBlocks;
+}
+
+void AHTxxStoreReader::resetStatistics()
+{
+  _scannedBlocks = 0;
+  _skippedBlocks = 0;
+}
+
+
+static bool endsBefore(const AHTxxStoreBlock *block, int64_t time)
+{
+  return block->lastTime < time;
+}
+
+uint64_t AHTxxStoreReader::_queryBlocks(const std::vector<const AHTxxStoreBlock *> &blocks, const AHTxxStoreQuery *query, AHTxxStoreCallback callback, void *context)
+{
+  uint64_t count   = 0;
+  uint64_t scanned = 0;
+
+  std::vector<const AHTxxStoreBlock *>::const_iterator i = std::lower_bound(blocks.begin(), blocks.end(), query->from, endsBefore);
+
+  for (; (i != blocks.end()) && ((*i)->firstTime <= query->to); ++i)
+  {
+    const AHTxxStoreBlock *block = *i;
+
+    if ((query->field == AHTXX_STORE_FIELD_HUMIDITY)    && ((block->maxHumidity    < query->minValue) || (block->minHumidity    > query->maxValue))) continue;
+    if ((query->field == AHTXX_STORE_FIELD_TEMPERATURE) && ((block->maxTemperature < query->minValue) || (block->minTemperature > query->maxValue))) continue;
+
+    scanned++;
+
+    BitReader        reader = {(const uint8_t *)(block + 1), 0};
+    AHTxxStoreSample sample;
+    int64_t          delta  = 0;
+
+    sample.time           = block->firstTime;
+    sample.rawHumidity    = reader.read(20);
+    sample.rawTemperature = reader.read(20);
+
+    for (uint16_t j = 0; j < block->count; j++)
+    {
+      if (j != 0)
+      {
+        delta                 += reader.readNumber();
+        sample.time           += delta;
+        sample.rawHumidity    += reader.readNumber();
+        sample.rawTemperature += reader.readNumber();
+      }
+
+      if (sample.time > query->to) break;                     //no reason to continue, rest of block is newer
+      if (sample.time < query->from) continue;
+
+      uint32_t value = (query->field == AHTXX_STORE_FIELD_HUMIDITY) ? sample.rawHumidity : sample.rawTemperature;
+
+      if ((query->field != AHTXX_STORE_FIELD_NONE) && ((value < query->minValue) || (value > query->maxValue))) continue;
+
+      if (callback != 0) callback(context, block->series, &sample);
+
+      count++;
+    }
+  }
+
+  _scannedBlocks += scanned;
+  _skippedBlocks += blocks.size() - scanned;
+
+  return count;
+}
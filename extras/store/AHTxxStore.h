@@ -0,0 +1,160 @@
+/***************************************************************************************************/
+/*
+   Host columnar time-series store of AHTxx raw samples
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Layout:
+   - append-only file, 8 bytes file header, then blocks of up to
+     AHTXX_STORE_BLOCK_SAMPLES samples of one series
+   - series id is any 32-bit key, e.g. "node << 8 | sensor"
+   - block header is zone map, time range & min/max of both raw values,
+     queries skip blocks without reading payload
+   - payload is bit stream, 3 columns interleaved per sample:
+     - time, delta-of-delta in ms, 1 bit for regular period
+     - raw humidity & raw temperature, delta to previous sample, 1 bit
+       for same value
+     - every value is zigzag number in prefix bucket, see "AHTxxStore.cpp"
+   - payload is padded to 8 bytes, block headers stay aligned in mmap
+
+   NOTE:
+   - readers mmap file, blocks written by "flush()" or full blocks are
+     visible after reopen
+   - open blocks live in writer memory until full or "flush()", crash
+     loses only unflushed samples
+   - only 20-bit raw values without errors are stored, decode with
+     RH = raw / 2^20 * 100, T = raw / 2^20 * 200 - 50
+   - little-endian hosts only, same as every Linux gateway
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_STORE_h
+#define AHTXX_STORE_h
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <map>
+#include <vector>
+
+
+#define AHTXX_STORE_MAGIC          0x58544841  //"AHTX" file
+#define AHTXX_STORE_BLOCK_MAGIC    0x42544841  //"AHTB" block
+#define AHTXX_STORE_VERSION        1
+#define AHTXX_STORE_BLOCK_SAMPLES  1024        //samples per block
+#define AHTXX_STORE_ALL_SERIES     0xFFFFFFFF  //query every series
+
+#define AHTXX_STORE_FIELD_NONE         0x00    //time range only
+#define AHTXX_STORE_FIELD_HUMIDITY     0x01
+#define AHTXX_STORE_FIELD_TEMPERATURE  0x02
+
+
+typedef struct
+{
+  int64_t  time;                                  //any epoch, in milliseconds
+  uint32_t rawHumidity;                           //20-bit
+  uint32_t rawTemperature;                        //20-bit
+}
+AHTxxStoreSample;
+
+/* 48 bytes, 8-byte aligned in file */
+typedef struct
+{
+  uint32_t magic;
+  uint32_t series;
+  uint16_t count;
+  uint16_t reserved;
+  uint32_t size;                                  //payload bytes, padding included
+  int64_t  firstTime;
+  int64_t  lastTime;
+  uint32_t minHumidity;
+  uint32_t maxHumidity;
+  uint32_t minTemperature;
+  uint32_t maxTemperature;
+}
+AHTxxStoreBlock;
+
+/* samples of "series" in [from, to] with field value in [minValue, maxValue] */
+typedef struct
+{
+  uint32_t series;
+  int64_t  from;
+  int64_t  to;
+  uint8_t  field;
+  uint32_t minValue;
+  uint32_t maxValue;
+}
+AHTxxStoreQuery;
+
+typedef void (*AHTxxStoreCallback)(void *context, uint32_t series, const AHTxxStoreSample *sample);
+
+
+class AHTxxStoreWriter
+{
+  public:
+
+   AHTxxStoreWriter();
+  ~AHTxxStoreWriter();
+
+   bool     open(const char *path);
+   bool     append(uint32_t series, int64_t time, uint32_t rawHumidity, uint32_t rawTemperature);
+   bool     flush();
+   void     close();
+   uint64_t getSampleCount() const;
+   uint64_t getBlockCount() const;
+   uint64_t getSize() const;
+
+
+  private:
+   struct Encoder
+   {
+     AHTxxStoreBlock      header;
+     std::vector<uint8_t> payload;
+     uint8_t              bits;                   //free bits in last payload byte
+     int64_t              delta;                  //previous time delta
+     uint32_t             humidity;
+     uint32_t             temperature;
+   };
+
+   FILE                          *_file;
+   std::map<uint32_t, Encoder *>  _encoders;
+   uint64_t                       _sampleCount;
+   uint64_t                       _blockCount;
+   uint64_t                       _size;
+
+   bool _writeBlock(Encoder *encoder);
+};
+
+
+class AHTxxStoreReader
+{
+  public:
+
+   AHTxxStoreReader();
+  ~AHTxxStoreReader();
+
+   bool     open(const char *path);
+   void     close();
+   uint64_t query(const AHTxxStoreQuery *query, AHTxxStoreCallback callback, void *context);
+   uint64_t getBlockCount() const;
+   uint64_t getScannedBlocks() const;
+   uint64_t getSkippedBlocks() const;
+   void     resetStatistics();
+
+
+  private:
+   const uint8_t                                              *_data;
+   size_t                                                      _size;
+   std::map<uint32_t, std::vector<const AHTxxStoreBlock *> >   _series;   //blocks of series in time order
+   uint64_t                                                    _blockCount;
+   uint64_t                                                    _scannedBlocks;
+   uint64_t                                                    _skippedBlocks;
+
+   uint64_t _queryBlocks(const std::vector<const AHTxxStoreBlock *> &blocks, const AHTxxStoreQuery *query, AHTxxStoreCallback callback, void *context);
+};
+
+#endif
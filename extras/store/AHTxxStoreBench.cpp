@@ -0,0 +1,205 @@
+/***************************************************************************************************/
+/*
+   Host ingest & query benchmark of AHTxx time-series store
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Build & run on a Linux/macOS host:
+   - g++ -O2 -std=c++11 AHTxxStoreBench.cpp AHTxxStore.cpp -o store_bench
+   - ./store_bench [series] [samples] [path]   default 100 series, 100000 samples each, /tmp/ahtxx.store
+
+   Data:
+   - every series samples each 10sec, 10% of timestamps have +-2msec jitter
+   - daily T/RH sine with sensor noise, rare heat events above 35C
+   - samples arrive interleaved over series, same as gateway ingest
+
+   Metrics, CSV "metric,value":
+   - ingest rate, bytes per sample & compression against 16 bytes raw
+     "AHTxxStoreSample"
+   - full scan, one day of one series & T > 35C over all series, with
+     scanned & skipped blocks, threshold query against full scan
+   - decoded sums & counts are checked against generated data, exit
+     code 1 on mismatch
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+
+#include "AHTxxStore.h"
+
+
+#define BENCH_PERIOD      10000                        //sample period, in milliseconds
+#define BENCH_DAY         86400000LL                   //in milliseconds
+#define BENCH_START       1700000000000LL              //epoch, in milliseconds
+#define BENCH_HOT_RAW     445645                       //35C, (35 + 50) / 200 * 2^20
+
+
+struct Totals
+{
+  uint64_t count;
+  uint64_t sum;
+  uint64_t hot;
+};
+
+
+static uint32_t seed = 1;
+
+static uint32_t random32()
+{
+  seed ^= seed << 13;                                          //xorshift32
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+
+  return seed;
+}
+
+static double seconds(std::chrono::steady_clock::time_point startTime)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+static void addSample(void *context, uint32_t, const AHTxxStoreSample *sample)
+{
+  Totals *totals = (Totals *)context;
+
+  totals->count++;
+  totals->sum += sample->rawHumidity + sample->rawTemperature;
+
+  if (sample->rawTemperature >= BENCH_HOT_RAW) totals->hot++;
+}
+
+
+int main(int argc, char **argv)
+{
+  uint32_t    seriesCount = (argc >= 2) ? atol(argv[1]) : 100;
+  uint32_t    sampleCount = (argc >= 3) ? atol(argv[2]) : 100000;
+  const char *path        = (argc >= 4) ? argv[3]       : "/tmp/ahtxx.store";
+
+  remove(path);
+
+  /* ingest */
+  AHTxxStoreWriter writer;
+  Totals           generated = {0, 0, 0};
+
+  if (writer.open(path) != true)
+  {
+    fprintf(stderr, "can't open %s\n", path);
+
+    return 1;
+  }
+
+  std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+  for (uint32_t i = 0; i < sampleCount; i++)
+  {
+    for (uint32_t series = 0; series < seriesCount; series++)
+    {
+      int64_t time = BENCH_START + (int64_t)i * BENCH_PERIOD + series;
+
+      if ((random32() % 10) == 0) time += (int32_t)(random32() % 5) - 2;
+
+      double phase       = 2 * M_PI * (double)(time % BENCH_DAY) / BENCH_DAY + series;
+      double temperature = 22 + 6 * sin(phase) + (double)(random32() % 100) / 1000;
+      double humidity    = 45 - 15 * sin(phase) + (double)(random32() % 100) / 500;
+
+      if (((i / 2000) % 97) == (series % 97)) temperature += 15;    //heat event, ~5.5 hours
+
+      uint32_t rawHumidity    = humidity / 100 * 0x100000;
+      uint32_t rawTemperature = (temperature + 50) / 200 * 0x100000;
+
+      writer.append(series, time, rawHumidity, rawTemperature);
+
+      generated.count++;
+      generated.sum += rawHumidity + rawTemperature;
+
+      if (rawTemperature >= BENCH_HOT_RAW) generated.hot++;
+    }
+  }
+
+  writer.close();
+
+  double ingestTime = seconds(startTime);
+
+  printf("metric,value\n");
+  printf("samples,%llu\n",                (unsigned long long)generated.count);
+  printf("blocks,%llu\n",                 (unsigned long long)writer.getBlockCount());
+  printf("ingest_samples_per_sec,%.0f\n", generated.count / ingestTime);
+  printf("bytes_per_sample,%.3f\n",       (double)writer.getSize() / generated.count);
+  printf("compression_ratio,%.2f\n",      (double)generated.count * sizeof(AHTxxStoreSample) / writer.getSize());
+
+  /* queries */
+  AHTxxStoreReader reader;
+
+  startTime = std::chrono::steady_clock::now();
+
+  if (reader.open(path) != true)
+  {
+    fprintf(stderr, "can't read %s\n", path);
+
+    return 1;
+  }
+
+  printf("open_ms,%.3f\n", seconds(startTime) * 1000);
+
+  AHTxxStoreQuery all    = {AHTXX_STORE_ALL_SERIES, INT64_MIN, INT64_MAX, AHTXX_STORE_FIELD_NONE, 0, 0};
+  Totals          totals = {0, 0, 0};
+
+  reader.resetStatistics();
+
+  startTime = std::chrono::steady_clock::now();
+
+  reader.query(&all, addSample, &totals);
+
+  double scanTime = seconds(startTime);
+
+  printf("scan_samples_per_sec,%.0f\n", totals.count / scanTime);
+  printf("scan_ms,%.3f\n",              scanTime * 1000);
+
+  bool pass = (totals.count == generated.count) && (totals.sum == generated.sum) && (totals.hot == generated.hot);
+
+  /* one day of one series in the middle */
+  int64_t         middle = BENCH_START + (int64_t)sampleCount * BENCH_PERIOD / 2;
+  AHTxxStoreQuery day    = {seriesCount / 2, middle, middle + BENCH_DAY - 1, AHTXX_STORE_FIELD_NONE, 0, 0};
+  Totals          range  = {0, 0, 0};
+
+  reader.resetStatistics();
+
+  startTime = std::chrono::steady_clock::now();
+
+  reader.query(&day, addSample, &range);
+
+  printf("range_day_us,%.1f\n",         seconds(startTime) * 1000000);
+  printf("range_day_samples,%llu\n",    (unsigned long long)range.count);
+  printf("range_day_scanned_blocks,%llu\n", (unsigned long long)reader.getScannedBlocks());
+
+  /* threshold, zone maps skip blocks without heat event */
+  AHTxxStoreQuery hot     = {AHTXX_STORE_ALL_SERIES, INT64_MIN, INT64_MAX, AHTXX_STORE_FIELD_TEMPERATURE, BENCH_HOT_RAW, 0xFFFFF};
+  Totals          matches = {0, 0, 0};
+
+  reader.resetStatistics();
+
+  startTime = std::chrono::steady_clock::now();
+
+  reader.query(&hot, addSample, &matches);
+
+  double hotTime = seconds(startTime);
+
+  printf("threshold_ms,%.3f\n",              hotTime * 1000);
+  printf("threshold_samples,%llu\n",         (unsigned long long)matches.count);
+  printf("threshold_scanned_blocks,%llu\n",  (unsigned long long)reader.getScannedBlocks());
+  printf("threshold_skipped_blocks,%llu\n",  (unsigned long long)reader.getSkippedBlocks());
+  printf("threshold_speedup,%.1f\n",         scanTime / hotTime);
+
+  pass = pass && (matches.count == generated.hot) && (matches.hot == generated.hot);
+
+  printf("verify,%s\n", (pass == true) ? "pass" : "FAIL");
+
+  return (pass == true) ? 0 : 1;
+}
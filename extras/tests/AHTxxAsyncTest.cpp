@@ -0,0 +1,287 @@
+/***************************************************************************************************/
+/*
+   Host test of AHTxx asynchronous measurement state machine
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Build & run on a Linux/macOS host:
+   - g++ -std=c++11 -I../host -I../../src AHTxxAsyncTest.cpp ../host/AHTxxMockTransport.cpp ../host/HostArduino.cpp
+       ../../src/AHTxx.cpp ../../src/AHTxxTransport.cpp ../../src/AHTxxTWI.cpp ../../src/AHTxxUncertainty.cpp -o async_test
+   - ./async_test                                exit code 1 if any check failed
+   - or "ctest" in CMake build, see "CMakeLists.txt"
+
+   NOTE:
+   - "AHTxxMockTransport" completes one transfer per "updateAsync()",
+     every state from "startMeasurementAsync()" to AHTXX_ASYNC_READY
+     is checked, including queue full, NACK, short read & busy retry
+   - time is virtual, see "Arduino.h"
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <stdio.h>
+
+#include "AHTxx.h"
+#include "AHTxxMockTransport.h"
+
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+
+static uint32_t failures = 0;
+
+
+static void check(bool condition, const char *text, int line)
+{
+  if (condition == true) return;
+
+  printf("  FAIL line %d: %s\n", line, text);
+
+  failures++;
+}
+
+
+static uint16_t measurementDelay(AHTxx &sensor)
+{
+  AHTxxPart info;
+
+  sensor.getPartInfo(&info);
+
+  return info.measurementDelay;
+}
+
+
+/**************************************************************************/
+/*
+    IDLE -> TRIGGER -> CONVERSION -> READ -> RECEIVED -> READY
+*/
+/**************************************************************************/
+static void testStates()
+{
+  printf("states\n");
+
+  AHTxxMockTransport transport;
+  AHTxx              sensor(AHTXX_ADDRESS_X38, AHT2x_SENSOR);
+
+  sensor.setTransport(&transport);
+
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_IDLE);
+  CHECK(sensor.startMeasurementAsync() == true);
+  CHECK(transport.isPending()          == true);
+  CHECK(transport.getAddress()         == AHTXX_ADDRESS_X38);
+  CHECK(transport.getCommand(0)        == AHTXX_START_MEASUREMENT_REG);
+  CHECK(transport.getCommand(1)        == AHTXX_START_MEASUREMENT_CTRL);
+  CHECK(transport.getCommand(2)        == AHTXX_START_MEASUREMENT_CTRL_NOP);
+  CHECK(sensor.startMeasurementAsync() == false);                          //measurement in progress
+
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_CONVERSION);         //write completed
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_CONVERSION);         //conversion not completed
+  CHECK(transport.getReads()           == 0);
+
+  delay(measurementDelay(sensor) - 1);
+
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_CONVERSION);
+
+  delay(1);
+
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_READ);
+  CHECK(transport.getReads()           == 1);
+
+  transport.poll();                                                        //data arrives between "updateAsync()" calls
+
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_READY);              //RECEIVED checked & left in same call
+  CHECK(sensor.getStatus()             == AHTXX_NO_ERROR);
+  CHECK(sensor.readRawHumidity(AHTXX_USE_READ_DATA)    == 0x66666);
+  CHECK(sensor.readRawTemperature(AHTXX_USE_READ_DATA) == 0x5C28F);
+  CHECK(sensor.getTransactionCount()   == 2);
+  CHECK(sensor.getMeasurementCount()   == 1);
+  CHECK(sensor.getErrorCount()         == 0);
+
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_READY);              //stays until next start
+  CHECK(sensor.startMeasurementAsync() == true);
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_CONVERSION);
+}
+
+
+/**************************************************************************/
+/*
+    Synchronous transport, callback before submit returns
+*/
+/**************************************************************************/
+static void testImmediate()
+{
+  printf("immediate\n");
+
+  AHTxxMockTransport transport;
+  AHTxx              sensor(AHTXX_ADDRESS_X38, AHT1x_SENSOR);
+
+  transport.setImmediate(true);
+  sensor.setTransport(&transport);
+
+  CHECK(sensor.startMeasurementAsync() == true);
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_CONVERSION);
+
+  delay(measurementDelay(sensor));
+
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_RECEIVED);           //read completed inside submit
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_READY);
+  CHECK(sensor.getStatus()             == AHTXX_NO_ERROR);
+  CHECK(sensor.readRawHumidity(AHTXX_USE_READ_DATA) == 0x66666);
+}
+
+
+/**************************************************************************/
+/*
+    Queue full on measurement command & on data read
+*/
+/**************************************************************************/
+static void testQueueFull()
+{
+  printf("queue full\n");
+
+  AHTxxMockTransport transport;
+  AHTxx              sensor(AHTXX_ADDRESS_X38, AHT2x_SENSOR);
+
+  sensor.setTransport(&transport);
+  transport.setQueueFull(1);
+
+  CHECK(sensor.startMeasurementAsync() == false);
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_IDLE);               //nothing submitted, nothing counted
+  CHECK(sensor.getTransactionCount()   == 0);
+  CHECK(sensor.startMeasurementAsync() == true);
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_CONVERSION);
+
+  delay(measurementDelay(sensor));
+
+  transport.setQueueFull(2);
+
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_CONVERSION);         //read refused, try again later
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_CONVERSION);
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_READ);
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_READY);
+  CHECK(sensor.getStatus()             == AHTXX_NO_ERROR);
+  CHECK(transport.getRefused()         == 3);
+  CHECK(sensor.getTransactionCount()   == 2);
+  CHECK(sensor.getErrorCount()         == 0);
+}
+
+
+/**************************************************************************/
+/*
+    Sensor didn't return ACK on measurement command
+*/
+/**************************************************************************/
+static void testNack()
+{
+  printf("nack\n");
+
+  AHTxxMockTransport transport;
+  AHTxx              sensor(AHTXX_ADDRESS_X38, AHT2x_SENSOR);
+
+  sensor.setTransport(&transport);
+  transport.setWriteNack(1);
+
+  CHECK(sensor.startMeasurementAsync() == true);
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_READY);              //no conversion, no read
+  CHECK(sensor.getStatus()             == AHTXX_ACK_ERROR);
+  CHECK(transport.getReads()           == 0);
+  CHECK(sensor.getMeasurementCount()   == 1);
+  CHECK(sensor.getErrorCount()         == 1);
+
+  CHECK(sensor.startMeasurementAsync() == true);                           //recovers on next measurement
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_CONVERSION);
+}
+
+
+/**************************************************************************/
+/*
+    Sensor sent less bytes than requested
+*/
+/**************************************************************************/
+static void testShortRead()
+{
+  printf("short read\n");
+
+  AHTxxMockTransport transport;
+  AHTxx              sensor(AHTXX_ADDRESS_X38, AHT2x_SENSOR);
+
+  sensor.setTransport(&transport);
+  transport.setShortRead(1);
+
+  CHECK(sensor.startMeasurementAsync() == true);
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_CONVERSION);
+
+  delay(measurementDelay(sensor));
+
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_READ);
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_READY);
+  CHECK(sensor.getStatus()             == AHTXX_DATA_ERROR);
+  CHECK(sensor.getMeasurementCount()   == 1);
+  CHECK(sensor.getErrorCount()         == 1);
+}
+
+
+/**************************************************************************/
+/*
+    Sensor still busy after measurement delay, read repeated
+*/
+/**************************************************************************/
+static void testBusyRetry()
+{
+  printf("busy retry\n");
+
+  AHTxxMockTransport transport;
+  AHTxx              sensor(AHTXX_ADDRESS_X38, AHT2x_SENSOR);
+
+  sensor.setTransport(&transport);
+  transport.setBusyReads(2);
+
+  CHECK(sensor.startMeasurementAsync() == true);
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_CONVERSION);
+
+  delay(measurementDelay(sensor));
+
+  for (uint8_t retry = 0; retry < 2; retry++)
+  {
+    CHECK(sensor.updateAsync()         == AHTXX_ASYNC_READ);
+    CHECK(sensor.updateAsync()         == AHTXX_ASYNC_CONVERSION);         //busy bit set, read again later
+
+    delay(AHTXX_CMD_DELAY - 1);
+
+    CHECK(sensor.updateAsync()         == AHTXX_ASYNC_CONVERSION);
+
+    delay(1);
+  }
+
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_READ);
+  CHECK(sensor.updateAsync()           == AHTXX_ASYNC_READY);
+  CHECK(sensor.getStatus()             == AHTXX_NO_ERROR);
+  CHECK(transport.getReads()           == 3);
+  CHECK(sensor.getMeasurementCount()   == 1);                              //retries are one measurement
+  CHECK(sensor.getErrorCount()         == 0);
+}
+
+
+int main()
+{
+  testStates();
+  testImmediate();
+  testQueueFull();
+  testNack();
+  testShortRead();
+  testBusyRetry();
+
+  if (failures != 0)
+  {
+    printf("%lu check(s) failed\n", (unsigned long)failures);
+
+    return 1;
+  }
+
+  printf("all checks passed\n");
+
+  return 0;
+}
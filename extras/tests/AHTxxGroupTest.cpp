@@ -0,0 +1,391 @@
+/***************************************************************************************************/
+/*
+   Host unit test of multi-sensor classes against simulated sensors
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Build & run on a Linux/macOS host:
+   - g++ -std=c++11 -I../host -I../../src AHTxxGroupTest.cpp ../host/AHTxxSimDevice.cpp ../host/HostArduino.cpp
+       ../../src/AHTxx.cpp ../../src/AHTxxTransport.cpp ../../src/AHTxxTWI.cpp ../../src/AHTxxUncertainty.cpp
+       ../../src/AHTxxGroup.cpp ../../src/AHTxxFusion.cpp ../../src/AHTxxSnapshot.cpp ../../src/AHTxxSampler.cpp
+       ../../src/AHTxxScheduler.cpp -o group_test
+   - ./group_test                                exit code 1 if any check failed
+   - or "ctest" in CMake build, see "CMakeLists.txt"
+
+   NOTE:
+   - three "AHTxxSimDevice" on one virtual-time "Wire" at different
+     addresses, slow sensor checks group timeout
+   - group, fusion, snapshot, sampler & scheduler
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+
+#include "AHTxxGroup.h"
+#include "AHTxxFusion.h"
+#include "AHTxxSnapshot.h"
+#include "AHTxxSampler.h"
+#include "AHTxxScheduler.h"
+#include "AHTxxSimDevice.h"
+
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+#define SENSORS          3
+
+
+static uint32_t failures = 0;
+
+static uint32_t callbackCount = 0;
+
+
+static void check(bool condition, const char *text, int line)
+{
+  if (condition == true) return;
+
+  printf("  FAIL line %d: %s\n", line, text);
+
+  failures++;
+}
+
+
+static void onMeasurement(uint8_t, AHTxx *sensor)
+{
+  if (sensor->getStatus() == AHTXX_NO_ERROR) callbackCount++;
+}
+
+
+/* simulated sensors, attached & initialized by every test */
+static AHTxxSimDevice devices[SENSORS] = {AHTxxSimDevice(true, 1), AHTxxSimDevice(true, 2), AHTxxSimDevice(true, 3)};
+static AHTxx          sensors[SENSORS] = {AHTxx(0x38, AHT2x_SENSOR), AHTxx(0x39, AHT2x_SENSOR), AHTxx(0x3A, AHT2x_SENSOR)};
+
+
+static void attach()
+{
+  Wire.detach();
+
+  for (uint8_t i = 0; i < SENSORS; i++)
+  {
+    devices[i].setConversionTime(AHTXX_SIM_CONVERSION_TIME);
+    devices[i].setValues(25, 50);
+
+    Wire.attach(0x38 + i, &devices[i]);
+
+    sensors[i].setNormalMode();
+  }
+
+  delay(AHTXX_SELF_HEATING_INTERVAL);
+}
+
+
+/**************************************************************************/
+/*
+    Group start, poll, timeout & pure status getter
+*/
+/**************************************************************************/
+static void testGroup()
+{
+  printf("group\n");
+
+  attach();
+
+  AHTxxGroup group;
+
+  CHECK(group.start()                      == false);                  //no sensors
+  CHECK(group.getStatus(0)                 == AHTXX_ERROR);
+  CHECK(group.getSensor(0)                 == 0);
+
+  for (uint8_t i = 0; i < SENSORS; i++) CHECK(group.addSensor(&sensors[i]) == true);
+
+  CHECK(group.getCount()                   == SENSORS);
+  CHECK(group.getSensor(2)                 == &sensors[2]);
+  CHECK(group.getStatus(0)                 == AHTXX_ERROR);            //no measurement yet
+
+  uint32_t startTime = millis();
+
+  CHECK(group.measure()                    == true);
+  CHECK(millis() - startTime               <  AHTXX_MEASUREMENT_DELAY + 20); //conversions overlap
+  CHECK(group.getSkew()                    >  0);
+  CHECK(group.getStartTime()               -  startTime < 5);           //after all commands, skew only
+
+  for (uint8_t i = 0; i < SENSORS; i++)
+  {
+    CHECK(group.getStatus(i)               == AHTXX_NO_ERROR);
+    CHECK(devices[i].getMeasurements()     >= 1);
+  }
+
+  CHECK(group.getStatus(SENSORS)           == AHTXX_ERROR);            //wrong index
+
+  CHECK(group.start()                      == true);
+  CHECK(group.isActive()                   == true);
+  CHECK(group.start()                      == false);                  //in progress
+  CHECK(group.addSensor(&sensors[0])       == false);
+  CHECK(group.getStatus(0)                 == AHTXX_BUSY_ERROR);
+  CHECK(group.getStatus(0)                 == AHTXX_BUSY_ERROR);       //getter doesn't advance measurement
+
+  while (group.poll() != true) yield();
+
+  CHECK(group.isActive()                   == false);
+  CHECK(group.poll()                       == false);                  //nothing started
+
+  delay(AHTXX_SELF_HEATING_INTERVAL);
+
+  devices[1].setConversionTime(AHTXX_GROUP_TIMEOUT * 1000UL * 2);      //never ready in time
+
+  startTime = millis();
+
+  CHECK(group.measure()                    == true);
+  CHECK(millis() - startTime               >= AHTXX_GROUP_TIMEOUT);
+  CHECK(group.getStatus(0)                 == AHTXX_NO_ERROR);
+  CHECK(group.getStatus(1)                 == AHTXX_BUSY_ERROR);       //timeout
+  CHECK(group.getStatus(2)                 == AHTXX_NO_ERROR);
+
+  delay(AHTXX_GROUP_TIMEOUT * 2);                                      //let slow conversion end
+
+  AHTxxGroup full;
+
+  for (uint8_t i = 0; i < AHTXX_GROUP_MAX_SENSORS; i++) full.addSensor(&sensors[0]);
+
+  CHECK(full.addSensor(&sensors[0])        == false);                  //group is full
+}
+
+
+/**************************************************************************/
+/*
+    Fusion rejects outlier, trust scores & failed sensor
+*/
+/**************************************************************************/
+static void testFusion()
+{
+  printf("fusion\n");
+
+  attach();
+
+  AHTxxFusion fusion;
+
+  CHECK(fusion.getStatus()                 == AHTXX_ERROR);            //no measurement yet
+  CHECK(fusion.getRawHumidity()            == AHTXX_RAW_ERROR);
+
+  for (uint8_t i = 0; i < SENSORS; i++) fusion.addSensor(&sensors[i]);
+
+  devices[0].setValues(25.0, 50.0);
+  devices[1].setValues(25.2, 50.5);
+  devices[2].setValues(40.0, 90.0);                                    //outlier
+
+  CHECK(fusion.update()                    == 2);
+  CHECK(fusion.getStatus()                 == AHTXX_NO_ERROR);
+  CHECK(fusion.getAccepted()               == 2);
+  CHECK(fusion.isAccepted(0)               == true);
+  CHECK(fusion.isAccepted(1)               == true);
+  CHECK(fusion.isAccepted(2)               == false);
+  CHECK(fabs(fusion.getTemperature() - 25.1) < 0.5);
+  CHECK(fabs(fusion.getHumidity()    - 50.2) < 3);
+  CHECK(fusion.getTrust(0)                 >  AHTXX_FUSION_TRUST_DEFAULT);
+  CHECK(fusion.getTrust(2)                 <  AHTXX_FUSION_TRUST_DEFAULT);
+
+  delay(AHTXX_SELF_HEATING_INTERVAL);
+
+  Wire.detach();                                                       //all sensors fail
+
+  CHECK(fusion.update()                    == 0);
+  CHECK(fusion.getStatus()                 == AHTXX_ERROR);
+  CHECK(fusion.getTemperature()            == AHTXX_ERROR);
+
+  attach();
+
+  CHECK(fusion.start()                     == true);
+
+  while (fusion.poll() != true) yield();
+
+  CHECK(fusion.getAccepted()               == SENSORS);                //all agree again
+
+  AHTxxFusion full;
+
+  for (uint8_t i = 0; i < AHTXX_FUSION_MAX_SENSORS; i++) full.addSensor(&sensors[0]);
+
+  CHECK(full.addSensor(&sensors[0])        == false);
+}
+
+
+/**************************************************************************/
+/*
+    Snapshot statuses, values & cycle mode rejection
+*/
+/**************************************************************************/
+static void testSnapshot()
+{
+  printf("snapshot\n");
+
+  attach();
+
+  AHTxxSnapshot snapshot;
+
+  for (uint8_t i = 0; i < SENSORS; i++) CHECK(snapshot.addSensor(&sensors[i]) == true);
+
+  CHECK(snapshot.getStatus(0)              == AHTXX_ERROR);            //no snapshot yet
+
+  devices[2].setValues(30, 60);
+
+  CHECK(snapshot.read()                    == true);
+  CHECK(snapshot.getSkew()                 >  0);
+  CHECK(snapshot.getSkew()                 <  AHTXX_MEASUREMENT_DELAY * 1000UL);
+  CHECK(fabs(snapshot.getTemperature(0) - 25) < 1);
+  CHECK(fabs(snapshot.getTemperature(2) - 30) < 1);
+  CHECK(fabs(snapshot.getHumidity(2)    - 60) < 3);
+  CHECK(snapshot.getTemperature(SENSORS)   == AHTXX_ERROR);
+
+  CHECK(snapshot.trigger()                 == true);
+  CHECK(snapshot.getStatus(0)              == AHTXX_BUSY_ERROR);
+  CHECK(snapshot.getTemperature(0)         == AHTXX_ERROR);
+
+  while (snapshot.poll() != true) yield();
+
+  CHECK(snapshot.getStatus(0)              == AHTXX_NO_ERROR);
+
+  AHTxx         aht1x(0x38, AHT1x_SENSOR);
+  AHTxxSnapshot cycleSnapshot;
+
+  CHECK(cycleSnapshot.addSensor(&aht1x)    == true);
+
+  aht1x.setCycleMode();                                                //switched after "addSensor()"
+
+  CHECK(cycleSnapshot.trigger()            == false);                  //sensor gets no command
+  CHECK(cycleSnapshot.read()               == false);
+
+  AHTxxSnapshot rejected;
+
+  CHECK(rejected.addSensor(&aht1x)         == false);
+
+  sensors[0].setNormalMode();                                          //same device, restore normal mode
+}
+
+
+/**************************************************************************/
+/*
+    Sampler groups & stored samples
+*/
+/**************************************************************************/
+static void testSampler()
+{
+  printf("sampler\n");
+
+  attach();
+
+  AHTxxSampler sampler;
+  AHTxxSample  sample;
+
+  CHECK(sampler.addSensor(&sensors[0], 0)  == true);
+  CHECK(sampler.addSensor(&sensors[1], 1)  == true);
+  CHECK(sampler.addSensor(&sensors[2], 0)  == true);
+  CHECK(sampler.addSensor(&sensors[2], AHTXX_SAMPLER_MAX_GROUPS) == false); //wrong group
+
+  CHECK(sampler.read(0, &sample)           == false);                  //never written
+  CHECK(sampler.sweep(AHTXX_SAMPLER_MAX_GROUPS) == false);
+
+  devices[2].setValues(30, 60);
+
+  CHECK(sampler.sweep(0)                   == true);
+  CHECK(sampler.getSweepCount(0)           == 1);
+  CHECK(sampler.getSweepCount(1)           == 0);
+  CHECK(sampler.getSweepTime(0)            <  AHTXX_MEASUREMENT_DELAY + 20);
+
+  CHECK(sampler.read(0, &sample)           == true);
+  CHECK(sample.status                      == AHTXX_NO_ERROR);
+  CHECK(sample.rawTemperature              <= 0xFFFFF);
+  CHECK(sampler.read(1, &sample)           == false);                  //group 1 not swept
+  CHECK(sampler.read(2, &sample)           == true);                   //global index is order of "addSensor()"
+  CHECK(fabs(sample.rawTemperature / 1048576.0 * 200 - 50 - 30) < 1);
+
+  CHECK(sampler.sweep(1)                   == true);
+  CHECK(sampler.read(1, &sample)           == true);
+  CHECK(sampler.read(3, &sample)           == false);                  //wrong index
+
+  Wire.detach();
+
+  CHECK(sampler.sweep(0)                   == true);
+  CHECK(sampler.read(0, &sample)           == true);
+  CHECK(sample.status                      == AHTXX_ACK_ERROR);
+  CHECK(sample.rawHumidity                 == AHTXX_RAW_ERROR);
+}
+
+
+/**************************************************************************/
+/*
+    Scheduler periods, callback, deadline misses & idle time
+*/
+/**************************************************************************/
+static void testScheduler()
+{
+  printf("scheduler\n");
+
+  attach();
+
+  AHTxxScheduler scheduler(1);                                         //no overlap
+
+  callbackCount = 0;
+
+  CHECK(scheduler.addSensor(&sensors[0], 0) == AHTXX_SCHEDULER_NONE);  //period 0
+  CHECK(scheduler.addSensor(&sensors[0], 3000)      == 0);
+  CHECK(scheduler.addSensor(&sensors[1], 3000, 50)  == 1);             //deadline shorter than conversion, always missed
+  CHECK(scheduler.addSensor(&sensors[2], 3000, 500) == 2);             //served after sensor 1, earliest deadline first
+
+  scheduler.setCallback(onMeasurement);
+  scheduler.begin();
+
+  CHECK(scheduler.getIdleTime()            == 0);                      //all released
+
+  uint32_t startTime = millis();
+
+  while ((millis() - startTime) < 10000)
+  {
+    scheduler.update();
+
+    delay(1);
+  }
+
+  CHECK(scheduler.getSampleCount(0)        >= 3);
+  CHECK(scheduler.getSampleCount(2)        >= 3);
+  CHECK(callbackCount                      == scheduler.getSampleCount(0) + scheduler.getSampleCount(1) + scheduler.getSampleCount(2));
+  CHECK(scheduler.getResponseTime(0)       >= AHTXX_MEASUREMENT_DELAY - 10);
+  CHECK(scheduler.getDeadlineMisses(0)     == 0);
+  CHECK(scheduler.getDeadlineMisses(1)     >  0);
+  CHECK(scheduler.getDeadlineMisses(2)     == 0);
+  CHECK(scheduler.getDeadlineMisses()      == scheduler.getDeadlineMisses(1));
+
+  uint32_t idleTime = scheduler.getIdleTime();
+
+  CHECK(idleTime                           <= 3000);                   //time to next release
+}
+
+
+int main()
+{
+  for (uint8_t i = 0; i < SENSORS; i++)
+  {
+    Wire.attach(0x38 + i, &devices[i]);
+
+    CHECK(sensors[i].begin()               == true);
+  }
+
+  testGroup();
+  testFusion();
+  testSnapshot();
+  testSampler();
+  testScheduler();
+
+  if (failures != 0)
+  {
+    printf("%lu check(s) failed\n", (unsigned long)failures);
+
+    return 1;
+  }
+
+  printf("all checks passed\n");
+
+  return 0;
+}
@@ -0,0 +1,164 @@
+/***************************************************************************************************/
+/*
+   Host test of AHTxx "AHTXX_NO_WIRE" build, blocking functions over "AHTxxTransport"
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Build & run on a Linux/macOS host:
+   - g++ -std=c++11 -DAHTXX_NO_WIRE -I../host -I../../src AHTxxNoWireTest.cpp ../host/AHTxxMockTransport.cpp ../host/HostArduino.cpp
+       ../../src/AHTxx.cpp ../../src/AHTxxTransport.cpp ../../src/AHTxxTWI.cpp ../../src/AHTxxUncertainty.cpp -o nowire_test
+   - ./nowire_test                               exit code 1 if any check failed
+   - or "ctest" in CMake build, see "CMakeLists.txt"
+
+   NOTE:
+   - same build as AVR TWI interrupt mode without "Wire.h", transfers
+     are submitted to transport & polled until callback
+   - "AHTxxMockTransport" stands in for "AHTxxTWITransport"
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <stdio.h>
+
+#include "AHTxx.h"
+#include "AHTxxMockTransport.h"
+
+#if !defined(AHTXX_NO_WIRE)
+#error "build with -DAHTXX_NO_WIRE"
+#endif
+
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+
+static uint32_t failures = 0;
+
+
+static void check(bool condition, const char *text, int line)
+{
+  if (condition == true) return;
+
+  printf("  FAIL line %d: %s\n", line, text);
+
+  failures++;
+}
+
+
+/**************************************************************************/
+/*
+    Initialization & blocking measurement over deferred transport
+*/
+/**************************************************************************/
+static void testBlocking()
+{
+  printf("blocking\n");
+
+  AHTxxMockTransport transport;
+  AHTxx              sensor(transport, AHTXX_ADDRESS_X38, AHT2x_SENSOR);
+
+  CHECK(sensor.begin()          == true);                  //init register write & calibration bit read
+  CHECK(transport.getAddress()  == AHTXX_ADDRESS_X38);
+  CHECK(transport.getWrites()   == 2);                     //init register, status register
+  CHECK(transport.getReads()    == 1);
+  CHECK(transport.isPending()   == false);
+
+  CHECK(sensor.readRawHumidity() == 0x66666);
+  CHECK(sensor.getStatus()       == AHTXX_NO_ERROR);
+  CHECK(transport.getCommand(0)  == AHTXX_START_MEASUREMENT_REG);
+  CHECK(sensor.readRawTemperature(AHTXX_USE_READ_DATA) == 0x5C28F);
+
+  transport.setBusyReads(1);
+
+  CHECK(sensor.readRawHumidity() == 0x66666);              //busy status read, waits for conversion
+  CHECK(sensor.getStatus()       == AHTXX_NO_ERROR);
+
+  transport.setImmediate(true);
+
+  CHECK(sensor.readRawHumidity() == 0x66666);              //callback before submit returns
+  CHECK(sensor.getStatus()       == AHTXX_NO_ERROR);
+  CHECK(sensor.getErrorCount()   == 0);
+}
+
+
+/**************************************************************************/
+/*
+    Transport errors reach "getStatus()"
+*/
+/**************************************************************************/
+static void testErrors()
+{
+  printf("errors\n");
+
+  AHTxxMockTransport transport;
+  AHTxx              sensor(transport, AHTXX_ADDRESS_X38, AHT2x_SENSOR);
+
+  CHECK(sensor.begin()           == true);
+
+  transport.setWriteNack(1);
+
+  CHECK(sensor.readRawHumidity() == AHTXX_RAW_ERROR);
+  CHECK(sensor.getStatus()       == AHTXX_ACK_ERROR);
+
+  transport.setShortRead(1);                               //busy status read
+
+  CHECK(sensor.readRawHumidity() == AHTXX_RAW_ERROR);
+  CHECK(sensor.getStatus()       == AHTXX_DATA_ERROR);
+
+  transport.setQueueFull(3);                               //queue full for a while, submit is repeated
+
+  CHECK(sensor.readRawHumidity() == 0x66666);
+  CHECK(sensor.getStatus()       == AHTXX_NO_ERROR);
+  CHECK(transport.getRefused()   == 3);
+}
+
+
+/**************************************************************************/
+/*
+    Transfer never completes, blocking call gives up
+*/
+/**************************************************************************/
+static void testTimeout()
+{
+  printf("timeout\n");
+
+  AHTxxMockTransport transport;
+  AHTxx              sensor(transport, AHTXX_ADDRESS_X38, AHT2x_SENSOR);
+
+  CHECK(sensor.begin()           == true);
+
+  transport.setStuck(true);
+
+  uint32_t startTime = micros();
+
+  CHECK(sensor.readRawHumidity() == AHTXX_RAW_ERROR);
+  CHECK(sensor.getStatus()       == AHTXX_ACK_ERROR);
+  CHECK((micros() - startTime)   >= AHTXX_I2C_TIMEOUT);
+  CHECK(transport.isPending()    == true);                 //measurement command still queued
+
+  transport.setStuck(false);
+
+  CHECK(sensor.readRawHumidity() == 0x66666);              //stale transfer finished first
+  CHECK(sensor.getStatus()       == AHTXX_NO_ERROR);
+}
+
+
+int main()
+{
+  testBlocking();
+  testErrors();
+  testTimeout();
+
+  if (failures != 0)
+  {
+    printf("%lu check(s) failed\n", (unsigned long)failures);
+
+    return 1;
+  }
+
+  printf("all checks passed\n");
+
+  return 0;
+}
@@ -0,0 +1,316 @@
+/***************************************************************************************************/
+/*
+   Host unit test of packet framing & metrics exposition
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Build & run on a Linux/macOS host:
+   - g++ -std=c++11 -I../host -I../../src AHTxxOutputTest.cpp ../host/AHTxxSimDevice.cpp ../host/HostArduino.cpp
+       ../../src/AHTxx.cpp ../../src/AHTxxTransport.cpp ../../src/AHTxxTWI.cpp ../../src/AHTxxUncertainty.cpp
+       ../../src/AHTxxPacket.cpp ../../src/AHTxxMetrics.cpp -o output_test
+   - ./output_test                               exit code 1 if any check failed
+   - or "ctest" in CMake build, see "CMakeLists.txt"
+
+   NOTE:
+   - CRC-16, COBS, packet encode/parse & stream decoder with lost,
+     corrupted & oversized frames
+   - OpenMetrics text of simulated sensor before & after first
+     measurement, no phantom -50C/0% sample
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "AHTxxPacket.h"
+#include "AHTxxMetrics.h"
+#include "AHTxxSimDevice.h"
+
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+
+static uint32_t failures = 0;
+
+
+static void check(bool condition, const char *text, int line)
+{
+  if (condition == true) return;
+
+  printf("  FAIL line %d: %s\n", line, text);
+
+  failures++;
+}
+
+
+/* return value text of sample line, 0 if line is missing */
+static const char *sampleValue(const char *text, const char *sample)
+{
+  const char *line = strstr(text, sample);
+
+  if (line == 0) return 0;
+
+  return line + strlen(sample);
+}
+
+
+/* feed bytes to decoder, return result of last byte */
+static uint8_t feed(AHTxxPacketDecoder &decoder, const uint8_t *data, uint8_t length)
+{
+  uint8_t result = AHTXX_PACKET_NONE;
+
+  for (uint8_t i = 0; i < length; i++) result = decoder.feed(data[i]);
+
+  return result;
+}
+
+
+/**************************************************************************/
+/*
+    CRC-16 check value & COBS round trip
+*/
+/**************************************************************************/
+static void testCobs()
+{
+  printf("CRC-16 & COBS\n");
+
+  const uint8_t vector[9] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+  CHECK(ahtxxCrc16(vector, sizeof(vector))                == 0x29B1);  //CRC-16/CCITT-FALSE check value
+
+  const uint8_t data[8] = {0x00, 0x11, 0x00, 0x00, 0x22, 0x33, 0x00, 0x44};
+
+  uint8_t encoded[sizeof(data) + 1];
+  uint8_t decoded[sizeof(data)];
+
+  uint8_t size = ahtxxCobsEncode(data, sizeof(data), encoded);
+
+  CHECK(size                                              == sizeof(data) + 1);
+  CHECK(memchr(encoded, 0x00, size)                       == 0);       //no delimiter inside
+  CHECK(ahtxxCobsDecode(encoded, size, decoded)           == sizeof(data));
+  CHECK(memcmp(decoded, data, sizeof(data))               == 0);
+
+  encoded[0] = 0x00;
+
+  CHECK(ahtxxCobsDecode(encoded, size, decoded)           == 0);       //zero code
+
+  encoded[0] = size + 1;
+
+  CHECK(ahtxxCobsDecode(encoded, size, decoded)           == 0);       //block longer than data
+}
+
+
+/**************************************************************************/
+/*
+    Packet encode, decoder results & raw values
+*/
+/**************************************************************************/
+static void testPacket()
+{
+  printf("packet\n");
+
+  AHTxxPacket packet;
+
+  packet.node     = 3;
+  packet.sensor   = 1;
+  packet.sequence = 0x1234;
+  packet.time     = 0x00ABCDEF;
+  packet.status   = AHTXX_NO_ERROR;
+  packet.length   = 7;
+
+  const uint8_t frame[7] = {0x18, 0x66, 0x66, 0x65, 0xC2, 0x8F, 0x00};  //RH 40%, T 26C
+
+  memcpy(packet.frame, frame, sizeof(frame));
+
+  uint8_t buffer[AHTXX_PACKET_MAX_SIZE];
+  uint8_t size = ahtxxPacketEncode(&packet, buffer);
+
+  CHECK(size                                              <= AHTXX_PACKET_MAX_SIZE);
+  CHECK(buffer[size - 1]                                  == 0x00);    //delimiter
+  CHECK(memchr(buffer, 0x00, size - 1)                    == 0);
+
+  AHTxxPacketDecoder decoder;
+
+  CHECK(feed(decoder, buffer, size - 1)                   == AHTXX_PACKET_NONE);
+  CHECK(decoder.feed(0x00)                                == AHTXX_PACKET_OK);
+
+  const AHTxxPacket *result = decoder.getPacket();
+
+  CHECK(result->node                                      == 3);
+  CHECK(result->sensor                                    == 1);
+  CHECK(result->sequence                                  == 0x1234);
+  CHECK(result->time                                      == 0x00ABCDEF);
+  CHECK(result->length                                    == 7);
+  CHECK(memcmp(result->frame, frame, sizeof(frame))       == 0);
+  CHECK(ahtxxPacketRawHumidity(result)                    == 0x66666);
+  CHECK(ahtxxPacketRawTemperature(result)                 == 0x5C28F);
+
+  CHECK(decoder.feed(0x00)                                == AHTXX_PACKET_NONE); //repeated delimiter
+
+  buffer[5] ^= 0x01;                                                   //corrupted byte
+
+  CHECK(feed(decoder, buffer, size)                       == AHTXX_PACKET_CRC_ERROR);
+
+  buffer[5] ^= 0x01;
+
+  CHECK(feed(decoder, &buffer[3], size - 3)               != AHTXX_PACKET_OK);        //lost start of packet
+  CHECK(feed(decoder, buffer, size)                       == AHTXX_PACKET_OK);        //decoder resynchronized
+
+  for (uint8_t i = 0; i < AHTXX_PACKET_MAX_SIZE + 10; i++) decoder.feed(0x55);
+
+  CHECK(decoder.feed(0x00)                                == AHTXX_PACKET_FORMAT_ERROR); //oversized frame
+  CHECK(feed(decoder, buffer, size)                       == AHTXX_PACKET_OK);
+
+  packet.status = AHTXX_ACK_ERROR;                                     //failed measurement, no frame
+  packet.length = 0;
+
+  size = ahtxxPacketEncode(&packet, buffer);
+
+  CHECK(feed(decoder, buffer, size)                       == AHTXX_PACKET_OK);
+  CHECK(decoder.getPacket()->status                       == AHTXX_ACK_ERROR);
+  CHECK(ahtxxPacketRawHumidity(decoder.getPacket())       == AHTXX_RAW_ERROR);
+
+  uint8_t data[AHTXX_PACKET_MAX_DATA];
+
+  data[0] = AHTXX_PACKET_VERSION + 1;                                  //unknown version with valid CRC
+
+  for (uint8_t i = 1; i < AHTXX_PACKET_HEADER_SIZE; i++) data[i] = 0;
+
+  uint16_t crc = ahtxxCrc16(data, AHTXX_PACKET_HEADER_SIZE);
+
+  data[AHTXX_PACKET_HEADER_SIZE]     = crc;
+  data[AHTXX_PACKET_HEADER_SIZE + 1] = crc >> 8;
+
+  CHECK(ahtxxPacketParse(data, AHTXX_PACKET_HEADER_SIZE + 2, &packet) == AHTXX_PACKET_FORMAT_ERROR);
+
+  data[0]  = AHTXX_PACKET_VERSION;
+  data[10] = AHTXX_PACKET_MAX_FRAME + 1;                               //frame longer than packet field
+
+  crc = ahtxxCrc16(data, AHTXX_PACKET_HEADER_SIZE);
+
+  data[AHTXX_PACKET_HEADER_SIZE]     = crc;
+  data[AHTXX_PACKET_HEADER_SIZE + 1] = crc >> 8;
+
+  CHECK(ahtxxPacketParse(data, AHTXX_PACKET_HEADER_SIZE + 2, &packet) == AHTXX_PACKET_FORMAT_ERROR);
+  CHECK(ahtxxPacketParse(data, 5, &packet)                == AHTXX_PACKET_FORMAT_ERROR); //too short
+}
+
+
+/**************************************************************************/
+/*
+    Metrics before & after first measurement, overflow
+*/
+/**************************************************************************/
+static void testMetrics()
+{
+  printf("metrics\n");
+
+  AHTxxSimDevice device(true);
+  AHTxx          sensor(AHTXX_ADDRESS_X38, AHT2x_SENSOR);
+  AHTxxMetrics   metrics;
+
+  Wire.detach();
+  Wire.attach(AHTXX_ADDRESS_X38, &device);
+
+  device.setValues(25, 50);
+
+  CHECK(sensor.begin()                                    == true);
+  CHECK(metrics.addSensor(0, "room")                      == false);
+  CHECK(metrics.addSensor(&sensor, 0)                     == false);
+  CHECK(metrics.addSensor(&sensor, "room")                == true);
+
+  static char text[4096];
+
+  uint16_t length = metrics.render(text, sizeof(text));
+
+  CHECK(length                                            >  0);
+  CHECK(length                                            == strlen(text));
+  CHECK(strstr(text, "# TYPE ahtxx_temperature_celsius gauge\n") != 0);
+  CHECK(strcmp(text + length - 6, "# EOF\n")              == 0);
+
+  const char *value;
+
+  value = sampleValue(text, "ahtxx_up{sensor=\"room\"} ");             //no measurement yet
+
+  CHECK((value != 0) && (value[0] == '0'));
+
+  value = sampleValue(text, "ahtxx_temperature_celsius{sensor=\"room\"} ");
+
+  CHECK((value != 0) && (strncmp(value, "NaN\n", 4) == 0));            //not -50.000
+
+  value = sampleValue(text, "ahtxx_humidity_percent{sensor=\"room\"} ");
+
+  CHECK((value != 0) && (strncmp(value, "NaN\n", 4) == 0));            //not 0.000
+
+  value = sampleValue(text, "ahtxx_measurement_interval_seconds{sensor=\"room\"} ");
+
+  CHECK((value != 0) && (strncmp(value, "NaN\n", 4) == 0));
+
+  CHECK(sensor.readTemperature()                          != AHTXX_ERROR);
+
+  length = metrics.render(text, sizeof(text));
+
+  value = sampleValue(text, "ahtxx_up{sensor=\"room\"} ");
+
+  CHECK((value != 0) && (value[0] == '1'));
+
+  value = sampleValue(text, "ahtxx_temperature_celsius{sensor=\"room\"} ");
+
+  CHECK((value != 0) && (atof(value) > 24) && (atof(value) < 26));
+
+  value = sampleValue(text, "ahtxx_humidity_percent{sensor=\"room\"} ");
+
+  CHECK((value != 0) && (atof(value) > 47) && (atof(value) < 53));
+
+  value = sampleValue(text, "ahtxx_measurements_total{sensor=\"room\"} ");
+
+  CHECK((value != 0) && (atoi(value) == 1));
+
+  value = sampleValue(text, "ahtxx_errors_total{sensor=\"room\"} ");
+
+  CHECK((value != 0) && (atoi(value) == 0));
+
+  value = sampleValue(text, "ahtxx_measurement_latency_seconds_bucket{sensor=\"room\",le=\"+Inf\"} ");
+
+  CHECK((value != 0) && (atoi(value) == 1));                           //cumulative
+
+  value = sampleValue(text, "ahtxx_measurement_latency_seconds_count{sensor=\"room\"} ");
+
+  CHECK((value != 0) && (atoi(value) == 1));
+
+  CHECK(strstr(text, "# HELP ahtxx_errors Failed measurements.\n") != 0);
+
+  CHECK(metrics.render(text, length)                      == 0);       //no room for terminating zero
+  CHECK(text[0]                                           == '\0');
+  CHECK(metrics.render(0, sizeof(text))                   == 0);
+
+  AHTxxMetrics full;
+
+  for (uint8_t i = 0; i < AHTXX_METRICS_MAX_SENSORS; i++) full.addSensor(&sensor, "room");
+
+  CHECK(full.addSensor(&sensor, "room")                   == false);
+}
+
+
+int main()
+{
+  testCobs();
+  testPacket();
+  testMetrics();
+
+  if (failures != 0)
+  {
+    printf("%lu check(s) failed\n", (unsigned long)failures);
+
+    return 1;
+  }
+
+  printf("all checks passed\n");
+
+  return 0;
+}
@@ -0,0 +1,504 @@
+/***************************************************************************************************/
+/*
+   Host unit test of raw data processing classes
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Build & run on a Linux/macOS host:
+   - g++ -std=c++11 -I../../src AHTxxProcessingTest.cpp ../../src/AHTxxHistogram.cpp ../../src/AHTxxFilters.cpp
+       ../../src/AHTxxEventDetector.cpp ../../src/AHTxxInterpolator.cpp ../../src/AHTxxQuantile.cpp -o processing_test
+   - ./processing_test                           exit code 1 if any check failed
+   - or "ctest" in CMake build, see "CMakeLists.txt"
+
+   NOTE:
+   - histogram, lag, EMA & Kalman filters, event detector, interpolator
+     & quantile sketch, all Arduino-free, fed with synthetic 20-bit raw
+     values, no sensor & no "Wire"
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <stdio.h>
+
+#include "AHTxxSample.h"
+#include "AHTxxHistogram.h"
+#include "AHTxxFilters.h"
+#include "AHTxxEventDetector.h"
+#include "AHTxxInterpolator.h"
+#include "AHTxxQuantile.h"
+
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+#define RAW_RH_1         10486    //1%RH in raw units
+#define RAW_T_1          5243     //1C in raw units
+
+
+static uint32_t failures = 0;
+
+static uint8_t  callbackEvent = AHTXX_EVENT_NONE;
+static uint32_t callbackCount = 0;
+
+
+static void check(bool condition, const char *text, int line)
+{
+  if (condition == true) return;
+
+  printf("  FAIL line %d: %s\n", line, text);
+
+  failures++;
+}
+
+
+static void onEvent(uint8_t event, int32_t)
+{
+  callbackEvent = event;
+
+  callbackCount++;
+}
+
+
+/* repeatable +-amplitude noise, same sequence on every host */
+static int32_t noise(uint32_t *seed, int32_t amplitude)
+{
+  *seed = (*seed * 1103515245UL) + 12345;
+
+  return (int32_t)((*seed >> 16) % (2 * amplitude + 1)) - amplitude;
+}
+
+
+/**************************************************************************/
+/*
+    Histogram buckets, weights, saturation, serialize & merge
+*/
+/**************************************************************************/
+static void testHistogram()
+{
+  printf("histogram\n");
+
+  AHTxxHistogram histogram;
+
+  histogram.add(0);
+  histogram.add(0xFFFFF);
+  histogram.add(AHTXX_RAW_ERROR);                                      //ignored
+  histogram.add(0x100000);                                             //not a 20-bit value, ignored
+  histogram.add(1UL << AHTXX_HISTOGRAM_SHIFT, 5);
+
+  CHECK(histogram.getTotal()                              == 7);
+  CHECK(histogram.getCount(0)                             == 1);
+  CHECK(histogram.getCount(1)                             == 5);
+  CHECK(histogram.getCount(AHTXX_HISTOGRAM_BUCKETS - 1)   == 1);
+  CHECK(histogram.getCount(AHTXX_HISTOGRAM_BUCKETS)       == 0);       //out of range
+  CHECK(histogram.getBucketLow(1)                         == (1UL << AHTXX_HISTOGRAM_SHIFT));
+  CHECK(histogram.getBucketHigh(0)                        == (1UL << AHTXX_HISTOGRAM_SHIFT) - 1);
+  CHECK(histogram.getBucketHigh(AHTXX_HISTOGRAM_BUCKETS - 1) == 0xFFFFF);
+
+  uint8_t buffer[AHTXX_HISTOGRAM_SERIALIZED_SIZE];
+
+  CHECK(histogram.serialize(buffer, sizeof(buffer) - 1)   == 0);       //buffer too small
+  CHECK(histogram.serialize(buffer, sizeof(buffer))       == AHTXX_HISTOGRAM_SERIALIZED_SIZE);
+  CHECK(buffer[0]                                         == AHTXX_HISTOGRAM_VERSION);
+
+  AHTxxHistogram copy;
+
+  CHECK(copy.merge(buffer, sizeof(buffer) - 1)            == false);
+  CHECK(copy.merge(buffer, sizeof(buffer))                == true);
+  CHECK(copy.getTotal()                                   == 7);
+  CHECK(copy.getCount(1)                                  == 5);
+
+  buffer[1]++;                                                         //different bucket width
+
+  CHECK(copy.merge(buffer, sizeof(buffer))                == false);
+  CHECK(copy.getTotal()                                   == 7);       //not changed
+
+  copy.merge(histogram);
+
+  CHECK(copy.getTotal()                                   == 14);
+
+  copy.add(0, 0xFFFFFFFF);                                             //saturates
+
+  CHECK(copy.getCount(0)                                  == 0xFFFFFFFF);
+  CHECK(copy.getTotal()                                   == 0xFFFFFFFF);
+
+  copy.clear();
+
+  CHECK(copy.getTotal()                                   == 0);
+}
+
+
+/**************************************************************************/
+/*
+    Lag filter leads rising input, limits correction & restarts on gap
+*/
+/**************************************************************************/
+static void testLagFilter()
+{
+  printf("lag filter\n");
+
+  AHTxxLagFilter filter(AHT2X_HUMIDITY_TIME_CONSTANT, AHTXX_HUMIDITY_MAX_CORRECTION, AHTXX_LAG_FILTER_SMOOTHING);
+
+  uint32_t time  = 1000;
+  uint32_t value = 40UL * RAW_RH_1;
+
+  CHECK(filter.update(value, time)                        == value);   //first sample initializes
+
+  for (uint8_t i = 0; i < 10; i++)                                     //steady input, no correction
+  {
+    time += 2000;
+
+    filter.update(value, time);
+  }
+
+  CHECK(filter.getValue()                                 == value);
+  CHECK(filter.getCorrection()                            == 0);
+
+  for (uint8_t i = 0; i < 10; i++)                                     //ramp 0.1%RH per sec, true value is ahead
+  {
+    time  += 2000;
+    value += RAW_RH_1 / 5;
+
+    filter.update(value, time);
+  }
+
+  CHECK(filter.getValue()                                 >  value);
+  CHECK(filter.getCorrection()                            >  0);
+  CHECK(filter.getCorrection()                            <= (int32_t)AHTXX_HUMIDITY_MAX_CORRECTION);
+
+  uint32_t estimate = filter.getValue();
+
+  CHECK(filter.update(AHTXX_RAW_ERROR, time + 2000)       == estimate); //ignored
+  CHECK(filter.update(value, time)                        == estimate); //duplicate sample
+
+  for (uint8_t i = 0; i < 20; i++)                                     //step, correction is limited
+  {
+    time  += 100;
+    value += 20UL * RAW_RH_1;
+
+    if (value > 0xFFFFF) value = 0xFFFFF;
+
+    filter.update(value, time);
+  }
+
+  CHECK(filter.getCorrection()                            <= (int32_t)AHTXX_HUMIDITY_MAX_CORRECTION);
+  CHECK(filter.getValue()                                 <= 0xFFFFF);
+
+  time += AHTXX_LAG_FILTER_MAX_SAMPLE_GAP + 1;                         //stale, restart
+
+  CHECK(filter.update(50UL * RAW_RH_1, time)              == 50UL * RAW_RH_1);
+  CHECK(filter.getCorrection()                            == 0);
+
+  filter.reset();
+
+  CHECK(filter.getValue()                                 == 0);
+}
+
+
+/**************************************************************************/
+/*
+    EMA filter initialization, step response & raw error
+*/
+/**************************************************************************/
+static void testEmaFilter()
+{
+  printf("EMA filter\n");
+
+  AHTxxEmaFilter filter(3);
+
+  CHECK(filter.update(80000)                              == 80000);   //first sample initializes, no ramp from 0
+  CHECK(filter.update(80000)                              == 80000);
+  CHECK(filter.update(88000)                              == 81000);   //y + (x - y) / 8
+  CHECK(filter.update(AHTXX_RAW_ERROR)                    == 81000);   //ignored
+
+  for (uint8_t i = 0; i < 100; i++) filter.update(88000);
+
+  CHECK((filter.getValue() >= 87990) && (filter.getValue() <= 88000));
+
+  filter.reset();
+
+  CHECK(filter.getValue()                                 == 0);
+  CHECK(filter.update(0xFFFFF)                            == 0xFFFFF); //no 32-bit overflow at max shift & max value
+
+  AHTxxEmaFilter maxFilter(AHTXX_EMA_FILTER_MAX_SHIFT + 5);            //shift is limited
+
+  maxFilter.update(0xFFFFF);
+
+  CHECK(maxFilter.update(0xFFFFF)                         == 0xFFFFF);
+}
+
+
+/**************************************************************************/
+/*
+    Kalman filter converges, gain & variance fall on steady input
+*/
+/**************************************************************************/
+static void testKalmanFilter()
+{
+  printf("Kalman filter\n");
+
+  AHTxxKalmanFilter filter;
+
+  uint32_t seed  = 1;
+  uint32_t value = 50UL * RAW_RH_1;
+
+  CHECK(filter.update(value)                              == value);   //first sample initializes
+  CHECK(filter.getVariance()                              == AHTXX_KALMAN_MEASUREMENT_NOISE);
+
+  filter.update(value + noise(&seed, 250));
+
+  uint16_t firstGain = filter.getGain();
+
+  for (uint8_t i = 0; i < 100; i++) filter.update(value + noise(&seed, 250));
+
+  CHECK(filter.getGain()                                  <  firstGain);
+  CHECK(filter.getVariance()                              <  AHTXX_KALMAN_MEASUREMENT_NOISE);
+  CHECK((filter.getValue() > value - 100) && (filter.getValue() < value + 100)); //noise +-250 is averaged
+
+  uint32_t estimate = filter.getValue();
+
+  CHECK(filter.update(AHTXX_RAW_ERROR)                    == estimate); //ignored
+
+  filter.reset();
+
+  CHECK(filter.getGain()                                  == 0);
+  CHECK(filter.update(0xFFFFF)                            == 0xFFFFF);
+
+  AHTxxKalmanFilter noiseless(AHTXX_KALMAN_PROCESS_NOISE, 0);          //R=0 is replaced, no division by zero
+
+  noiseless.update(1000);
+
+  CHECK(noiseless.update(2000)                            >  1900);    //trusts sample
+}
+
+
+/**************************************************************************/
+/*
+    Event detector ignores noise, fires rise, fall & end
+*/
+/**************************************************************************/
+static void testEventDetector()
+{
+  printf("event detector\n");
+
+  AHTxxEventDetector detector(RAW_RH_1, 2UL * RAW_RH_1, AHTXX_EVENT_DRIFT_HUMIDITY); //1%RH/sec or 2%RH accumulated
+
+  detector.setCallback(onEvent);
+
+  uint32_t seed   = 7;
+  uint32_t time   = 1000;
+  uint32_t value  = 50UL * RAW_RH_1;
+  uint32_t events = 0;
+
+  for (uint16_t i = 0; i < 1000; i++)                                  //sigma ~0.1%RH noise, no drift
+  {
+    time += 2000;
+
+    if (detector.update(value + noise(&seed, 2 * AHTXX_EVENT_DRIFT_HUMIDITY), time) != AHTXX_EVENT_NONE) events++;
+  }
+
+  CHECK(events                                            == 0);
+  CHECK(callbackCount                                     == 0);
+  CHECK(detector.isActive()                               == false);
+  CHECK(detector.getSamplingInterval()                    == AHTXX_EVENT_NORMAL_INTERVAL);
+
+  uint8_t event = AHTXX_EVENT_NONE;
+
+  for (uint8_t i = 0; (i < 5) && (event == AHTXX_EVENT_NONE); i++)    //shower, +2%RH per 2sec
+  {
+    time  += 2000;
+    value += 2UL * RAW_RH_1;
+
+    event  = detector.update(value, time);
+  }
+
+  CHECK(event                                             == AHTXX_EVENT_RISE);
+  CHECK(callbackEvent                                     == AHTXX_EVENT_RISE);
+  CHECK(detector.isActive()                               == true);
+  CHECK(detector.getSlope()                               >  0);
+  CHECK(detector.getSamplingInterval()                    == AHTXX_EVENT_FAST_INTERVAL);
+
+  event = AHTXX_EVENT_NONE;
+
+  for (uint8_t i = 0; (i < 5) && (event == AHTXX_EVENT_NONE); i++)    //window opened, rise turns into fall
+  {
+    time  += 2000;
+    value -= 3UL * RAW_RH_1;
+
+    event  = detector.update(value, time);
+  }
+
+  CHECK(event                                             == AHTXX_EVENT_FALL); //no END in between
+  CHECK(callbackEvent                                     == AHTXX_EVENT_FALL);
+  CHECK(detector.getSlope()                               <  0);
+
+  event = AHTXX_EVENT_NONE;
+
+  for (uint8_t i = 0; (i < 10) && (event == AHTXX_EVENT_NONE); i++)   //steady again
+  {
+    time += 2000;
+
+    event = detector.update(value, time);
+  }
+
+  CHECK(event                                             == AHTXX_EVENT_END);
+  CHECK(callbackCount                                     == 3);
+  CHECK(detector.isActive()                               == false);
+
+  CHECK(detector.update(AHTXX_RAW_ERROR, time + 2000)     == AHTXX_EVENT_NONE);
+
+  time += AHTXX_EVENT_MAX_SAMPLE_GAP + 1;                              //stale, restart without event
+
+  CHECK(detector.update(value + 10UL * RAW_RH_1, time)    == AHTXX_EVENT_NONE);
+
+  detector.setSamplingInterval(60000, 1000);
+
+  CHECK(detector.getSamplingInterval()                    == 60000);
+}
+
+
+/**************************************************************************/
+/*
+    Interpolator real, interpolated & extrapolated estimates
+*/
+/**************************************************************************/
+static void testInterpolator()
+{
+  printf("interpolator\n");
+
+  AHTxxInterpolator linear;
+
+  CHECK(linear.estimate(1000)                             == AHTXX_VALUE_NONE);
+  CHECK(linear.getRawHumidity()                           == AHTXX_RAW_ERROR);
+
+  CHECK(linear.add(1000, 100000, 200000)                  == true);
+  CHECK(linear.add(2000, 200000, 400000)                  == true);
+  CHECK(linear.add(1500, 150000, 300000)                  == false);   //older sample
+  CHECK(linear.add(3000, AHTXX_RAW_ERROR, 400000)         == false);
+  CHECK(linear.getCount()                                 == 2);
+
+  CHECK(linear.estimate(1500)                             == AHTXX_VALUE_INTERPOLATED);
+  CHECK(linear.getRawHumidity()                           == 150000);
+  CHECK(linear.getRawTemperature()                        == 300000);
+
+  CHECK(linear.estimate(2000)                             == AHTXX_VALUE_REAL);
+  CHECK(linear.getRawHumidity()                           == 200000);
+
+  CHECK(linear.estimate(2500)                             == AHTXX_VALUE_EXTRAPOLATED);
+  CHECK(linear.getRawHumidity()                           == 250000);  //last slope
+
+  linear.estimate(2000 + AHTXX_INTERPOLATOR_MAX_EXTRAPOLATION + 5000);
+
+  CHECK(linear.getRawHumidity()                           == 200000 + 100UL * AHTXX_INTERPOLATOR_MAX_EXTRAPOLATION); //slope followed for max time only
+
+  CHECK(linear.estimate(500)                              == AHTXX_VALUE_EXTRAPOLATED);
+  CHECK(linear.getRawHumidity()                           == 100000);  //before oldest, oldest value
+  CHECK(linear.getFlag()                                  == AHTXX_VALUE_EXTRAPOLATED);
+
+  for (uint8_t i = 0; i < AHTXX_INTERPOLATOR_SAMPLES + 2; i++) linear.add(3000 + i * 1000, 200000, 400000);
+
+  CHECK(linear.getCount()                                 == AHTXX_INTERPOLATOR_SAMPLES);
+
+  linear.clear();
+
+  CHECK(linear.getCount()                                 == 0);
+
+  AHTxxInterpolator cubic(AHTXX_INTERPOLATION_CUBIC);                  //monotone data stays monotone
+
+  cubic.add(1000, 100000, 100000);
+  cubic.add(2000, 110000, 100000);
+  cubic.add(3000, 300000, 100000);
+  cubic.add(4000, 310000, 100000);
+
+  uint32_t previous = 100000;
+  bool     monotone = true;
+
+  for (uint32_t time = 1000; time <= 4000; time += 100)
+  {
+    cubic.estimate(time);
+
+    if (cubic.getRawHumidity() < previous) monotone = false;
+    if (cubic.getRawTemperature() != 100000) monotone = false;         //flat stays flat, no overshoot
+
+    previous = cubic.getRawHumidity();
+  }
+
+  CHECK(monotone                                          == true);
+  CHECK(previous                                          == 310000);
+}
+
+
+/**************************************************************************/
+/*
+    Quantile sketch accuracy, exact min & max, serialize & merge
+*/
+/**************************************************************************/
+static void testQuantile()
+{
+  printf("quantile\n");
+
+  AHTxxQuantile sketch;
+
+  CHECK(sketch.getQuantile(0.5)                           == 0xFFFFFFFF); //empty
+  CHECK(sketch.getRank(1000)                              == 0);
+  CHECK(sketch.add(AHTXX_RAW_ERROR)                       == false);
+
+  for (uint32_t i = 1; i <= 10000; i++) sketch.add((i * 7919) % 10000 * 100); //0..999900, shuffled
+
+  CHECK(sketch.getCount()                                 == 10000);
+  CHECK(sketch.getSize()                                  <= AHTXX_QUANTILE_CAPACITY);
+  CHECK(sketch.getQuantile(0.0)                           == 0);
+  CHECK(sketch.getQuantile(1.0)                           == 999900);
+
+  uint32_t median = sketch.getQuantile(0.5);
+
+  CHECK((median > 450000) && (median < 550000));                       //rank error of K=32 sketch is few %
+  CHECK((sketch.getRank(250000) > 0.2) && (sketch.getRank(250000) < 0.3));
+
+  static uint8_t buffer[AHTXX_QUANTILE_SERIALIZED_SIZE];
+
+  uint16_t size = sketch.serialize(buffer, sizeof(buffer));
+
+  CHECK(size                                              >  AHTXX_QUANTILE_HEADER_SIZE);
+  CHECK(buffer[0]                                         == AHTXX_QUANTILE_VERSION);
+
+  AHTxxQuantile copy;
+
+  CHECK(copy.merge(buffer, size - 1)                      == false);   //truncated
+  CHECK(copy.merge(buffer, size)                          == true);
+  CHECK(copy.getCount()                                   == 10000);
+  CHECK(copy.getQuantile(0.5)                             == median);
+
+  CHECK(copy.merge(copy)                                  == false);   //into itself
+  CHECK(copy.merge(sketch)                                == true);
+  CHECK(copy.getCount()                                   == 20000);
+  CHECK(copy.getQuantile(1.0)                             == 999900);
+
+  copy.clear();
+
+  CHECK(copy.getCount()                                   == 0);
+}
+
+
+int main()
+{
+  testHistogram();
+  testLagFilter();
+  testEmaFilter();
+  testKalmanFilter();
+  testEventDetector();
+  testInterpolator();
+  testQuantile();
+
+  if (failures != 0)
+  {
+    printf("%lu check(s) failed\n", (unsigned long)failures);
+
+    return 1;
+  }
+
+  printf("all checks passed\n");
+
+  return 0;
+}
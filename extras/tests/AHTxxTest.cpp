@@ -0,0 +1,416 @@
+/***************************************************************************************************/
+/*
+   Host unit test of AHTxx public methods against simulated sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Build & run on a Linux/macOS host:
+   - g++ -std=c++11 -I../host -I../../src AHTxxTest.cpp ../host/AHTxxSimDevice.cpp ../host/HostArduino.cpp
+       ../../src/AHTxx.cpp ../../src/AHTxxTransport.cpp ../../src/AHTxxTWI.cpp ../../src/AHTxxUncertainty.cpp -o ahtxx_test
+   - ./ahtxx_test                                exit code 1 if any check failed
+   - or "ctest" in CMake build, see "CMakeLists.txt"
+
+   NOTE:
+   - "AHTxxSimDevice" is attached to virtual-time "Wire", blocking &
+     asynchronous measurement run same I2C path as on target
+   - begin, read, modes, async, statistics & part info, state machine
+     failures are in "AHTxxAsyncTest.cpp"
+   - filters & statistics are in "AHTxxProcessingTest.cpp", multi-sensor
+     classes in "AHTxxGroupTest.cpp", packet & metrics in "AHTxxOutputTest.cpp"
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+
+#include "AHTxx.h"
+#include "AHTxxSimDevice.h"
+
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+
+static uint32_t failures = 0;
+
+
+static void check(bool condition, const char *text, int line)
+{
+  if (condition == true) return;
+
+  printf("  FAIL line %d: %s\n", line, text);
+
+  failures++;
+}
+
+
+/* simulated sensor with corrupted CRC8 */
+class BadCrcDevice : public AHTxxSimDevice
+{
+  public:
+
+   uint8_t read(uint8_t *data, uint8_t length)
+   {
+     uint8_t size = AHTxxSimDevice::read(data, length);
+
+     if (length >= 7) data[6] ^= 0xFF;
+
+     return size;
+   }
+};
+
+
+/**************************************************************************/
+/*
+    begin() with & without sensor on bus
+*/
+/**************************************************************************/
+static void testBegin()
+{
+  printf("begin\n");
+
+  AHTxxSimDevice device(true);
+  AHTxx          sensor(AHTXX_ADDRESS_X38, AHT2x_SENSOR);
+
+  Wire.detach();
+
+  CHECK(sensor.begin()                  == false);                     //nothing on bus
+  CHECK(sensor.readRawHumidity()        == AHTXX_RAW_ERROR);
+  CHECK(sensor.getStatus()              == AHTXX_ACK_ERROR);
+
+  Wire.attach(AHTXX_ADDRESS_X38, &device);
+
+  uint64_t startTime = hostMicros;
+
+  CHECK(sensor.begin()                  == true);
+  CHECK(sensor.getMode()                == AHTXX_NORMAL_MODE);
+  CHECK((hostMicros - startTime)        >= (uint64_t)AHT2X_POWER_ON_DELAY * 1000);
+
+  CHECK(sensor.softReset()              == true);
+  CHECK(sensor.getMode()                == AHTXX_NORMAL_MODE);
+}
+
+
+/**************************************************************************/
+/*
+    Blocking read, converted & raw values, frame & CRC8
+*/
+/**************************************************************************/
+static void testRead()
+{
+  printf("read\n");
+
+  AHTxxSimDevice device(true);
+  AHTxx          sensor(AHTXX_ADDRESS_X38, AHT2x_SENSOR);
+
+  Wire.detach();
+  Wire.attach(AHTXX_ADDRESS_X38, &device);
+
+  device.setValues(25, 50);
+
+  CHECK(sensor.begin()                  == true);
+  CHECK(sensor.getStatus()              == AHTXX_NO_DATA_ERROR);       //no measurement yet
+  CHECK(sensor.readRawTemperature(AHTXX_USE_READ_DATA) == AHTXX_RAW_ERROR);
+  CHECK(sensor.readHumidity(AHTXX_USE_READ_DATA)       == AHTXX_ERROR);
+  CHECK(sensor.getTemperatureUncertainty() == AHTXX_ERROR);
+  CHECK(sensor.getHumidityUncertainty()    == AHTXX_ERROR);
+
+  sensor.resetStatistics();
+
+  float temperature = sensor.readTemperature();
+
+  CHECK(sensor.getStatus()              == AHTXX_NO_ERROR);
+  CHECK(fabs(temperature - 25)          <  1);
+  CHECK(fabs(sensor.readHumidity(AHTXX_USE_READ_DATA) - 50) < 3);
+  CHECK(sensor.getTransactionCount()    == 3);                         //command, status, frame
+  CHECK(sensor.getMeasurementCount()    == 1);
+  CHECK(device.getMeasurements()        == 1);                         //no new measurement for previous data
+
+  uint32_t rawHumidity    = sensor.readRawHumidity(AHTXX_USE_READ_DATA);
+  uint32_t rawTemperature = sensor.readRawTemperature(AHTXX_USE_READ_DATA);
+
+  CHECK(rawHumidity                     <= 0xFFFFF);
+  CHECK(rawTemperature                  <= 0xFFFFF);
+  CHECK(fabs(rawTemperature / 1048576.0 * 200 - 50 - temperature) < 0.01);
+
+  uint8_t data[7];
+
+  CHECK(sensor.getRawData(data)         == 7);
+  CHECK((data[0] & AHTXX_STATUS_CTRL_CAL_ON) != 0);
+  CHECK((data[0] & AHTXX_STATUS_CTRL_BUSY)   == 0);
+
+  CHECK(sensor.readRawHumidity()        != AHTXX_RAW_ERROR);          //forced read, new measurement
+  CHECK(device.getMeasurements()        == 2);
+
+  BadCrcDevice badDevice;
+  AHTxx        badSensor(AHTXX_ADDRESS_X38, AHT2x_SENSOR);
+
+  Wire.detach();
+  Wire.attach(AHTXX_ADDRESS_X38, &badDevice);
+
+  CHECK(badSensor.begin()               == true);
+  CHECK(badSensor.readTemperature()     == AHTXX_ERROR);
+  CHECK(badSensor.getStatus()           == AHTXX_CRC8_ERROR);
+  CHECK(badSensor.getErrorCount()       == 1);
+
+  AHTxxSimDevice aht1xDevice(false);
+  AHTxx          aht1xSensor(AHTXX_ADDRESS_X38, AHT1x_SENSOR);
+
+  Wire.detach();
+  Wire.attach(AHTXX_ADDRESS_X38, &aht1xDevice);
+
+  CHECK(aht1xSensor.begin()             == true);
+  CHECK(aht1xSensor.readHumidity()      != AHTXX_ERROR);              //no CRC8 in AHT1x frame
+  CHECK(aht1xSensor.getStatus()         == AHTXX_NO_ERROR);
+  CHECK(aht1xSensor.getRawData(data)    == 6);
+}
+
+
+/**************************************************************************/
+/*
+    Measurement modes & mode policy
+*/
+/**************************************************************************/
+static void testModes()
+{
+  printf("modes\n");
+
+  AHTxxSimDevice device(false);
+  AHTxx          sensor(AHTXX_ADDRESS_X38, AHT10_PART);
+
+  Wire.detach();
+  Wire.attach(AHTXX_ADDRESS_X38, &device);
+
+  CHECK(sensor.begin()                  == true);
+
+  CHECK(sensor.setCycleMode()           == true);
+  CHECK(sensor.getMode()                == AHTXX_CYCLE_MODE);
+
+  delay(AHTXX_CYCLE_PERIOD);                                           //first conversion of cycle
+
+  sensor.resetStatistics();
+
+  CHECK(sensor.readTemperature()        != AHTXX_ERROR);
+  CHECK(sensor.getStatus()              == AHTXX_NO_ERROR);
+  CHECK(sensor.getTransactionCount()    <  3);                         //no measurement command
+  CHECK(sensor.getBlockingTime()        <  (uint32_t)AHTXX_CMD_DELAY * 1000); //no conversion delay
+
+  CHECK(sensor.setComandMode()          == true);
+  CHECK(sensor.getMode()                == AHTXX_COMMAND_MODE);
+  CHECK(sensor.setNormalMode()          == true);
+  CHECK(sensor.getMode()                == AHTXX_NORMAL_MODE);
+
+  CHECK(sensor.setModePolicy(10000, AHTXX_POLICY_ENERGY)  == AHTXX_NORMAL_MODE);
+  CHECK(sensor.setModePolicy(10000, AHTXX_POLICY_LATENCY) == AHTXX_CYCLE_MODE);
+  CHECK(sensor.getMode()                                  == AHTXX_CYCLE_MODE);
+  CHECK(sensor.setModePolicy(50, AHTXX_POLICY_ENERGY)     == AHTXX_CYCLE_MODE); //faster than normal mode measurement
+
+  sensor.setPart(AHT15_PART);
+
+  CHECK(sensor.getMode()                == AHTXX_NORMAL_MODE);             //mode of new part is unknown
+
+  Wire.detach();
+
+  CHECK(sensor.setModePolicy(10000, AHTXX_POLICY_LATENCY) == AHTXX_ERROR);
+  CHECK(sensor.getMode()                                  == AHTXX_NORMAL_MODE);
+
+  AHTxx aht2xSensor(AHTXX_ADDRESS_X38, AHT2x_SENSOR);
+
+  CHECK(aht2xSensor.setModePolicy(50, AHTXX_POLICY_LATENCY) == AHTXX_NORMAL_MODE); //AHT2x has no modes, no I2C
+  CHECK(aht2xSensor.getTransactionCount()                   == 0);
+}
+
+
+/**************************************************************************/
+/*
+    Asynchronous measurement over "Wire" transport
+*/
+/**************************************************************************/
+static void testAsync()
+{
+  printf("async\n");
+
+  AHTxxSimDevice device(true);
+  AHTxx          sensor(AHTXX_ADDRESS_X38, AHT2x_SENSOR);
+
+  Wire.detach();
+  Wire.attach(AHTXX_ADDRESS_X38, &device);
+
+  device.setValues(25, 50);
+
+  CHECK(sensor.begin()                  == true);
+
+  sensor.resetStatistics();
+
+  CHECK(sensor.updateAsync()            == AHTXX_ASYNC_IDLE);
+  CHECK(sensor.startMeasurementAsync()  == true);
+  CHECK(sensor.startMeasurementAsync()  == false);                     //measurement in progress
+
+  uint16_t updates = 0;
+
+  while ((sensor.updateAsync() != AHTXX_ASYNC_READY) && (updates < 1000))
+  {
+    delay(1);
+
+    updates++;
+  }
+
+  CHECK(updates                         <  1000);
+  CHECK(sensor.getStatus()              == AHTXX_NO_ERROR);
+  CHECK(fabs(sensor.readTemperature(AHTXX_USE_READ_DATA) - 25) < 1);
+  CHECK(sensor.getTransactionCount()    == 2);                         //command & frame, no status read
+  CHECK(sensor.getBlockingTime()        == 0);
+  CHECK(sensor.getMeasurementCount()    == 1);
+}
+
+
+/**************************************************************************/
+/*
+    Counters, latency histogram, interval & uncertainty
+*/
+/**************************************************************************/
+static void testStatistics()
+{
+  printf("statistics\n");
+
+  AHTxxSimDevice device(true);
+  AHTxx          sensor(AHTXX_ADDRESS_X38, AHT2x_SENSOR);
+
+  Wire.detach();
+  Wire.attach(AHTXX_ADDRESS_X38, &device);
+
+  CHECK(sensor.begin()                  == true);
+
+  sensor.resetStatistics();
+
+  CHECK(sensor.getMeasurementInterval() == 0xFFFFFFFF);                //less than two measurements
+
+  sensor.readTemperature();
+
+  delay(AHTXX_SELF_HEATING_INTERVAL);
+
+  sensor.readTemperature();
+
+  CHECK(sensor.getMeasurementCount()    == 2);
+  CHECK(sensor.getErrorCount()          == 0);
+  CHECK(sensor.getTransactionCount()    == 6);
+  CHECK(sensor.getBlockingTime()        >= 2UL * AHTXX_MEASUREMENT_DELAY * 1000);
+  CHECK(sensor.getMeasurementInterval() >= AHTXX_SELF_HEATING_INTERVAL);
+  CHECK(sensor.getMeasurementInterval() <  AHTXX_SELF_HEATING_INTERVAL + 200);
+
+  uint32_t latencyCount = 0;
+
+  for (uint8_t bucket = 0; bucket < AHTXX_LATENCY_BUCKETS; bucket++) latencyCount += sensor.getLatencyCount(bucket);
+
+  CHECK(latencyCount                    == 2);
+  CHECK(sensor.getLatencySum()          >= 2UL * AHTXX_MEASUREMENT_DELAY);
+  CHECK(sensor.getLatencyCount(AHTXX_LATENCY_BUCKETS) == 0);           //out of range
+  CHECK(sensor.getLatencyBound(0)       == 85);
+  CHECK(sensor.getLatencyBound(AHTXX_LATENCY_BUCKETS - 1) == AHTXX_LATENCY_INF);
+
+  float temperatureUncertainty = sensor.getTemperatureUncertainty();
+  float humidityUncertainty    = sensor.getHumidityUncertainty();
+
+  CHECK((temperatureUncertainty > 0) && (temperatureUncertainty != AHTXX_ERROR));
+  CHECK((humidityUncertainty    > 0) && (humidityUncertainty    != AHTXX_ERROR));
+
+  hostStuckPulses = 3;                                                 //slave holds SDA low
+
+  CHECK(sensor.readTemperature()        == AHTXX_ERROR);
+  CHECK(sensor.getStatus()              == AHTXX_BUS_ERROR);
+  CHECK(sensor.getBusRecoveryCount()    == 1);
+  CHECK(hostStuckPulses                 == 0);
+  CHECK(sensor.getErrorCount()          == 1);
+  CHECK(sensor.readTemperature()        != AHTXX_ERROR);               //bus released by "clearBus()"
+
+  sensor.resetStatistics();
+
+  CHECK(sensor.getTransactionCount()    == 0);
+  CHECK(sensor.getMeasurementCount()    == 0);
+  CHECK(sensor.getErrorCount()          == 0);
+  CHECK(sensor.getBlockingTime()        == 0);
+  CHECK(sensor.getBusRecoveryCount()    == 0);
+  CHECK(sensor.getLatencySum()          == 0);
+  CHECK(sensor.getLatencyCount(0)       == 0);
+}
+
+
+/**************************************************************************/
+/*
+    Part descriptors, sensor type & measurement control
+*/
+/**************************************************************************/
+static void testPartInfo()
+{
+  printf("part info\n");
+
+  AHTxx     sensor;
+  AHTxxPart info;
+
+  CHECK(sensor.getPart()                == AHT1x_PART);                //default constructor
+
+  sensor.getPartInfo(&info);
+
+  CHECK(info.sensorType                 == AHT1x_SENSOR);
+  CHECK(info.dataSize                   == 6);
+  CHECK(info.crc                        == 0);
+
+  sensor.setPart(AHT10_PART);
+  sensor.getPartInfo(&info);
+
+  CHECK(sensor.getPart()                == AHT10_PART);
+  CHECK(info.powerOnDelay               == AHT1X_POWER_ON_DELAY);
+  CHECK(info.measurementDelay           == AHT10_MEASUREMENT_DELAY);
+
+  sensor.setType(AHT2x_SENSOR);
+  sensor.getPartInfo(&info);
+
+  CHECK(sensor.getPart()                == AHT2x_PART);
+  CHECK(info.sensorType                 == AHT2x_SENSOR);
+  CHECK(info.dataSize                   == 7);
+  CHECK(info.crc                        == 1);
+  CHECK(info.minVoltage                 <  info.maxVoltage);
+
+  sensor.setPart(AM2311B_PART);
+
+  CHECK(sensor.getPart()                == AM2311B_PART);
+
+  sensor.setPart((AHTXX_PART)(AM2311B_PART + 1));
+
+  CHECK(sensor.getPart()                == AHT1x_PART);                //unknown part
+
+  CHECK(sensor.getMeasurementControl()  == AHTXX_START_MEASUREMENT_CTRL);
+
+  sensor.setMeasurementControl(0x30);
+
+  CHECK(sensor.getMeasurementControl()  == 0x30);
+
+  sensor.setMeasurementControl();
+
+  CHECK(sensor.getMeasurementControl()  == AHTXX_START_MEASUREMENT_CTRL);
+}
+
+
+int main()
+{
+  testBegin();
+  testRead();
+  testModes();
+  testAsync();
+  testStatistics();
+  testPartInfo();
+
+  if (failures != 0)
+  {
+    printf("%lu check(s) failed\n", (unsigned long)failures);
+
+    return 1;
+  }
+
+  printf("all checks passed\n");
+
+  return 0;
+}
@@ -45,19 +45,79 @@
 */
 /***************************************************************************************************/
 
+#include <stddef.h>
+
 #include "AHTxx.h"
 
 
+/* part descriptors in flash, index is "AHTXX_PART", {type, init reg, frame size, CRC, power-on delay, measurement delay, min/max mV, max uA}, datasheet typical values, not measured */
+static const AHTxxPart AHTXX_PARTS[] PROGMEM =
+{
+  {AHT1x_SENSOR, AHT1X_INIT_REG, 6, 0, AHT2X_POWER_ON_DELAY, AHTXX_MEASUREMENT_DELAY, 1800, 3600, 320}, //AHT1x, worst case
+  {AHT2x_SENSOR, AHT2X_INIT_REG, 7, 1, AHT2X_POWER_ON_DELAY, AHTXX_MEASUREMENT_DELAY, 2200, 5500, 980}, //AHT2x, worst case
+  {AHT1x_SENSOR, AHT1X_INIT_REG, 6, 0, AHT1X_POWER_ON_DELAY, AHT10_MEASUREMENT_DELAY, 1800, 3600, 320}, //AHT10
+  {AHT1x_SENSOR, AHT1X_INIT_REG, 6, 0, AHT1X_POWER_ON_DELAY, AHT10_MEASUREMENT_DELAY, 1800, 3600, 320}, //AHT15, AHT10 with PTFE filter
+  {AHT2x_SENSOR, AHT2X_INIT_REG, 7, 1, AHT2X_POWER_ON_DELAY, AHTXX_MEASUREMENT_DELAY, 2200, 5500, 980}, //AHT20
+  {AHT2x_SENSOR, AHT2X_INIT_REG, 7, 1, AHT2X_POWER_ON_DELAY, AHTXX_MEASUREMENT_DELAY, 2200, 5500, 980}, //AHT21
+  {AHT2x_SENSOR, AHT2X_INIT_REG, 7, 1, AHT2X_POWER_ON_DELAY, AHTXX_MEASUREMENT_DELAY, 2200, 5500, 980}, //AHT25
+  {AHT2x_SENSOR, AHT2X_INIT_REG, 7, 1, AHT2X_POWER_ON_DELAY, AHTXX_MEASUREMENT_DELAY, 2200, 5500, 980}, //AM2301B, AHT2x in wired housing
+  {AHT2x_SENSOR, AHT2X_INIT_REG, 7, 1, AHT2X_POWER_ON_DELAY, AHTXX_MEASUREMENT_DELAY, 2200, 5500, 980}  //AM2311B, AHT2x in wired housing
+};
+
+
 /**************************************************************************/
 /*
     Constructor
+
+    NOTE:
+    - wire, I2C bus of sensor, "Wire" by default, use "Wire1" etc for
+      sensors on second bus
+    - transport, I2C bus of sensor in "AHTXX_NO_WIRE" build, e.g.
+      "AHTxxTWITransport", used by blocking & asynchronous functions
+    - part, exact part number "AHT10_PART", "AM2301B_PART" etc, selects
+      fastest safe timings of part, see "setPart()"
 */
 /**************************************************************************/
-AHTxx::AHTxx(uint8_t address, AHTXX_I2C_SENSOR sensorType)
+#if defined(AHTXX_NO_WIRE)
+AHTxx::AHTxx(AHTxxTransport &transport, uint8_t address, AHTXX_I2C_SENSOR sensorType) : AHTxx(transport, address, (AHTXX_PART)sensorType)
+{
+}
+
+AHTxx::AHTxx(AHTxxTransport &transport, uint8_t address, AHTXX_PART part)
+{
+  _transport      = &transport;
+  _transferDone   = true;
+  _transferResult = AHTXX_NO_ERROR;
+#else
+AHTxx::AHTxx(uint8_t address, AHTXX_I2C_SENSOR sensorType, TwoWire &wire) : AHTxx(address, (AHTXX_PART)sensorType, wire)
+{
+}
+
+AHTxx::AHTxx(uint8_t address, AHTXX_PART part, TwoWire &wire) : _wireTransport(wire)
 {
+  _wire      = &wire;
+  _transport = &_wireTransport;
+#endif
   _address    = address;
-  _sensorType = sensorType;
-  _status     = AHTXX_NO_ERROR;
+  _status     = AHTXX_NO_DATA_ERROR;                                 //"_rawData[]" is empty until first measurement
+
+  setPart(part);
+
+  _mode            = AHTXX_NORMAL_MODE;
+  _measurementCtrl = AHTXX_START_MEASUREMENT_CTRL;
+  _sda             = SDA;
+  _scl             = SCL;
+  _speed           = AHTXX_I2C_SPEED_100KHZ;
+  _asyncState      = AHTXX_ASYNC_IDLE;
+  _asyncResult     = AHTXX_NO_ERROR;
+  _asyncTime       = 0;
+  _asyncDelay      = 0;
+  _asyncStart      = 0;
+
+  _measurementTime     = 0;
+  _measurementInterval = 0xFFFFFFFF;
+
+  resetStatistics();
 }
 
 /**************************************************************************/
@@ -75,27 +135,23 @@ AHTxx::AHTxx(uint8_t address, AHTXX_I2C_SENSOR sensorType)
       - 2 received NACK on transmit of address
       - 3 received NACK on transmit of data
       - 4 other error
+      - 5 timeout, AVR with "WIRE_HAS_TIMEOUT" only
 */
 /**************************************************************************/
 #if defined(ESP8266) || defined(ESP32) || defined(STM32F4xx)
 bool AHTxx::begin(uint8_t sda, uint8_t scl, uint32_t speed)
 {
-  Wire.begin(sda, scl);
-
-  Wire.setClock(speed);            //experimental! ESP8266 I2C bus speed: 1kHz..400kHz, default 100000Hz
-
-  #if defined(ESP8266)
-  Wire.setClockStretchLimit(1000); //experimental! default 230usec
-  #endif
+  _sda = sda;
+  _scl = scl;
 #else
-bool AHTxx::begin(speed) 
+bool AHTxx::begin(uint32_t speed)
 {
-  Wire.begin();
-
-  Wire.setClock(speed);            //experimental! AVR I2C bus speed: 31kHz..400kHz, default 100000Hz
 #endif
+  _speed = speed;
 
-  delay(AHT2X_POWER_ON_DELAY);    //wait for sensor to initialize
+  _beginWire();
+
+  delay(_getPartValue(offsetof(AHTxxPart, powerOnDelay))); //wait for sensor to initialize
 
   return ((setNormalMode() == true) && (_getCalibration() == AHTXX_STATUS_CTRL_CAL_ON)); //set mode & check calibration bit
 }
@@ -125,16 +181,11 @@ bool AHTxx::begin(speed)
     - maximum operating rage T -40C..+80C, RH 0%..100%
 */
 /**************************************************************************/
-float AHTxx::readHumidity(bool readI2C)
+float AHTxx::readHumidity(bool readAHT)
 {
-  if (readI2C == AHTXX_FORCE_READ_DATA) _readMeasurement(); //force to read data via I2C & update "_rawData[]" buffer
-  if (_status != AHTXX_NO_ERROR)        return AHTXX_ERROR; //no reason to continue, call "getStatus()" for error description
+  uint32_t humidity = readRawHumidity(readAHT);
 
-  uint32_t humidity   = _rawData[1];                        //20-bit raw humidity data
-           humidity <<= 8;
-           humidity  |= _rawData[2];
-           humidity <<= 4;
-           humidity  |= _rawData[3] >> 4;
+  if (humidity == AHTXX_RAW_ERROR) return AHTXX_ERROR;      //no reason to continue, call "getStatus()" for error description
 
   return ((float)humidity / 0x100000) * 100;                //TODO: H<0 && H<100 check
 }
@@ -161,16 +212,81 @@ float AHTxx::readHumidity(bool readI2C)
 /**************************************************************************/
 float AHTxx::readTemperature(bool readAHT)
 {
-  if (readAHT == AHTXX_FORCE_READ_DATA) _readMeasurement(); //force to read data via I2C & update "_rawData[]" buffer
-  if (_status != AHTXX_NO_ERROR)        return AHTXX_ERROR; //no reason to continue, call "getStatus()" for error description
+  uint32_t temperature = readRawTemperature(readAHT);
+
+  if (temperature == AHTXX_RAW_ERROR) return AHTXX_ERROR;   //no reason to continue, call "getStatus()" for error description
+
+  return ((float)temperature / 0x100000) * 200 - 50;
+}
+
+
+/**************************************************************************/
+/*
+    readRawHumidity()
+
+    Read 20-bit raw relative humidity
+
+    NOTE:
+    - RH = (raw / 2^20) * 100%
+    - integer value, suitable for histograms & filters without float math
+    - returns AHTXX_RAW_ERROR if error occurs, call "getStatus()"
+      for error description
+*/
+/**************************************************************************/
+uint32_t AHTxx::readRawHumidity(bool readAHT)
+{
+  if (readAHT == AHTXX_FORCE_READ_DATA)                         //force to read data via I2C & update "_rawData[]" buffer
+  {
+    uint32_t startTime = micros();
+
+    _readMeasurement();
+    _countMeasurement(startTime);
+  }
+
+  if (_status != AHTXX_NO_ERROR) return AHTXX_RAW_ERROR;        //no reason to continue, call "getStatus()" for error description
+
+  uint32_t humidity   = _rawData[1];                            //20-bit raw humidity data
+           humidity <<= 8;
+           humidity  |= _rawData[2];
+           humidity <<= 4;
+           humidity  |= _rawData[3] >> 4;
+
+  return humidity;
+}
+
+
+/**************************************************************************/
+/*
+    readRawTemperature()
+
+    Read 20-bit raw temperature
+
+    NOTE:
+    - T = (raw / 2^20) * 200 - 50C
+    - integer value, suitable for histograms & filters without float math
+    - returns AHTXX_RAW_ERROR if error occurs, call "getStatus()"
+      for error description
+*/
+/**************************************************************************/
+uint32_t AHTxx::readRawTemperature(bool readAHT)
+{
+  if (readAHT == AHTXX_FORCE_READ_DATA)                         //force to read data via I2C & update "_rawData[]" buffer
+  {
+    uint32_t startTime = micros();
+
+    _readMeasurement();
+    _countMeasurement(startTime);
+  }
+
+  if (_status != AHTXX_NO_ERROR) return AHTXX_RAW_ERROR;        //no reason to continue, call "getStatus()" for error description
 
-  uint32_t temperature   = _rawData[3] & 0x0F;              //20-bit raw temperature data
+  uint32_t temperature   = _rawData[3] & 0x0F;                  //20-bit raw temperature data
            temperature <<= 8;
            temperature  |= _rawData[4];
            temperature <<= 8;
            temperature  |= _rawData[5];
 
-  return ((float)temperature / 0x100000) * 200 - 50;
+  return temperature;
 }
 
 
@@ -187,7 +303,11 @@ float AHTxx::readTemperature(bool readAHT)
 /**************************************************************************/
 bool AHTxx::setNormalMode()
 {
-  return _setInitializationRegister(AHTXX_INIT_CTRL_CAL_ON | AHT1X_INIT_CTRL_NORMAL_MODE);
+  if (_setInitializationRegister(AHTXX_INIT_CTRL_CAL_ON | AHT1X_INIT_CTRL_NORMAL_MODE) != true) return false; //no reason to continue
+
+  _mode = AHTXX_NORMAL_MODE;
+
+  return true;
 }
 
 
@@ -199,12 +319,20 @@ bool AHTxx::setNormalMode()
 
     NOTE:
     - no info in datasheet, suspect this is continuous measurement
+    - "read...(AHTXX_FORCE_READ_DATA)" & "startMeasurementAsync()" read
+      latest data without measurement command & conversion delay, data
+      is up to AHTXX_CYCLE_PERIOD old
+    - sensor never sleeps, see "setModePolicy()"
     - true=success, false=I2C error
 */
 /**************************************************************************/
 bool AHTxx::setCycleMode()
 {
-  return _setInitializationRegister(AHTXX_INIT_CTRL_CAL_ON | AHT1X_INIT_CTRL_CYCLE_MODE);
+  if (_setInitializationRegister(AHTXX_INIT_CTRL_CAL_ON | AHT1X_INIT_CTRL_CYCLE_MODE) != true) return false; //no reason to continue
+
+  _mode = AHTXX_CYCLE_MODE;
+
+  return true;
 }
 
 
@@ -215,289 +343,1225 @@ bool AHTxx::setCycleMode()
     Set command measurement mode
 
     NOTE:
-    - no info in datasheet
+    - no info in datasheet, assumed to measure on command same as
+      normal mode, unverified, check real parts with
+      "examples/AHTxx_ModeCharacterization"
     - true=success, false=I2C error
 */
 /**************************************************************************/
 bool AHTxx::setComandMode()
 {
-  return _setInitializationRegister(AHTXX_INIT_CTRL_CAL_ON | AHT1X_INIT_CTRL_CMD_MODE);
+  if (_setInitializationRegister(AHTXX_INIT_CTRL_CAL_ON | AHT1X_INIT_CTRL_CMD_MODE) != true) return false; //no reason to continue
+
+  _mode = AHTXX_COMMAND_MODE;
+
+  return true;
 }
 
 
 /**************************************************************************/
 /*
-    softReset()  
+    getMode()  
  
-    Restart sensor, without power off
+    Return measurement mode
 
     NOTE:
-    - takes 20ms
-    - all registers set to default
+    - AHTXX_NORMAL_MODE, AHTXX_CYCLE_MODE or AHTXX_COMMAND_MODE, last
+      mode successfully set by this driver
 */
 /**************************************************************************/
-bool AHTxx::softReset()
+uint8_t AHTxx::getMode()
 {
-  Wire.beginTransmission(_address);
-
-  Wire.write(AHTXX_SOFT_RESET_REG);
-
-  if (Wire.endTransmission(true) != 0) return false; //collision on I2C bus, sensor didn't return ACK
-
-  delay(AHTXX_SOFT_RESET_DELAY);
-
-  return ((setNormalMode() == true) && (_getCalibration() == AHTXX_STATUS_CTRL_CAL_ON)); //set mode & check calibration bit
+  return _mode;
 }
 
 
 /**************************************************************************/
 /*
-    getStatus()  
+    setModePolicy()  
  
-    Return sensor status
+    Select & set measurement mode for sample interval & policy, return
+    selected mode
 
     NOTE:
-    - returned statuse:
-      - AHTXX_NO_ERROR   = 0x00, success, no errors
-      - AHTXX_BUSY_ERROR = 0x01, sensor is busy
-      - AHTXX_ACK_ERROR  = 0x02, sensor didn't return ACK
-      - AHTXX_DATA_ERROR = 0x03, received data smaller than expected
-      - AHTXX_CRC8_ERROR = 0x04, computed CRC8 not match received CRC8, for AHT2x only
+    - interval, time between reads, in milliseconds
+    - AHTXX_POLICY_ENERGY:
+      - normal mode, one conversion per sample at measurement current,
+        sleep between samples
+      - cycle mode only if interval is shorter than normal mode
+        measurement (conversion + AHTXX_CMD_DELAY), sensor can't keep
+        up & cycle mode converts anyway
+    - AHTXX_POLICY_LATENCY:
+      - cycle mode, read takes one I2C transfer instead of ~80msec
+        conversion, costs continuous conversion current, data is up
+        to AHTXX_CYCLE_PERIOD old
+    - command mode is never selected, assumed to have no advantage over
+      normal mode, unverified, see "examples/AHTxx_ModeCharacterization"
+    - AHT2x has no modes, always AHTXX_NORMAL_MODE without I2C
+    - based on "extras/simulator/AHTxxModes.cpp" model, check real parts
+      with "examples/AHTxx_ModeCharacterization"
+    - returns AHTXX_ERROR on I2C error, mode is unchanged
 */
 /**************************************************************************/
-uint8_t AHTxx::getStatus()
+uint8_t AHTxx::setModePolicy(uint32_t interval, uint8_t policy)
 {
-  return _status;
+  if (_getPartValue(offsetof(AHTxxPart, sensorType)) != AHT1x_SENSOR) return AHTXX_NORMAL_MODE; //no reason to continue
+
+  uint32_t normalTime = _getPartValue(offsetof(AHTxxPart, measurementDelay)) + AHTXX_CMD_DELAY;
+
+  if ((policy == AHTXX_POLICY_LATENCY) || (interval < normalTime))
+  {
+    if (setCycleMode() != true) return AHTXX_ERROR;
+
+    return AHTXX_CYCLE_MODE;
+  }
+
+  if (setNormalMode() != true) return AHTXX_ERROR;
+
+  return AHTXX_NORMAL_MODE;
 }
 
 
 /**************************************************************************/
 /*
-    setType()  
+    softReset()  
  
-    Set sensor type
+    Restart sensor, without power off
 
     NOTE:
-    - AHT1x vs AHT2x:
-      - AHT1x +1.8v..+3.6v, AHT2x 2.2v..5.5v
-      - AHT1x 0.25uA..320uA, AHT2x 0.25uA..980uA
-      - AHT2x support CRC8 check
+    - takes 20ms
+    - all registers set to default
 */
 /**************************************************************************/
-void AHTxx::setType(AHTXX_I2C_SENSOR sensorType)
+bool AHTxx::softReset()
 {
-  _sensorType = sensorType;
-}
+  uint8_t command = AHTXX_SOFT_RESET_REG;
+
+  _transactionCount++;
 
+  if (_write(&command, 1) != true) return false; //collision on I2C bus, sensor didn't return ACK
 
+  delay(AHTXX_SOFT_RESET_DELAY);
 
+  return ((setNormalMode() == true) && (_getCalibration() == AHTXX_STATUS_CTRL_CAL_ON)); //set mode & check calibration bit
+}
 
 
 /**************************************************************************/
 /*
-    _readMeasurement()
-
-    Start new measurement, read sensor data to buffer & collect errors
+    clearBus()  
+ 
+    Release stuck I2C bus & re-initialize I2C & sensor
 
     NOTE:
-    - sensors data structure:
-      - {status, RH, RH, RH+T, T, T, CRC*}, *CRC for AHT2x only & for
-        status description see "_readStatusRegister()" NOTE
+    - slave reset in the middle of read can hold SDA low forever,
+      any command incl. "softReset()" never reaches the sensor
+    - bus clear sequence:
+      - SCL held low by slave longer than AHTXX_I2C_STRETCH_LIMIT
+        can't be fixed by master, power cycle is required
+      - up to 9 SCL pulses until slave releases SDA, slave clocks out
+        rest of byte & sees NACK
+      - STOP, SDA low->high while SCL is high
+    - pins are driven open-drain like, low or released with pull-up
+    - takes ~40msec with "softReset()"
+    - called automatically by blocking measurement after I2C error
+      on stuck bus, see "getStatus()", call it manually after
+      asynchronous measurement error
+    - true=bus is free & sensor is re-initialized, false=bus still stuck
 */
 /**************************************************************************/
-void AHTxx::_readMeasurement()
+bool AHTxx::clearBus()
 {
-  /* send measurement command */
-  Wire.beginTransmission(_address);
-
-  Wire.write(AHTXX_START_MEASUREMENT_REG);      //send measurement command, strat measurement
-  Wire.write(AHTXX_START_MEASUREMENT_CTRL);     //send measurement control
-  Wire.write(AHTXX_START_MEASUREMENT_CTRL_NOP); //send measurement NOP control
+  #if defined(AHTXX_NO_WIRE)
+  _transport->end();                                        //release pins from I2C hardware
+  #elif !defined(ESP8266)
+  _wire->end();                                             //release pins from I2C hardware
+  #endif
 
-  if (Wire.endTransmission(true) != 0)          //collision on I2C bus
-  {
-    _status = AHTXX_ACK_ERROR;                  //update status byte, sensor didn't return ACK
+  _busRecoveryCount++;
 
-    return;                                     //no reason to continue
-  }
+  pinMode(_sda, INPUT_PULLUP);
+  pinMode(_scl, INPUT_PULLUP);
 
-  /* check busy bit */
-  _status = _getBusy(AHTXX_FORCE_READ_DATA);                                              //update status byte, read status byte & check busy bit
+  /* wait for clock stretching to end */
+  uint16_t stretchTime = 0;
 
-  if      (_status == AHTXX_BUSY_ERROR) delay(AHTXX_MEASUREMENT_DELAY - AHTXX_CMD_DELAY);
-  else if (_status != AHTXX_NO_ERROR)   return;                                           //no reason to continue, received data smaller than expected
+  while (digitalRead(_scl) == LOW)
+  {
+    if (stretchTime >= AHTXX_I2C_STRETCH_LIMIT)
+    {
+      _beginWire();
 
-  /* read data from sensor */
-  uint8_t dataSize;
+      return false;                                       //no reason to continue, SCL is shorted or slave is dead
+    }
 
-  if   (_sensorType == AHT1x_SENSOR) dataSize = 6; //{status, RH, RH, RH+T, T, T, CRC*}, *CRC for AHT2x only
-  else                               dataSize = 7;
+    delayMicroseconds(AHTXX_I2C_HALF_PERIOD);
 
-  #if defined(_VARIANT_ARDUINO_STM32_)
-  Wire.requestFrom(_address, dataSize);
-  #else
-  Wire.requestFrom(_address, dataSize, true);      //read n-byte to "wire.h" rxBuffer, true-send stop after transmission
-  #endif
+    stretchTime += AHTXX_I2C_HALF_PERIOD;
+  }
 
-  if (Wire.available() != dataSize)
+  /* clock out byte slave is stuck in */
+  for (uint8_t pulse = 0; (pulse < AHTXX_I2C_CLEAR_PULSES) && (digitalRead(_sda) == LOW); pulse++)
   {
-    _status = AHTXX_DATA_ERROR;                    //update status byte, received data smaller than expected
+    digitalWrite(_scl, LOW);                              //SCL low, pin was input so pull-up is off before output
+    pinMode(_scl, OUTPUT);
+    delayMicroseconds(AHTXX_I2C_HALF_PERIOD);
 
-    return;                                        //no reason to continue
+    pinMode(_scl, INPUT_PULLUP);                          //SCL released
+    delayMicroseconds(AHTXX_I2C_HALF_PERIOD);
   }
 
-  /* read n-bytes from "wire.h" rxBuffer */
-  for (uint8_t i = 0; i < dataSize; i++)
-  {
-    _rawData[i] = Wire.read();
-  }
+  /* STOP */
+  digitalWrite(_sda, LOW);
+  pinMode(_sda, OUTPUT);                                  //SDA low while SCL is high
+  delayMicroseconds(AHTXX_I2C_HALF_PERIOD);
 
-  /* check busy bit after measurement dalay */
-  _status = _getBusy(AHTXX_USE_READ_DATA); //update status byte, read status byte & check busy bit
+  pinMode(_sda, INPUT_PULLUP);                            //SDA low->high
+  delayMicroseconds(AHTXX_I2C_HALF_PERIOD);
 
-  if (_status != AHTXX_NO_ERROR) return;   //no reason to continue, sensor is busy
+  bool released = (digitalRead(_sda) == HIGH) && (digitalRead(_scl) == HIGH);
 
-  /* check CRC8, for AHT2x only */
-  if ((_sensorType == AHT2x_SENSOR) && (_checkCRC8() != true)) _status = AHTXX_CRC8_ERROR; //update status byte
+  _beginWire();
+
+  if (released != true) return false;                     //no reason to continue, SDA is still stuck
+
+  return softReset();
 }
 
 
 /**************************************************************************/
 /*
-    _setInitializationRegister()
+    getStatus()  
  
-    Set initialization register
+    Return sensor status
 
     NOTE:
-    - true=success, false=I2C error
+    - returned statuse:
+      - AHTXX_NO_ERROR   = 0x00, success, no errors
+      - AHTXX_BUSY_ERROR = 0x01, sensor is busy
+      - AHTXX_ACK_ERROR  = 0x02, sensor didn't return ACK
+      - AHTXX_DATA_ERROR = 0x03, received data smaller than expected
+      - AHTXX_CRC8_ERROR = 0x04, computed CRC8 not match received CRC8, for AHT2x only
+      - AHTXX_BUS_ERROR  = 0x05, I2C bus was stuck, "clearBus()" was called
+      - AHTXX_NO_DATA_ERROR = 0x06, no measurement yet, any measurement
+        updates status, failed too
 */
 /**************************************************************************/
-bool AHTxx::_setInitializationRegister(uint8_t value)
+uint8_t AHTxx::getStatus()
 {
-  delay(AHTXX_CMD_DELAY);
-
-  Wire.beginTransmission(_address);
-
-  if   (_sensorType == AHT1x_SENSOR) Wire.write(AHT1X_INIT_REG); //send initialization command, for AHT1x only
-  else                               Wire.write(AHT2X_INIT_REG); //send initialization command, for AHT2x only
-
-  Wire.write(value);                                             //send initialization register controls
-  Wire.write(AHTXX_INIT_CTRL_NOP);                               //send initialization register NOP control
-
-  return (Wire.endTransmission(true) == 0);                      //true=success, false=I2C error
+  return _status;
 }
 
 
 /**************************************************************************/
 /*
-    _readStatusRegister()
-
-    Read status register
+    getRawData()  
+ 
+    Copy last received sensor data to buffer & return number of bytes
 
     NOTE:
-    - AHT1x status register controls:
-      7    6    5    4   3    2   1   0
-      BSY, MOD, MOD, xx, CAL, xx, xx, xx
-      - BSY:
-        - 1, sensor busy/measuring
-        - 0, sensor idle/sleeping
-      - MOD:
-        - 00, normal mode
-        - 01, cycle mode
-        - 1x, comand mode
-      - CAL:
-        - 1, calibration on
-        - 0, calibration off
-
-    - AHT2x status register controls:
-      7    6   5   4   3    2   1  0
-      BSY, xx, xx, xx, CAL, xx, xx, xx
-
-    - under normal conditions status is 0x18 & 0x80 if the sensor is busy
+    - buffer must fit 7 bytes
+    - sensors data structure:
+      - {status, RH, RH, RH+T, T, T, CRC*}, *CRC for AHT2x only
+    - data of last "read...(AHTXX_FORCE_READ_DATA)" or "updateAsync()",
+      check "getStatus()" before use
+    - used by "AHTxxStreamWriter" to send raw frames, decode on host
+      is same as "readRawHumidity()" & "readRawTemperature()"
 */
 /**************************************************************************/
-uint8_t AHTxx::_readStatusRegister()
+uint8_t AHTxx::getRawData(uint8_t *data)
 {
-  delay(AHTXX_CMD_DELAY);
-
-  Wire.beginTransmission(_address);
+  uint8_t length = _getDataSize();
 
-  Wire.write(AHTXX_STATUS_REG);
-
-  if (Wire.endTransmission(true) != 0) return AHTXX_ERROR; //collision on I2C bus, sensor didn't return ACK
-
-  #if defined(_VARIANT_ARDUINO_STM32_)
-  Wire.requestFrom(_address, 1);
-  #else
-  Wire.requestFrom(_address, 1, true);                     //read 1-byte to "wire.h" rxBuffer, true-send stop after transmission
-  #endif
+  for (uint8_t i = 0; i < length; i++)
+  {
+    data[i] = _rawData[i];
+  }
 
-  if (Wire.available() == 1) return Wire.read();           //read 1-byte from "wire.h" rxBuffer
-                             return AHTXX_ERROR;           //collision on I2C bus, "wire.h" rxBuffer is empty
+  return length;
 }
 
 
 /**************************************************************************/
 /*
-    _getCalibration()
-
-    Read calibration bits from status register
+    setType()  
+ 
+    Set sensor type
 
     NOTE:
-    - 0x08=loaded, 0x00=not loaded, 0xFF=I2C error
-    - calibration status check should only be performed at power-up,
-      rechecking is not required during data collection
+    - AHT1x vs AHT2x:
+      - AHT1x +1.8v..+3.6v, AHT2x 2.2v..5.5v
+      - AHT1x 0.25uA..320uA, AHT2x 0.25uA..980uA
+      - AHT2x support CRC8 check
+    - same as "setPart(AHT1x_PART/AHT2x_PART)", worst-case timings of
+      sensor family, use "setPart()" with exact part number for faster
+      timings
 */
 /**************************************************************************/
-uint8_t AHTxx::_getCalibration()
+void AHTxx::setType(AHTXX_I2C_SENSOR sensorType)
 {
-  uint8_t value = _readStatusRegister();
-
-  if (value != AHTXX_ERROR) return (value & AHTXX_STATUS_CTRL_CAL_ON); //0x08=loaded, 0x00=not loaded
-                            return AHTXX_ERROR;                        //collision on I2C bus, sensor didn't return ACK
+  setPart((AHTXX_PART)sensorType);
 }
 
 
 /**************************************************************************/
 /*
-    _getBusy()
-
-    Read/check busy bit after measurement command
+    setPart()  
+ 
+    Set exact part number
 
     NOTE:
-    - part of "readRawMeasurement()" function!!!
-    - 0x80=busy, 0x00=measurement completed, etc
+    - selects descriptor in flash: initialization register, frame size,
+      CRC, power-on & measurement delay, see "AHTXX_PARTS[]"
+    - AHT10/AHT15 power-on 40msec & measurement 75msec vs 100msec &
+      80msec of AHT1x_PART, AHT2x parts have same timings as AHT2x_PART
+    - timings are datasheet typical, not measured, sensor that is still
+      busy after measurement delay is read again, see "_readMeasurement()"
+    - unknown part falls back to AHT1x_PART
+    - resets mode to AHTXX_NORMAL_MODE, "begin()" sets sensor to normal
+      mode
+    - call before "begin()"
 */
 /**************************************************************************/
-uint8_t AHTxx::_getBusy(bool readAHT)
+void AHTxx::setPart(AHTXX_PART part)
 {
-  if (readAHT == AHTXX_FORCE_READ_DATA)                 //force to read data via I2C & update "_rawData[]" buffer
-  {
-    delay(AHTXX_CMD_DELAY);
+  if (part > AM2311B_PART) part = AHT1x_PART;
 
-    #if defined(_VARIANT_ARDUINO_STM32_)
-    Wire.requestFrom(_address, 1);
-    #else
-    Wire.requestFrom(_address, 1, true);                //read 1-byte to "wire.h" rxBuffer, true-send stop after transmission
-    #endif
-
-    if (Wire.available() != 1) return AHTXX_DATA_ERROR; //no reason to continue, "return" terminates the entire function & "break" just exits the loop
-
-    _rawData[0] = Wire.read();                          //read 1-byte from "wire.h" rxBuffer
-  }
+  _part = part;
+  _mode = AHTXX_NORMAL_MODE;                                           //mode of previous part is unknown for new one
+}
 
-  if   ((_rawData[0] & AHTXX_STATUS_CTRL_BUSY) == AHTXX_STATUS_CTRL_BUSY) _status = AHTXX_BUSY_ERROR;   //0x80=busy, 0x00=measurement completed
-  else                                                                    _status = AHTXX_NO_ERROR;
 
-  return _status;
+/**************************************************************************/
+/*
+    getPart()  
+ 
+    Return part number
+*/
+/**************************************************************************/
+AHTXX_PART AHTxx::getPart()
+{
+  return _part;
 }
 
 
 /**************************************************************************/
 /*
-    _checkCRC8()
+    getPartInfo()  
+ 
+    Copy descriptor of part from flash to "info"
+
+    NOTE:
+    - supply voltage & current for power budget, sensor type, frame
+      size & timings used by driver
+*/
+/**************************************************************************/
+void AHTxx::getPartInfo(AHTxxPart *info)
+{
+  memcpy_P(info, &AHTXX_PARTS[_part], sizeof(AHTxxPart));
+}
+
+
+/**************************************************************************/
+/*
+    setMeasurementControl()  
+ 
+    Set control byte sent after start measurement command
+
+    NOTE:
+    - no info in datasheet, suspect this is temperature & humidity
+      DAC resolution
+    - default AHTXX_START_MEASUREMENT_CTRL=0x33, use other values
+      for experiments only, see "examples/AHTxx_MeasurementControl"
+      to characterize conversion time & noise of your sensor
+*/
+/**************************************************************************/
+void AHTxx::setMeasurementControl(uint8_t value)
+{
+  _measurementCtrl = value;
+}
+
+
+/**************************************************************************/
+/*
+    getMeasurementControl()  
+ 
+    Return control byte sent after start measurement command
+*/
+/**************************************************************************/
+uint8_t AHTxx::getMeasurementControl()
+{
+  return _measurementCtrl;
+}
+
+
+
+
+/**************************************************************************/
+/*
+    setTransport()  
+ 
+    Set I2C transport for asynchronous measurement
+
+    NOTE:
+    - default synchronous adapter over TwoWire of constructor
+    - see "AHTxxTransport.h" to plug interrupt/DMA I2C drivers
+    - blocking functions always use TwoWire of constructor, in
+      "AHTXX_NO_WIRE" build they use this transport too
+*/
+/**************************************************************************/
+void AHTxx::setTransport(AHTxxTransport *transport)
+{
+  _transport = transport;
+}
+
+
+/**************************************************************************/
+/*
+    startMeasurementAsync()  
+ 
+    Submit measurement command & return without waiting
+
+    NOTE:
+    - call "updateAsync()" from loop until it returns AHTXX_ASYNC_READY,
+      then "getStatus()" & "read...(AHTXX_USE_READ_DATA)"
+    - CPU is free during 80msec conversion & during I2C transfers
+      with asynchronous transport
+    - don't call blocking functions until measurement is completed
+    - true=submitted, false=measurement in progress or transport queue full
+*/
+/**************************************************************************/
+bool AHTxx::startMeasurementAsync()
+{
+  if ((_asyncState != AHTXX_ASYNC_IDLE) && (_asyncState != AHTXX_ASYNC_READY)) return false; //no reason to continue, measurement in progress
+
+  if (_mode == AHTXX_CYCLE_MODE)                                       //sensor measures by itself, read latest data
+  {
+    _updateMeasurementInterval();
+
+    _asyncStart = millis();
+    _asyncTime  = _asyncStart;
+    _asyncDelay = 0;
+    _asyncState = AHTXX_ASYNC_CONVERSION;
+
+    return true;
+  }
+
+  _command[0] = AHTXX_START_MEASUREMENT_REG;
+  _command[1] = _measurementCtrl;
+  _command[2] = AHTXX_START_MEASUREMENT_CTRL_NOP;
+
+  _asyncState = AHTXX_ASYNC_TRIGGER;                                   //before submit, synchronous transport calls callback before return
+  _asyncStart = millis();
+
+  if (_transport->write(_address, _command, 3, _onTrigger, this) != true)
+  {
+    _asyncState = AHTXX_ASYNC_IDLE;
+
+    return false;
+  }
+
+  _transactionCount++;
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    updateAsync()  
+ 
+    Advance asynchronous measurement & return its state
+
+    NOTE:
+    - returns AHTXX_ASYNC_... state, see "AHTxx.h"
+    - data is read after part measurement delay, if sensor is still
+      busy read is repeated after AHTXX_CMD_DELAY
+    - AHTXX_ASYNC_READY stays until next "startMeasurementAsync()"
+    - transport is polled once per call, polled AVR TWI advances one
+      bus event per call, see "AHTxxTWI.h"
+*/
+/**************************************************************************/
+uint8_t AHTxx::updateAsync()
+{
+  _transport->poll();
+
+  switch (_asyncState)
+  {
+    case AHTXX_ASYNC_CONVERSION:
+      if ((millis() - _asyncTime) < _asyncDelay) break;                //measurement is not completed
+
+      _asyncState = AHTXX_ASYNC_READ;
+
+      if (_transport->read(_address, _rawData, _getDataSize(), _onRead, this) != true) _asyncState = AHTXX_ASYNC_CONVERSION; //queue full, try again later
+      else                                                                             _transactionCount++;
+      break;
+
+    case AHTXX_ASYNC_RECEIVED:
+      if (_asyncResult != AHTXX_NO_ERROR)
+      {
+        _status     = _asyncResult;                                    //update status byte, received data smaller than expected
+        _asyncState = AHTXX_ASYNC_READY;
+
+        _measurementCount++;
+        _errorCount++;
+
+        _countLatency(millis() - _asyncStart);
+
+        break;
+      }
+
+      if (_getBusy(AHTXX_USE_READ_DATA) == AHTXX_BUSY_ERROR)           //update status byte, check busy bit
+      {
+        _asyncTime  = millis();
+        _asyncDelay = AHTXX_CMD_DELAY;
+        _asyncState = AHTXX_ASYNC_CONVERSION;                          //read again later
+
+        break;
+      }
+
+      if (_checkCRC8() != true) _status = AHTXX_CRC8_ERROR; //update status byte, AHT2x only
+
+      _measurementCount++;
+
+      if (_status != AHTXX_NO_ERROR) _errorCount++;
+
+      _countLatency(millis() - _asyncStart);
+
+      _asyncState = AHTXX_ASYNC_READY;
+      break;
+  }
+
+  return _asyncState;
+}
+
+
+/**************************************************************************/
+/*
+    getMeasurementInterval()  
+ 
+    Return time between last two measurements, in milliseconds
+
+    NOTE:
+    - measurements < 2 seconds apart lead to self-heating
+    - 0xFFFFFFFF=less than two measurements
+*/
+/**************************************************************************/
+uint32_t AHTxx::getMeasurementInterval()
+{
+  return _measurementInterval;
+}
+
+
+/**************************************************************************/
+/*
+    getTemperatureUncertainty()  
+ 
+    Return uncertainty of last temperature measurement, in C
+
+    NOTE:
+    - based on datasheet accuracy, position in operating range &
+      self-heating, see "AHTxxUncertainty.h"
+    - returns AHTXX_ERROR if last measurement failed or there was no
+      measurement yet, see AHTXX_NO_DATA_ERROR
+*/
+/**************************************************************************/
+float AHTxx::getTemperatureUncertainty()
+{
+  float temperature = readTemperature(AHTXX_USE_READ_DATA);
+
+  if (temperature == AHTXX_ERROR) return AHTXX_ERROR;
+
+  return ahtxxTemperatureUncertainty(temperature, 1, _measurementInterval);
+}
+
+
+/**************************************************************************/
+/*
+    getHumidityUncertainty()  
+ 
+    Return uncertainty of last relative humidity measurement, in %
+
+    NOTE:
+    - see "getTemperatureUncertainty()" NOTE
+    - use "ahtxxDewPoint()" to propagate T & RH uncertainty to dew point
+*/
+/**************************************************************************/
+float AHTxx::getHumidityUncertainty()
+{
+  float humidity = readHumidity(AHTXX_USE_READ_DATA);
+
+  if (humidity == AHTXX_ERROR) return AHTXX_ERROR;
+
+  return ahtxxHumidityUncertainty(humidity, readTemperature(AHTXX_USE_READ_DATA), 1, _measurementInterval);
+}
+
+
+/**************************************************************************/
+/*
+    getTransactionCount()  
+ 
+    Return number of I2C transactions since last "resetStatistics()"
+
+    NOTE:
+    - write & read are counted separately, failed transfers too
+    - blocking measurement takes 3 transactions, asynchronous 2
+*/
+/**************************************************************************/
+uint32_t AHTxx::getTransactionCount()
+{
+  return _transactionCount;
+}
+
+
+/**************************************************************************/
+/*
+    getMeasurementCount()  
+ 
+    Return number of completed measurements since last "resetStatistics()"
+
+    NOTE:
+    - blocking & asynchronous measurements, with & without errors
+*/
+/**************************************************************************/
+uint32_t AHTxx::getMeasurementCount()
+{
+  return _measurementCount;
+}
+
+
+/**************************************************************************/
+/*
+    getErrorCount()  
+ 
+    Return number of failed measurements since last "resetStatistics()"
+
+    NOTE:
+    - any status except AHTXX_NO_ERROR, see "getStatus()"
+*/
+/**************************************************************************/
+uint32_t AHTxx::getErrorCount()
+{
+  return _errorCount;
+}
+
+
+/**************************************************************************/
+/*
+    getBlockingTime()  
+ 
+    Return time spent in blocking measurements since last
+    "resetStatistics()", in microseconds
+
+    NOTE:
+    - "read...(AHTXX_FORCE_READ_DATA)" only, ~90msec per measurement,
+      asynchronous measurement doesn't block
+    - overflows after ~71 minutes of blocking time
+*/
+/**************************************************************************/
+uint32_t AHTxx::getBlockingTime()
+{
+  return _blockingTime;
+}
+
+
+/**************************************************************************/
+/*
+    getBusRecoveryCount()  
+ 
+    Return number of "clearBus()" calls since last "resetStatistics()"
+*/
+/**************************************************************************/
+uint32_t AHTxx::getBusRecoveryCount()
+{
+  return _busRecoveryCount;
+}
+
+
+/**************************************************************************/
+/*
+    getLatencyCount()  
+ 
+    Return number of measurements in latency bucket since last
+    "resetStatistics()"
+
+    NOTE:
+    - bucket 0..AHTXX_LATENCY_BUCKETS-1, not cumulative, see
+      "getLatencyBound()"
+    - latency of blocking measurement is time in "read...()", of
+      asynchronous from "startMeasurementAsync()" to AHTXX_ASYNC_READY,
+      includes time between "updateAsync()" calls
+    - measurements with errors are counted too
+*/
+/**************************************************************************/
+uint32_t AHTxx::getLatencyCount(uint8_t bucket)
+{
+  if (bucket >= AHTXX_LATENCY_BUCKETS) return 0;
+
+  return _latencyCounts[bucket];
+}
+
+
+/**************************************************************************/
+/*
+    getLatencyBound()  
+ 
+    Return upper bound of latency bucket, in milliseconds
+
+    NOTE:
+    - AHTXX_LATENCY_INF for last bucket
+*/
+/**************************************************************************/
+uint16_t AHTxx::getLatencyBound(uint8_t bucket)
+{
+  switch (bucket)
+  {
+    case 0:  return 85;                                        //typical conversion + transfers
+    case 1:  return 90;
+    case 2:  return 100;                                       //one extra busy poll
+    case 3:  return 125;
+    case 4:  return 250;
+    default: return AHTXX_LATENCY_INF;
+  }
+}
+
+
+/**************************************************************************/
+/*
+    getLatencySum()  
+ 
+    Return sum of measurement latencies since last "resetStatistics()",
+    in milliseconds
+*/
+/**************************************************************************/
+uint32_t AHTxx::getLatencySum()
+{
+  return _latencySum;
+}
+
+
+/**************************************************************************/
+/*
+    resetStatistics()  
+ 
+    Clear transaction, measurement, error & bus recovery counters,
+    blocking time & latency histogram
+*/
+/**************************************************************************/
+void AHTxx::resetStatistics()
+{
+  _transactionCount = 0;
+  _measurementCount = 0;
+  _errorCount       = 0;
+  _blockingTime     = 0;
+  _busRecoveryCount = 0;
+  _latencySum       = 0;
+
+  for (uint8_t i = 0; i < AHTXX_LATENCY_BUCKETS; i++)
+  {
+    _latencyCounts[i] = 0;
+  }
+}
+
+
+
+/**************************************************************************/
+/*
+    _readMeasurement()
+
+    Start new measurement, read sensor data to buffer & collect errors
+
+    NOTE:
+    - sensors data structure:
+      - {status, RH, RH, RH+T, T, T, CRC*}, *CRC for AHT2x only & for
+        status description see "_readStatusRegister()" NOTE
+    - cycle mode reads latest data without measurement command
+    - one retry after AHTXX_CMD_DELAY if sensor is still busy, same as
+      "updateAsync()", part measurement delay is typical not max
+*/
+/**************************************************************************/
+void AHTxx::_readMeasurement()
+{
+  if      (_mode == AHTXX_CYCLE_MODE)      _updateMeasurementInterval(); //sensor measures by itself, no command
+  else if (_startMeasurement() != true)   return;                       //no reason to continue
+
+  _readFrame();
+
+  if (_status != AHTXX_BUSY_ERROR) return;       //no reason to continue
+
+  delay(AHTXX_CMD_DELAY);
+
+  _readFrame();
+}
+
+
+/**************************************************************************/
+/*
+    _startMeasurement()
+
+    Send measurement command & wait for conversion
+
+    NOTE:
+    - part of "_readMeasurement()" function!!!
+    - true=data can be read, false=error, see "_status"
+*/
+/**************************************************************************/
+bool AHTxx::_startMeasurement()
+{
+  /* send measurement command */
+  uint8_t command[3] = {AHTXX_START_MEASUREMENT_REG, _measurementCtrl, AHTXX_START_MEASUREMENT_CTRL_NOP}; //measurement command, control & NOP control
+
+  _transactionCount++;
+
+  if (_write(command, 3) != true)                 //collision on I2C bus
+  {
+    _status = AHTXX_ACK_ERROR;                  //update status byte, sensor didn't return ACK
+
+    return false;                               //no reason to continue
+  }
+
+  _updateMeasurementInterval();
+
+  /* check busy bit */
+  _status = _getBusy(AHTXX_FORCE_READ_DATA);                                              //update status byte, read status byte & check busy bit
+
+  if      (_status == AHTXX_BUSY_ERROR) delay(_getPartValue(offsetof(AHTxxPart, measurementDelay)) - AHTXX_CMD_DELAY);
+  else if (_status != AHTXX_NO_ERROR)   return false;                                     //no reason to continue, received data smaller than expected
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    _readFrame()
+
+    Read sensor data to buffer, check busy bit & CRC
+
+    NOTE:
+    - part of "_readMeasurement()" function!!!
+    - AHTXX_BUSY_ERROR if conversion is not completed
+*/
+/**************************************************************************/
+void AHTxx::_readFrame()
+{
+  /* read data from sensor */
+  uint8_t dataSize = _getDataSize();
+
+  _transactionCount++;
+
+  if (_read(_rawData, dataSize) != true)
+  {
+    _status = AHTXX_DATA_ERROR;                    //update status byte, received data smaller than expected
+
+    return;                                        //no reason to continue
+  }
+
+  /* check busy bit after measurement dalay */
+  _status = _getBusy(AHTXX_USE_READ_DATA); //update status byte, read status byte & check busy bit
+
+  if (_status != AHTXX_NO_ERROR) return;   //no reason to continue, sensor is busy
+
+  /* check CRC8, for AHT2x only */
+  if (_checkCRC8() != true) _status = AHTXX_CRC8_ERROR; //update status byte, AHT2x only
+}
+
+
+/**************************************************************************/
+/*
+    _countMeasurement()
+
+    Recover stuck bus & update statistics after blocking measurement
+
+    NOTE:
+    - startTime, "micros()" before "_readMeasurement()"
+    - I2C error with stuck bus becomes AHTXX_BUS_ERROR, see "clearBus()"
+*/
+/**************************************************************************/
+void AHTxx::_countMeasurement(uint32_t startTime)
+{
+  if (((_status == AHTXX_ACK_ERROR) || (_status == AHTXX_DATA_ERROR)) && (_getBusStuck() == true))
+  {
+    clearBus();
+
+    _status = AHTXX_BUS_ERROR;                  //update status byte, measurement is lost
+  }
+
+  uint32_t duration = micros() - startTime;
+
+  _blockingTime += duration;
+
+  _countLatency(duration / 1000);
+
+  _measurementCount++;
+
+  if (_status != AHTXX_NO_ERROR) _errorCount++;
+}
+
+
+/**************************************************************************/
+/*
+    _countLatency()
+
+    Add measurement latency to histogram, in milliseconds
+
+    NOTE:
+    - may be called from interrupt
+*/
+/**************************************************************************/
+void AHTxx::_countLatency(uint32_t latency)
+{
+  uint8_t bucket = 0;
+
+  while ((bucket < (AHTXX_LATENCY_BUCKETS - 1)) && (latency > getLatencyBound(bucket))) bucket++;
+
+  _latencyCounts[bucket]++;
+
+  _latencySum += latency;
+}
+
+
+/**************************************************************************/
+/*
+    _beginWire()
+
+    Initialize I2C with saved pins, speed & transaction timeout
+
+    NOTE:
+    - AVR "Wire.h" with "WIRE_HAS_TIMEOUT" aborts stuck transaction
+      & resets TWI, without timeout "Wire.h" can hang forever
+    - ESP32 timeout is in milliseconds
+    - "AHTXX_NO_WIRE" build calls "AHTxxTransport::begin()", transfer
+      timeout is in "_transfer()"
+*/
+/**************************************************************************/
+void AHTxx::_beginWire()
+{
+  #if defined(AHTXX_NO_WIRE)
+  _transport->begin(_speed);
+  #else
+  #if defined(ESP8266) || defined(ESP32) || defined(STM32F4xx)
+  _wire->begin(_sda, _scl);
+  #else
+  _wire->begin();
+  #endif
+
+  _wire->setClock(_speed);                                 //experimental! ESP8266 I2C bus speed: 1kHz..400kHz, AVR 31kHz..400kHz, default 100000Hz
+
+  #if defined(ESP8266)
+  _wire->setClockStretchLimit(1000);                       //experimental! default 230usec
+  #endif
+
+  #if defined(WIRE_HAS_TIMEOUT)
+  _wire->setWireTimeout(AHTXX_I2C_TIMEOUT, true);          //true=reset TWI on timeout
+  #elif defined(ESP32)
+  _wire->setTimeOut(AHTXX_I2C_TIMEOUT / 1000);
+  #endif
+  #endif
+}
+
+
+/**************************************************************************/
+/*
+    _write()
+
+    Write n-bytes to sensor & wait for completion
+
+    NOTE:
+    - blocking, takes ~90usec per byte at 100KHz
+    - "AHTXX_NO_WIRE" build submits to transport of constructor &
+      polls it until callback, see "_transfer()"
+    - true=success, false=collision on I2C bus or sensor didn't
+      return ACK
+*/
+/**************************************************************************/
+bool AHTxx::_write(const uint8_t *data, uint8_t length)
+{
+  #if defined(AHTXX_NO_WIRE)
+  return _transfer(false, (uint8_t *)data, length);
+  #else
+  _wire->beginTransmission(_address);
+
+  _wire->write(data, length);
+
+  return (_wire->endTransmission(true) == 0);
+  #endif
+}
+
+
+/**************************************************************************/
+/*
+    _read()
+
+    Read n-bytes from sensor & wait for completion
+
+    NOTE:
+    - see "_write()" NOTE
+    - "data" is not changed if less bytes are received
+    - true=success, false=received data smaller than expected
+*/
+/**************************************************************************/
+bool AHTxx::_read(uint8_t *data, uint8_t length)
+{
+  #if defined(AHTXX_NO_WIRE)
+  return _transfer(true, data, length);
+  #else
+  #if defined(_VARIANT_ARDUINO_STM32_)
+  _wire->requestFrom(_address, length);
+  #else
+  _wire->requestFrom(_address, length, (uint8_t)true); //read n-byte to "wire.h" rxBuffer, true-send stop after transmission, cast selects "uint8_t" overload
+  #endif
+
+  if (_wire->available() != length) return false;    //no reason to continue
+
+  for (uint8_t i = 0; i < length; i++)
+  {
+    data[i] = _wire->read();                         //read n-bytes from "wire.h" rxBuffer
+  }
+
+  return true;
+  #endif
+}
+
+
+#if defined(AHTXX_NO_WIRE)
+/**************************************************************************/
+/*
+    _transfer()
+
+    Submit transfer to transport & poll it until callback
+
+    NOTE:
+    - data goes through "_buffer", it lives until transfer is done
+    - queue may hold asynchronous transfers, submit is repeated
+      until accepted
+    - gives up after AHTXX_I2C_TIMEOUT, transfer may still be queued,
+      next call waits for it before "_buffer" is reused
+    - true=success, false=I2C error or timeout
+*/
+/**************************************************************************/
+bool AHTxx::_transfer(bool isRead, uint8_t *data, uint8_t length)
+{
+  uint32_t startTime = micros();
+
+  while (_transferDone != true)                                    //previous transfer timed out & still owns "_buffer"
+  {
+    if ((micros() - startTime) > AHTXX_I2C_TIMEOUT) return false;  //no reason to continue, bus is stuck
+
+    _transport->poll();
+
+    yield();
+  }
+
+  if (isRead != true) memcpy(_buffer, data, length);
+
+  _transferDone = false;
+
+  for (;;)
+  {
+    bool submitted = (isRead == true) ? _transport->read(_address, _buffer, length, _onTransfer, this) :
+                                        _transport->write(_address, _buffer, length, _onTransfer, this);
+
+    if (submitted == true) break;
+
+    if ((micros() - startTime) > AHTXX_I2C_TIMEOUT)
+    {
+      _transferDone = true;                                        //nothing queued
+
+      return false;                                                //no reason to continue, queue stays full
+    }
+
+    _transport->poll();
+
+    yield();
+  }
+
+  while (_transferDone != true)
+  {
+    if ((micros() - startTime) > AHTXX_I2C_TIMEOUT) return false;  //no reason to continue, bus is stuck
+
+    _transport->poll();                                            //does nothing in TWI interrupt mode
+
+    yield();
+  }
+
+  if (_transferResult != AHTXX_NO_ERROR) return false;             //no reason to continue
+
+  if (isRead == true) memcpy(data, _buffer, length);
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    _onTransfer()
+
+    Blocking transfer completion callback
+
+    NOTE:
+    - may be called from interrupt, only saves result
+*/
+/**************************************************************************/
+void AHTxx::_onTransfer(void *context, uint8_t result)
+{
+  AHTxx *sensor = (AHTxx *)context;
+
+  sensor->_transferResult = result;
+  sensor->_transferDone   = true;
+}
+#endif
+
+
+/**************************************************************************/
+/*
+    _getBusStuck()
+
+    Check if I2C bus is stuck after I2C error
+
+    NOTE:
+    - idle bus has SDA & SCL high, failed transaction ends with STOP,
+      line still low means slave holds it
+    - AVR "Wire.h" timeout flag is checked & cleared too
+*/
+/**************************************************************************/
+bool AHTxx::_getBusStuck()
+{
+  #if defined(WIRE_HAS_TIMEOUT) && !defined(AHTXX_NO_WIRE)
+  if (_wire->getWireTimeoutFlag() == true)
+  {
+    _wire->clearWireTimeoutFlag();
+
+    return true;
+  }
+  #endif
+
+  return (digitalRead(_sda) == LOW) || (digitalRead(_scl) == LOW);
+}
+
+
+/**************************************************************************/
+/*
+    _setInitializationRegister()
+ 
+    Set initialization register
+
+    NOTE:
+    - true=success, false=I2C error
+*/
+/**************************************************************************/
+bool AHTxx::_setInitializationRegister(uint8_t value)
+{
+  delay(AHTXX_CMD_DELAY);
+
+  uint8_t command[3] = {_getPartValue(offsetof(AHTxxPart, initReg)), value, AHTXX_INIT_CTRL_NOP}; //AHT1X_INIT_REG or AHT2X_INIT_REG, controls & NOP control
+
+  _transactionCount++;
+
+  return _write(command, 3);                                       //true=success, false=I2C error
+}
+
+
+/**************************************************************************/
+/*
+    _readStatusRegister()
+
+    Read status register
+
+    NOTE:
+    - AHT1x status register controls:
+      7    6    5    4   3    2   1   0
+      BSY, MOD, MOD, xx, CAL, xx, xx, xx
+      - BSY:
+        - 1, sensor busy/measuring
+        - 0, sensor idle/sleeping
+      - MOD:
+        - 00, normal mode
+        - 01, cycle mode
+        - 1x, comand mode
+      - CAL:
+        - 1, calibration on
+        - 0, calibration off
+
+    - AHT2x status register controls:
+      7    6   5   4   3    2   1  0
+      BSY, xx, xx, xx, CAL, xx, xx, xx
+
+    - under normal conditions status is 0x18 & 0x80 if the sensor is busy
+*/
+/**************************************************************************/
+uint8_t AHTxx::_readStatusRegister()
+{
+  delay(AHTXX_CMD_DELAY);
+
+  uint8_t value = AHTXX_STATUS_REG;
+
+  _transactionCount++;
+
+  if (_write(&value, 1) != true) return AHTXX_ERROR;         //collision on I2C bus, sensor didn't return ACK
+
+  _transactionCount++;
+
+  if (_read(&value, 1) == true) return value;                //read 1-byte
+                                return AHTXX_ERROR;          //collision on I2C bus, no data received
+}
+
+
+/**************************************************************************/
+/*
+    _getCalibration()
+
+    Read calibration bits from status register
+
+    NOTE:
+    - 0x08=loaded, 0x00=not loaded, 0xFF=I2C error
+    - calibration status check should only be performed at power-up,
+      rechecking is not required during data collection
+*/
+/**************************************************************************/
+uint8_t AHTxx::_getCalibration()
+{
+  uint8_t value = _readStatusRegister();
+
+  if (value != AHTXX_ERROR) return (value & AHTXX_STATUS_CTRL_CAL_ON); //0x08=loaded, 0x00=not loaded
+                            return AHTXX_ERROR;                        //collision on I2C bus, sensor didn't return ACK
+}
+
+
+/**************************************************************************/
+/*
+    _getBusy()
+
+    Read/check busy bit after measurement command
+
+    NOTE:
+    - part of "readRawMeasurement()" function!!!
+    - 0x80=busy, 0x00=measurement completed, etc
+*/
+/**************************************************************************/
+uint8_t AHTxx::_getBusy(bool readAHT)
+{
+  if (readAHT == AHTXX_FORCE_READ_DATA)                 //force to read data via I2C & update "_rawData[]" buffer
+  {
+    delay(AHTXX_CMD_DELAY);
+
+    _transactionCount++;
+
+    if (_read(_rawData, 1) != true) return AHTXX_DATA_ERROR; //no reason to continue, "return" terminates the entire function & "break" just exits the loop
+  }
+
+  if   ((_rawData[0] & AHTXX_STATUS_CTRL_BUSY) == AHTXX_STATUS_CTRL_BUSY) _status = AHTXX_BUSY_ERROR;   //0x80=busy, 0x00=measurement completed
+  else                                                                    _status = AHTXX_NO_ERROR;
+
+  return _status;
+}
 
-    Check CRC-8-Maxim of AHT2X measured data
+
+/**************************************************************************/
+/*
+    _checkCRC8()
+
+    Check CRC-8-Maxim of AHT2X measured data
 
     NOTE:
     - part of "readRawMeasurement()" function!!!
@@ -507,7 +1571,7 @@ uint8_t AHTxx::_getBusy(bool readAHT)
 /**************************************************************************/
 bool AHTxx::_checkCRC8()
 {
-  if (_sensorType == AHT2x_SENSOR)
+  if (_getPartValue(offsetof(AHTxxPart, crc)) == 1)
   {
     uint8_t crc = 0xFF;                                      //initial value
 
@@ -527,3 +1591,109 @@ bool AHTxx::_checkCRC8()
 
   return true;
 }
+
+
+/**************************************************************************/
+/*
+    _getDataSize()
+
+    Return size of measurement data
+
+    NOTE:
+    - {status, RH, RH, RH+T, T, T, CRC*}, *CRC for AHT2x only
+*/
+/**************************************************************************/
+uint8_t AHTxx::_getDataSize()
+{
+  return _getPartValue(offsetof(AHTxxPart, dataSize));
+}
+
+
+/**************************************************************************/
+/*
+    _getPartValue()
+
+    Read 8-bit field of part descriptor from flash
+
+    NOTE:
+    - offset is "offsetof(AHTxxPart, field)", 8-bit fields only
+*/
+/**************************************************************************/
+uint8_t AHTxx::_getPartValue(uint8_t offset)
+{
+  return pgm_read_byte((const uint8_t *)&AHTXX_PARTS[_part] + offset);
+}
+
+
+/**************************************************************************/
+/*
+    _onTrigger()
+
+    Measurement command completion callback
+
+    NOTE:
+    - may be called from interrupt, only saves result & time
+*/
+/**************************************************************************/
+void AHTxx::_onTrigger(void *context, uint8_t result)
+{
+  AHTxx *sensor = (AHTxx *)context;
+
+  if (result != AHTXX_NO_ERROR)
+  {
+    sensor->_status     = AHTXX_ACK_ERROR;                              //update status byte, sensor didn't return ACK
+    sensor->_asyncState = AHTXX_ASYNC_READY;
+
+    sensor->_measurementCount++;
+    sensor->_errorCount++;
+
+    sensor->_countLatency(millis() - sensor->_asyncStart);
+
+    return;
+  }
+
+  sensor->_updateMeasurementInterval();
+
+  sensor->_asyncTime  = millis();
+  sensor->_asyncDelay = sensor->_getPartValue(offsetof(AHTxxPart, measurementDelay));
+  sensor->_asyncState = AHTXX_ASYNC_CONVERSION;
+}
+
+
+/**************************************************************************/
+/*
+    _onRead()
+
+    Measurement data completion callback
+
+    NOTE:
+    - may be called from interrupt, data is checked in "updateAsync()"
+*/
+/**************************************************************************/
+void AHTxx::_onRead(void *context, uint8_t result)
+{
+  AHTxx *sensor = (AHTxx *)context;
+
+  sensor->_asyncResult = result;
+  sensor->_asyncState  = AHTXX_ASYNC_RECEIVED;
+}
+
+
+/**************************************************************************/
+/*
+    _updateMeasurementInterval()
+
+    Save time between this & previous measurement command
+
+    NOTE:
+    - may be called from interrupt
+*/
+/**************************************************************************/
+void AHTxx::_updateMeasurementInterval()
+{
+  uint32_t time = millis();
+
+  if (_measurementTime != 0) _measurementInterval = time - _measurementTime;
+
+  _measurementTime = time | 1;                                          //"0" is reserved for no measurement
+}
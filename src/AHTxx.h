@@ -50,7 +50,14 @@
 
 
 #include <Arduino.h>
+
+#include "AHTxxTransport.h"                 //defines "AHTXX_NO_WIRE" in TWI interrupt mode
+
+#if !defined(AHTXX_NO_WIRE)
 #include <Wire.h>
+#endif
+#include "AHTxxUncertainty.h"
+#include "AHTxxSample.h"                    //defines "AHTXX_RAW_ERROR"
 
 #if defined(__AVR__)
 #include <avr/pgmspace.h>               //for Arduino AVR PROGMEM support
@@ -97,12 +104,17 @@
 /* sensor delays */
 #define AHTXX_CMD_DELAY          10      //delay between commands, in milliseconds
 #define AHTXX_MEASUREMENT_DELAY  80      //wait for measurement to complete, in milliseconds
-#define AHT1X_POWER_ON_DELAY     40      //wait for AHT1x to initialize after power-on, in milliseconds
+#define AHT1X_POWER_ON_DELAY     40      //wait for AHT1x to initialize after power-on, datasheet typical not measured, in milliseconds
 #define AHT2X_POWER_ON_DELAY     100     //wait for AHT2x to initialize after power-on, in milliseconds
+#define AHT10_MEASUREMENT_DELAY  75      //AHT10/AHT15 measurement time, datasheet typical not measured, busy sensor is read again, in milliseconds
 #define AHTXX_SOFT_RESET_DELAY   20      //less than 20 milliseconds
 
 /* misc */
-#define AHTXX_I2C_SPEED_100KHZ   1000000 //sensor speed 100KHz..400KHz, in Hz
+#define AHTXX_I2C_SPEED_100KHZ   100000  //sensor speed 100KHz..400KHz, in Hz
+#define AHTXX_I2C_TIMEOUT        25000   //max time of one I2C transaction, in microseconds
+#define AHTXX_I2C_CLEAR_PULSES   9       //SCL pulses to release SDA held by slave, 8-bits + ACK
+#define AHTXX_I2C_HALF_PERIOD    5       //SCL half period of bus clear, in microseconds, ~100KHz
+#define AHTXX_I2C_STRETCH_LIMIT  1000    //max time slave can hold SCL low during bus clear, in microseconds
 #define AHTXX_FORCE_READ_DATA    true    //force to read data via I2C
 #define AHTXX_USE_READ_DATA      false   //force to use data from previous read
 
@@ -111,8 +123,30 @@
 #define AHTXX_ACK_ERROR          0x02    //sensor didn't return ACK (not connected, broken, long wires (reduce speed), bus locked by slave (increase stretch limit))
 #define AHTXX_DATA_ERROR         0x03    //received data smaller than expected
 #define AHTXX_CRC8_ERROR         0x04    //computed CRC8 not match received CRC8, for AHT2x only
+#define AHTXX_BUS_ERROR          0x05    //I2C bus was stuck, "clearBus()" was called & measurement is lost
+#define AHTXX_NO_DATA_ERROR      0x06    //no measurement since power-on, "read...(AHTXX_USE_READ_DATA)" has nothing to return
 #define AHTXX_ERROR              0xFF    //other errors
 
+/* measurement latency histogram */
+#define AHTXX_LATENCY_BUCKETS    6       //upper bounds 85, 90, 100, 125, 250msec & +Inf, see "getLatencyBound()"
+#define AHTXX_LATENCY_INF        0xFFFF  //bound of last bucket
+
+/* measurement modes & mode policies, see "setModePolicy()" */
+#define AHTXX_NORMAL_MODE        0x00    //measurement on command, sleep between measurements
+#define AHTXX_CYCLE_MODE         0x01    //sensor measures by itself, read returns latest data, for AHT1x only
+#define AHTXX_COMMAND_MODE       0x02    //no info in datasheet, behaves as normal mode, for AHT1x only
+#define AHTXX_POLICY_ENERGY      0x00    //lowest charge per sample
+#define AHTXX_POLICY_LATENCY     0x01    //shortest time from read call to data
+#define AHTXX_CYCLE_PERIOD       80      //cycle mode measurement period, in milliseconds, unverified, see "examples/AHTxx_ModeCharacterization"
+
+/* asynchronous measurement states */
+#define AHTXX_ASYNC_IDLE         0x00    //no measurement started
+#define AHTXX_ASYNC_TRIGGER      0x01    //measurement command submitted
+#define AHTXX_ASYNC_CONVERSION   0x02    //waiting for measurement to complete
+#define AHTXX_ASYNC_READ         0x03    //data read submitted
+#define AHTXX_ASYNC_RECEIVED     0x04    //data received, not checked yet
+#define AHTXX_ASYNC_READY        0x05    //measurement completed, call "getStatus()" & "read...(AHTXX_USE_READ_DATA)"
+
 typedef enum : uint8_t
 {
   AHT1x_SENSOR = 0x00,
@@ -120,12 +154,46 @@ typedef enum : uint8_t
 }
 AHTXX_I2C_SENSOR;
 
+typedef enum : uint8_t
+{
+  AHT1x_PART   = 0x00, //any AHT1x, worst-case timings, same as AHT1x_SENSOR
+  AHT2x_PART   = 0x01, //any AHT2x, worst-case timings, same as AHT2x_SENSOR
+  AHT10_PART   = 0x02,
+  AHT15_PART   = 0x03,
+  AHT20_PART   = 0x04,
+  AHT21_PART   = 0x05,
+  AHT25_PART   = 0x06,
+  AM2301B_PART = 0x07,
+  AM2311B_PART = 0x08
+}
+AHTXX_PART;
+
+typedef struct
+{
+  uint8_t  sensorType;       //AHT1x_SENSOR or AHT2x_SENSOR
+  uint8_t  initReg;          //initialization register, AHT1X_INIT_REG or AHT2X_INIT_REG
+  uint8_t  dataSize;         //measurement frame size, in bytes
+  uint8_t  crc;              //1=frame ends with CRC8
+  uint8_t  powerOnDelay;     //wait for sensor to initialize after power-on, in milliseconds
+  uint8_t  measurementDelay; //wait for measurement to complete, in milliseconds
+  uint16_t minVoltage;       //supply voltage, in millivolts
+  uint16_t maxVoltage;
+  uint16_t maxCurrent;       //supply current during measurement, in microamperes
+}
+AHTxxPart;
+
 
 class AHTxx
 {
   public:
 
-   AHTxx(uint8_t address = AHTXX_ADDRESS_X38, AHTXX_I2C_SENSOR = AHT1x_SENSOR);
+   #if defined(AHTXX_NO_WIRE)
+   AHTxx(AHTxxTransport &transport, uint8_t address = AHTXX_ADDRESS_X38, AHTXX_I2C_SENSOR = AHT1x_SENSOR);
+   AHTxx(AHTxxTransport &transport, uint8_t address, AHTXX_PART part);
+   #else
+   AHTxx(uint8_t address = AHTXX_ADDRESS_X38, AHTXX_I2C_SENSOR = AHT1x_SENSOR, TwoWire &wire = Wire);
+   AHTxx(uint8_t address, AHTXX_PART part, TwoWire &wire = Wire);
+   #endif
 
    #if defined(ESP8266) || defined(ESP32) || defined(STM32F4xx)
    bool     begin(uint8_t sda = SDA, uint8_t scl = SCL, uint32_t speed = AHTXX_I2C_SPEED_100KHZ);
@@ -135,26 +203,101 @@ class AHTxx
 
    float    readHumidity(bool readAHT = AHTXX_FORCE_READ_DATA);
    float    readTemperature(bool readAHT = AHTXX_FORCE_READ_DATA);
+   uint32_t readRawHumidity(bool readAHT = AHTXX_FORCE_READ_DATA);
+   uint32_t readRawTemperature(bool readAHT = AHTXX_FORCE_READ_DATA);
    bool     setNormalMode();
    bool     setCycleMode();
    bool     setComandMode();
+   uint8_t  getMode();
+   uint8_t  setModePolicy(uint32_t interval, uint8_t policy = AHTXX_POLICY_ENERGY);
    bool     softReset();
+   bool     clearBus();
    uint8_t  getStatus();
+   uint8_t  getRawData(uint8_t *data);
    void     setType(AHTXX_I2C_SENSOR = AHT1x_SENSOR);
+   void     setPart(AHTXX_PART part);
+   AHTXX_PART getPart();
+   void     getPartInfo(AHTxxPart *info);
+   void     setMeasurementControl(uint8_t value = AHTXX_START_MEASUREMENT_CTRL);
+   uint8_t  getMeasurementControl();
+   void     setTransport(AHTxxTransport *transport);
+   bool     startMeasurementAsync();
+   uint8_t  updateAsync();
+   uint32_t getMeasurementInterval();
+   float    getTemperatureUncertainty();
+   float    getHumidityUncertainty();
+   uint32_t getTransactionCount();
+   uint32_t getMeasurementCount();
+   uint32_t getErrorCount();
+   uint32_t getBlockingTime();
+   uint32_t getBusRecoveryCount();
+   uint32_t getLatencyCount(uint8_t bucket);
+   uint16_t getLatencyBound(uint8_t bucket);
+   uint32_t getLatencySum();
+   void     resetStatistics();
 
 
   private:
-   AHTXX_I2C_SENSOR _sensorType;
-   uint8_t          _address;
-   uint8_t          _status;
-   uint8_t          _rawData[7] = {0, 0, 0, 0, 0, 0, 0}; //{status, RH, RH, RH+T, T, T, CRC}, CRC for AHT2x only
+   AHTXX_PART        _part;
+   uint8_t           _mode;
+   uint8_t           _address;
+   uint8_t           _status;
+   uint8_t           _measurementCtrl;
+   #if defined(AHTXX_NO_WIRE)
+   uint8_t           _buffer[7];                          //blocking transfer data, must live until transfer is done
+   volatile bool     _transferDone;
+   volatile uint8_t  _transferResult;
+   #else
+   TwoWire          *_wire;
+   AHTxxWireTransport _wireTransport;
+   #endif
+   uint8_t           _sda;
+   uint8_t           _scl;
+   uint32_t          _speed;
+   uint8_t           _rawData[7] = {0, 0, 0, 0, 0, 0, 0}; //{status, RH, RH, RH+T, T, T, CRC}, CRC for AHT2x only
+   uint8_t           _command[3];                         //asynchronous measurement command, must live until transfer is done
+   AHTxxTransport   *_transport;
+   volatile uint8_t  _asyncState;
+   volatile uint8_t  _asyncResult;
+   volatile uint32_t _asyncTime;
+   uint16_t          _asyncDelay;
+   uint32_t          _measurementTime;
+   uint32_t          _measurementInterval;
+   uint32_t          _transactionCount;
+   uint32_t          _measurementCount;
+   uint32_t          _errorCount;
+   uint32_t          _blockingTime;
+   uint32_t          _busRecoveryCount;
+   uint32_t          _latencyCounts[AHTXX_LATENCY_BUCKETS];
+   uint32_t          _latencySum;
+   volatile uint32_t _asyncStart;
 
    void     _readMeasurement();
+   bool     _startMeasurement();
+   void     _readFrame();
+   void     _countMeasurement(uint32_t startTime);
+   void     _countLatency(uint32_t latency);
+   void     _beginWire();
+   bool     _write(const uint8_t *data, uint8_t length);
+   bool     _read(uint8_t *data, uint8_t length);
+   bool     _getBusStuck();
    bool     _setInitializationRegister(uint8_t value); 
    uint8_t  _readStatusRegister();
    uint8_t  _getCalibration();
    uint8_t  _getBusy(bool readAHT = AHTXX_FORCE_READ_DATA);
    bool     _checkCRC8();
+   uint8_t  _getDataSize();
+   void     _updateMeasurementInterval();
+   uint8_t  _getPartValue(uint8_t offset);
+
+   static void _onTrigger(void *context, uint8_t result);
+   static void _onRead(void *context, uint8_t result);
+
+   #if defined(AHTXX_NO_WIRE)
+   bool     _transfer(bool isRead, uint8_t *data, uint8_t length);
+
+   static void _onTransfer(void *context, uint8_t result);
+   #endif
    
 };
 
@@ -0,0 +1,292 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "AHTxxEventDetector.h"
+
+
+/**************************************************************************/
+/*
+    Constructor
+
+    NOTE:
+    - all thresholds are in 20-bit raw units:
+      - RH 1%  = 10486 raw
+      - T  1C  = 5243 raw
+    - slopeThreshold, raw units per second, instant trigger
+    - cusumThreshold, accumulated raw change above drift, slow
+      but steady change trigger
+    - drift, tolerated raw change per sample, subtracted from every
+      change before accumulation, ~half noise sigma of channel, see
+      AHTXX_EVENT_DRIFT_HUMIDITY & AHTXX_EVENT_DRIFT_TEMPERATURE,
+      0 sums noise until it crosses cusumThreshold & fires false events
+*/
+/**************************************************************************/
+AHTxxEventDetector::AHTxxEventDetector(uint32_t slopeThreshold, uint32_t cusumThreshold, uint16_t drift)
+{
+  _callback       = 0;
+  _slopeThreshold = slopeThreshold;
+  _cusumThreshold = cusumThreshold;
+  _drift          = drift;
+  _normalInterval = AHTXX_EVENT_NORMAL_INTERVAL;
+  _eventInterval  = AHTXX_EVENT_FAST_INTERVAL;
+
+  reset();
+}
+
+
+/**************************************************************************/
+/*
+    setCallback()
+
+    Set function called on every event
+
+    NOTE:
+    - callback receives event & current slope in raw units per second
+    - called from "update()", keep it short
+*/
+/**************************************************************************/
+void AHTxxEventDetector::setCallback(AHTxxEventCallback callback)
+{
+  _callback = callback;
+}
+
+
+/**************************************************************************/
+/*
+    setSamplingInterval()
+
+    Set suggested sampling intervals without & during event, in milliseconds
+*/
+/**************************************************************************/
+void AHTxxEventDetector::setSamplingInterval(uint32_t normalInterval, uint32_t eventInterval)
+{
+  _normalInterval = normalInterval;
+  _eventInterval  = eventInterval;
+}
+
+
+/**************************************************************************/
+/*
+    update()
+
+    Feed new sample & return fired event
+
+    NOTE:
+    - rawValue, output of "readRawHumidity()" or "readRawTemperature()"
+    - time, sample timestamp in milliseconds, e.g. "millis()"
+    - AHTXX_RAW_ERROR values are ignored
+    - samples more than AHTXX_EVENT_MAX_SAMPLE_GAP apart restart
+      the detector without firing AHTXX_EVENT_END
+    - rise that turns into fall fires AHTXX_EVENT_FALL without
+      AHTXX_EVENT_END in between & vice versa
+*/
+/**************************************************************************/
+uint8_t AHTxxEventDetector::update(uint32_t rawValue, uint32_t time)
+{
+  if (rawValue > 0xFFFFF) return AHTXX_EVENT_NONE;                //no reason to continue, not a 20-bit value
+
+  uint32_t period = time - _lastTime;                             //rollover safe
+
+  if ((_empty == true) || (period > AHTXX_EVENT_MAX_SAMPLE_GAP)) //empty detector or stale sample
+  {
+    reset();
+
+    _empty     = false;
+    _lastValue = rawValue;
+    _lastTime  = time;                                            //exact, duplicate & stale checks need it
+
+    return AHTXX_EVENT_NONE;
+  }
+
+  if (period == 0) return AHTXX_EVENT_NONE;                       //no reason to continue, duplicate sample
+
+  int32_t delta = (int32_t)rawValue - (int32_t)_lastValue;        //20-bit values, no overflow
+
+  _lastValue = rawValue;
+  _lastTime  = time;
+  _slope     = (delta * 1000L) / (int32_t)period;                 //raw units per second, |delta| * 1000 < 2^31
+
+  /* two-sided CUSUM, allowance = drift per sample */
+  _cusumRise = _accumulate(_cusumRise,  delta, _drift);
+  _cusumFall = _accumulate(_cusumFall, -delta, _drift);
+
+  /* state machine */
+  uint32_t slope = (_slope >= 0) ? _slope : -_slope;
+
+  bool rise = (_cusumRise > _cusumThreshold) || ((_slope > 0) && (slope > _slopeThreshold));
+  bool fall = (_cusumFall > _cusumThreshold) || ((_slope < 0) && (slope > _slopeThreshold));
+
+  if ((rise == true) && (_state != AHTXX_EVENT_RISE)) return _start(AHTXX_EVENT_RISE); //new event or fall turned into rise
+  if ((fall == true) && (_state != AHTXX_EVENT_FALL)) return _start(AHTXX_EVENT_FALL);
+
+  if (_state == AHTXX_EVENT_NONE) return AHTXX_EVENT_NONE;
+
+  /* event is over after few quiet samples */
+  if (slope > (_slopeThreshold >> 1))
+  {
+    _quietSamples = 0;
+
+    return AHTXX_EVENT_NONE;
+  }
+
+  if (++_quietSamples >= AHTXX_EVENT_QUIET_SAMPLES)
+  {
+    _cusumRise = 0;
+    _cusumFall = 0;
+
+    _fire(AHTXX_EVENT_END);
+
+    return AHTXX_EVENT_END;
+  }
+
+  return AHTXX_EVENT_NONE;
+}
+
+
+/**************************************************************************/
+/*
+    reset()
+
+    Forget previous sample & active event
+
+    NOTE:
+    - callback is not called
+*/
+/**************************************************************************/
+void AHTxxEventDetector::reset()
+{
+  _empty        = true;
+  _lastValue    = 0;
+  _lastTime     = 0;
+  _slope        = 0;
+  _cusumRise    = 0;
+  _cusumFall    = 0;
+  _state        = AHTXX_EVENT_NONE;
+  _quietSamples = 0;
+}
+
+
+/**************************************************************************/
+/*
+    isActive()
+
+    Return true if rise/fall event is active
+*/
+/**************************************************************************/
+bool AHTxxEventDetector::isActive() const
+{
+  return (_state != AHTXX_EVENT_NONE);
+}
+
+
+/**************************************************************************/
+/*
+    getSlope()
+
+    Return last slope, in raw units per second
+*/
+/**************************************************************************/
+int32_t AHTxxEventDetector::getSlope() const
+{
+  return _slope;
+}
+
+
+/**************************************************************************/
+/*
+    getSamplingInterval()
+
+    Return suggested time to the next sample, in milliseconds
+
+    NOTE:
+    - shorter interval during event, to track transient
+*/
+/**************************************************************************/
+uint32_t AHTxxEventDetector::getSamplingInterval() const
+{
+  if (_state != AHTXX_EVENT_NONE) return _eventInterval;
+
+  return _normalInterval;
+}
+
+
+
+
+/**************************************************************************/
+/*
+    _accumulate()
+
+    One-sided CUSUM step, max(0, cusum + delta - allowance)
+*/
+/**************************************************************************/
+uint32_t AHTxxEventDetector::_accumulate(uint32_t cusum, int32_t delta, uint32_t allowance)
+{
+  if (delta > 0)
+  {
+    if ((uint32_t)delta > (0xFFFFFFFF - cusum)) return 0xFFFFFFFF; //saturate
+
+    cusum += delta;
+  }
+  else
+  {
+    uint32_t decrease = -delta;
+
+    if (decrease >= cusum) return 0;
+
+    cusum -= decrease;
+  }
+
+  if (allowance >= cusum) return 0;
+
+  return cusum - allowance;
+}
+
+
+/**************************************************************************/
+/*
+    _start()
+
+    Start rise/fall event & return it
+
+    NOTE:
+    - opposite accumulator restarts from 0, sum collected before event
+      can't fire opposite event
+*/
+/**************************************************************************/
+uint8_t AHTxxEventDetector::_start(uint8_t event)
+{
+  _quietSamples = 0;
+
+  if (event == AHTXX_EVENT_RISE) _cusumFall = 0;
+  else                           _cusumRise = 0;
+
+  _fire(event);
+
+  return event;
+}
+
+
+/**************************************************************************/
+/*
+    _fire()
+
+    Update state & call user callback
+*/
+/**************************************************************************/
+void AHTxxEventDetector::_fire(uint8_t event)
+{
+  if   (event == AHTXX_EVENT_END) _state = AHTXX_EVENT_NONE;
+  else                            _state = event;
+
+  if (_callback != 0) _callback(event, _slope);
+}
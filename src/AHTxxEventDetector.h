@@ -0,0 +1,79 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Rapid-rise/fall event detector for 20-bit raw humidity or temperature data:
+   - incremental slope & two-sided CUSUM, no sample history is stored
+   - callback fires on event start & end
+   - suggests shorter sampling interval while event is active
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_EVENT_DETECTOR_h
+#define AHTXX_EVENT_DETECTOR_h
+
+
+#include <stdint.h>
+
+
+/* list of events */
+#define AHTXX_EVENT_NONE              0x00  //nothing happened
+#define AHTXX_EVENT_RISE              0x01  //rapid rise started
+#define AHTXX_EVENT_FALL              0x02  //rapid fall started
+#define AHTXX_EVENT_END               0x03  //rise/fall event is over
+
+/* detector defaults */
+#define AHTXX_EVENT_MAX_SAMPLE_GAP    60000 //samples more than 60sec apart restart detector, in milliseconds
+#define AHTXX_EVENT_QUIET_SAMPLES     3     //event is over after 3 samples with slope < slopeThreshold / 2
+#define AHTXX_EVENT_NORMAL_INTERVAL   10000 //suggested sampling interval without event, in milliseconds
+#define AHTXX_EVENT_FAST_INTERVAL     2000  //suggested sampling interval during event, in milliseconds, see self-heating NOTE in "AHTxx.h"
+#define AHTXX_EVENT_DRIFT_HUMIDITY    524   //CUSUM allowance per sample, ~half RH noise sigma 0.1%, in raw units
+#define AHTXX_EVENT_DRIFT_TEMPERATURE 262   //CUSUM allowance per sample, ~half T noise sigma 0.1C, in raw units
+
+typedef void (*AHTxxEventCallback)(uint8_t event, int32_t slope);
+
+
+class AHTxxEventDetector
+{
+  public:
+
+   AHTxxEventDetector(uint32_t slopeThreshold, uint32_t cusumThreshold, uint16_t drift);
+
+   void     setCallback(AHTxxEventCallback callback);
+   void     setSamplingInterval(uint32_t normalInterval, uint32_t eventInterval);
+   uint8_t  update(uint32_t rawValue, uint32_t time);
+   void     reset();
+   bool     isActive() const;
+   int32_t  getSlope() const;
+   uint32_t getSamplingInterval() const;
+
+
+  private:
+   AHTxxEventCallback _callback;
+   uint32_t           _slopeThreshold;
+   uint32_t           _cusumThreshold;
+   uint16_t           _drift;
+   uint32_t           _normalInterval;
+   uint32_t           _eventInterval;
+   bool               _empty;
+   uint32_t           _lastValue;
+   uint32_t           _lastTime;
+   int32_t            _slope;
+   uint32_t           _cusumRise;
+   uint32_t           _cusumFall;
+   uint8_t            _state;
+   uint8_t            _quietSamples;
+
+   uint32_t _accumulate(uint32_t cusum, int32_t delta, uint32_t allowance);
+   uint8_t  _start(uint8_t event);
+   void     _fire(uint8_t event);
+};
+
+#endif
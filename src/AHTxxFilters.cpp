@@ -0,0 +1,335 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "AHTxxFilters.h"
+
+
+/**************************************************************************/
+/*
+    AHTxxLagFilter Constructor
+
+    NOTE:
+    - timeConstant, sensor response time in milliseconds, see
+      "AHT1X_..._TIME_CONSTANT" & "AHT2X_..._TIME_CONSTANT"
+    - maxCorrection, max distance between estimate & measured
+      value, in raw units, limits noise amplification
+    - smoothing, correction EMA alpha = 1/2^smoothing, 0=off
+*/
+/**************************************************************************/
+AHTxxLagFilter::AHTxxLagFilter(uint16_t timeConstant, uint32_t maxCorrection, uint8_t smoothing)
+{
+  _timeConstant  = timeConstant;
+  _maxCorrection = maxCorrection;
+  _smoothing     = (smoothing < 8) ? smoothing : 8;     //keeps "_correctionSum" in 32-bit
+
+  reset();
+}
+
+
+/**************************************************************************/
+/*
+    update()
+
+    Feed new sample & return estimate of current true value
+
+    NOTE:
+    - first-order sensor model, y' = (x - y) / tau, so the true
+      value is x = y + tau * y'
+    - rawValue, output of "readRawHumidity()" or "readRawTemperature()"
+    - time, sample timestamp in milliseconds, e.g. "millis()"
+    - AHTXX_RAW_ERROR values are ignored & last estimate returned
+    - derivative of noisy data amplifies noise, correction is
+      smoothed & limited to "maxCorrection"
+*/
+/**************************************************************************/
+uint32_t AHTxxLagFilter::update(uint32_t rawValue, uint32_t time)
+{
+  if (rawValue > 0xFFFFF) return _value;                                        //no reason to continue, not a 20-bit value
+
+  uint32_t period = time - _lastTime;                                           //rollover safe
+
+  if ((_empty == true) || (period > AHTXX_LAG_FILTER_MAX_SAMPLE_GAP))         //empty filter or stale sample
+  {
+    reset();
+
+    _empty     = false;
+    _lastValue = rawValue;
+    _lastTime  = time;                                                          //exact, duplicate & stale checks need it
+    _value     = rawValue;
+
+    return _value;
+  }
+
+  if (period == 0) return _value;                                               //no reason to continue, duplicate sample
+
+  /* correction = tau * dy/dt */
+  int32_t delta = (int32_t)rawValue - (int32_t)_lastValue;
+  int64_t slope = ((int64_t)delta * _timeConstant) / (int32_t)period;          //2^20 * 2^16 doesn't fit in 32-bit, short period doesn't fit either
+
+  if      (slope >  (int64_t)_maxCorrection) slope =  _maxCorrection;          //limit before smoothing, single spike can't dominate
+  else if (slope < -(int64_t)_maxCorrection) slope = -(int64_t)_maxCorrection;
+
+  int32_t correction = (int32_t)slope;                                          //fits after limit
+
+  _lastValue = rawValue;
+  _lastTime  = time;
+
+  /* EMA, sum = sum - sum/2^n + new */
+  _correctionSum += correction - (_correctionSum >> _smoothing);
+
+  int32_t estimate = (int32_t)rawValue + (_correctionSum >> _smoothing);
+
+  if      (estimate < 0)       estimate = 0;
+  else if (estimate > 0xFFFFF) estimate = 0xFFFFF;
+
+  _value = estimate;
+
+  return _value;
+}
+
+
+/**************************************************************************/
+/*
+    reset()
+
+    Forget previous samples
+*/
+/**************************************************************************/
+void AHTxxLagFilter::reset()
+{
+  _empty         = true;
+  _lastValue     = 0;
+  _lastTime      = 0;
+  _correctionSum = 0;
+  _value         = 0;
+}
+
+
+/**************************************************************************/
+/*
+    getValue()
+
+    Return last estimate, in raw units
+*/
+/**************************************************************************/
+uint32_t AHTxxLagFilter::getValue() const
+{
+  return _value;
+}
+
+
+/**************************************************************************/
+/*
+    getCorrection()
+
+    Return last smoothed correction, in raw units
+*/
+/**************************************************************************/
+int32_t AHTxxLagFilter::getCorrection() const
+{
+  return _correctionSum >> _smoothing;
+}
+
+
+/**************************************************************************/
+/*
+    AHTxxEmaFilter Constructor
+
+    NOTE:
+    - alpha = 1/2^shift, shift 0..AHTXX_EMA_FILTER_MAX_SHIFT
+    - equivalent float EMA, y = y + (x - y) * alpha
+*/
+/**************************************************************************/
+AHTxxEmaFilter::AHTxxEmaFilter(uint8_t shift)
+{
+  _shift = (shift < AHTXX_EMA_FILTER_MAX_SHIFT) ? shift : AHTXX_EMA_FILTER_MAX_SHIFT;
+
+  reset();
+}
+
+
+/**************************************************************************/
+/*
+    update()
+
+    Feed new sample & return smoothed value
+
+    NOTE:
+    - sum = sum - sum/2^n + x, value = sum/2^n
+    - first sample initializes filter, no ramp from zero
+    - AHTXX_RAW_ERROR values are ignored & last value returned
+*/
+/**************************************************************************/
+uint32_t AHTxxEmaFilter::update(uint32_t rawValue)
+{
+  if (rawValue > 0xFFFFF) return getValue(); //no reason to continue, not a 20-bit value
+
+  if (_empty == true)
+  {
+    _sum   = rawValue << _shift;
+    _empty = false;
+  }
+  else
+  {
+    _sum = _sum - (_sum >> _shift) + rawValue;
+  }
+
+  return getValue();
+}
+
+
+/**************************************************************************/
+/*
+    reset()
+
+    Forget previous samples
+*/
+/**************************************************************************/
+void AHTxxEmaFilter::reset()
+{
+  _empty = true;
+  _sum   = 0;
+}
+
+
+/**************************************************************************/
+/*
+    getValue()
+
+    Return smoothed value, in raw units
+*/
+/**************************************************************************/
+uint32_t AHTxxEmaFilter::getValue() const
+{
+  return _sum >> _shift;
+}
+
+
+/**************************************************************************/
+/*
+    AHTxxKalmanFilter Constructor
+
+    NOTE:
+    - processNoise, Q, variance of true value change between
+      samples, in raw units^2
+    - measurementNoise, R, variance of sensor noise, in raw units^2
+    - RH 1% = 10486 raw, T 1C = 5243 raw
+*/
+/**************************************************************************/
+AHTxxKalmanFilter::AHTxxKalmanFilter(uint32_t processNoise, uint32_t measurementNoise)
+{
+  _processNoise     = processNoise;
+  _measurementNoise = (measurementNoise != 0) ? measurementNoise : 1; //R=0 leads to division by zero on first sample with P=0
+
+  reset();
+}
+
+
+/**************************************************************************/
+/*
+    update()
+
+    Feed new sample & return filtered value
+
+    NOTE:
+    - predict: P = P + Q
+    - update:  K = P / (P + R), x = x + K * (z - x), P = (1 - K) * P
+    - K stored as 0.16 fixed-point, x as raw * 2^8
+    - 64-bit math is used once per sample, 20-bit * 16-bit doesn't
+      fit in 32-bit
+    - AHTXX_RAW_ERROR values are ignored & last value returned
+*/
+/**************************************************************************/
+uint32_t AHTxxKalmanFilter::update(uint32_t rawValue)
+{
+  if (rawValue > 0xFFFFF) return getValue();                                 //no reason to continue, not a 20-bit value
+
+  if (_empty == true)
+  {
+    _estimate = rawValue << AHTXX_KALMAN_FRACTION_BITS;
+    _variance = _measurementNoise;                                           //first sample is as good as sensor
+    _empty    = false;
+
+    return getValue();
+  }
+
+  /* predict */
+  uint32_t variance = _variance + _processNoise;
+
+  if (variance < _variance) variance = 0xFFFFFFFF;                           //saturate
+
+  /* update */
+  _gain = ((uint64_t)variance << 16) / ((uint64_t)variance + _measurementNoise + 1);
+
+  int32_t innovation = (int32_t)(rawValue << AHTXX_KALMAN_FRACTION_BITS) - (int32_t)_estimate;
+
+  _estimate += ((int64_t)innovation * _gain) >> 16;
+  _variance  = ((uint64_t)variance * (0x10000 - _gain)) >> 16;
+
+  return getValue();
+}
+
+
+/**************************************************************************/
+/*
+    reset()
+
+    Forget previous samples
+*/
+/**************************************************************************/
+void AHTxxKalmanFilter::reset()
+{
+  _empty    = true;
+  _estimate = 0;
+  _variance = 0;
+  _gain     = 0;
+}
+
+
+/**************************************************************************/
+/*
+    getValue()
+
+    Return filtered value, in raw units
+*/
+/**************************************************************************/
+uint32_t AHTxxKalmanFilter::getValue() const
+{
+  return (_estimate + (1UL << (AHTXX_KALMAN_FRACTION_BITS - 1))) >> AHTXX_KALMAN_FRACTION_BITS; //round to nearest
+}
+
+
+/**************************************************************************/
+/*
+    getGain()
+
+    Return last Kalman gain, 0.16 fixed-point, 65535=trust sample
+*/
+/**************************************************************************/
+uint16_t AHTxxKalmanFilter::getGain() const
+{
+  return _gain;
+}
+
+
+/**************************************************************************/
+/*
+    getVariance()
+
+    Return estimate variance, in raw units^2
+*/
+/**************************************************************************/
+uint32_t AHTxxKalmanFilter::getVariance() const
+{
+  return _variance;
+}
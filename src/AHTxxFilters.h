@@ -0,0 +1,116 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Filters for 20-bit raw humidity or temperature data:
+   - AHTxxLagFilter, first-order inverse of sensor response with noise limiting
+   - AHTxxEmaFilter, exponential moving average with 1/2^n alpha
+   - AHTxxKalmanFilter, 1-D Kalman with constant process & measurement noise
+   - fixed-point math & O(1) memory, no float per sample
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_FILTERS_h
+#define AHTXX_FILTERS_h
+
+
+#include <stdint.h>
+
+
+/* sensor response, time to reach 63% of step, same for AHT1x & AHT2x */
+#define AHT1X_HUMIDITY_TIME_CONSTANT     8000  //RH response time 8sec, in milliseconds
+#define AHT1X_TEMPERATURE_TIME_CONSTANT  5000  //T response time 5..30sec depends on airflow, in milliseconds
+#define AHT2X_HUMIDITY_TIME_CONSTANT     8000  //RH response time 8sec, in milliseconds
+#define AHT2X_TEMPERATURE_TIME_CONSTANT  5000  //T response time 5..30sec depends on airflow, in milliseconds
+
+/* lag filter defaults */
+#define AHTXX_HUMIDITY_MAX_CORRECTION    52429 //max correction 5%RH, in raw units
+#define AHTXX_TEMPERATURE_MAX_CORRECTION 10486 //max correction 2C, in raw units
+#define AHTXX_LAG_FILTER_SMOOTHING       2     //correction EMA, alpha = 1/2^2
+#define AHTXX_LAG_FILTER_MAX_SAMPLE_GAP  60000 //samples more than 60sec apart restart filter, in milliseconds
+
+/* EMA filter defaults */
+#define AHTXX_EMA_FILTER_SHIFT           3     //alpha = 1/2^3, ~8 samples window
+#define AHTXX_EMA_FILTER_MAX_SHIFT       11    //2^20 * 2^11 fits in 32-bit
+
+/* Kalman filter defaults, variance in raw units^2 */
+#define AHTXX_KALMAN_PROCESS_NOISE       100   //Q, expected change between samples ~10 raw
+#define AHTXX_KALMAN_MEASUREMENT_NOISE   62500 //R, RH resolution 0.024% ~250 raw
+#define AHTXX_KALMAN_FRACTION_BITS       8     //estimate stored as raw * 2^8
+
+
+class AHTxxLagFilter
+{
+  public:
+
+   AHTxxLagFilter(uint16_t timeConstant  = AHT2X_HUMIDITY_TIME_CONSTANT,
+                  uint32_t maxCorrection = AHTXX_HUMIDITY_MAX_CORRECTION,
+                  uint8_t  smoothing     = AHTXX_LAG_FILTER_SMOOTHING);
+
+   uint32_t update(uint32_t rawValue, uint32_t time);
+   void     reset();
+   uint32_t getValue() const;
+   int32_t  getCorrection() const;
+
+
+  private:
+   uint16_t _timeConstant;
+   uint32_t _maxCorrection;
+   uint8_t  _smoothing;
+   bool     _empty;
+   uint32_t _lastValue;
+   uint32_t _lastTime;
+   int32_t  _correctionSum;
+   uint32_t _value;
+};
+
+
+class AHTxxEmaFilter
+{
+  public:
+
+   AHTxxEmaFilter(uint8_t shift = AHTXX_EMA_FILTER_SHIFT);
+
+   uint32_t update(uint32_t rawValue);
+   void     reset();
+   uint32_t getValue() const;
+
+
+  private:
+   uint8_t  _shift;
+   bool     _empty;
+   uint32_t _sum;
+};
+
+
+class AHTxxKalmanFilter
+{
+  public:
+
+   AHTxxKalmanFilter(uint32_t processNoise     = AHTXX_KALMAN_PROCESS_NOISE,
+                     uint32_t measurementNoise = AHTXX_KALMAN_MEASUREMENT_NOISE);
+
+   uint32_t update(uint32_t rawValue);
+   void     reset();
+   uint32_t getValue() const;
+   uint16_t getGain() const;
+   uint32_t getVariance() const;
+
+
+  private:
+   uint32_t _processNoise;
+   uint32_t _measurementNoise;
+   bool     _empty;
+   uint32_t _estimate;
+   uint32_t _variance;
+   uint16_t _gain;
+};
+
+#endif
@@ -0,0 +1,377 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "AHTxxFusion.h"
+
+
+/**************************************************************************/
+/*
+    Constructor
+
+    NOTE:
+    - thresholds are max distance from median, in raw units
+    - RH 1% = 10486 raw, T 1C = 5243 raw
+*/
+/**************************************************************************/
+AHTxxFusion::AHTxxFusion(uint32_t humidityThreshold, uint32_t temperatureThreshold)
+{
+  _acceptedMask         = 0;
+  _accepted             = 0;
+  _status               = AHTXX_ERROR;
+  _humidity             = AHTXX_RAW_ERROR;
+  _temperature          = AHTXX_RAW_ERROR;
+  _humidityThreshold    = humidityThreshold;
+  _temperatureThreshold = temperatureThreshold;
+}
+
+
+/**************************************************************************/
+/*
+    addSensor()
+
+    Add sensor to the group
+
+    NOTE:
+    - call "begin()" of every sensor before first "update()"
+    - true=success, false=group is full or measurement in progress
+*/
+/**************************************************************************/
+bool AHTxxFusion::addSensor(AHTxx *sensor)
+{
+  uint8_t index = _group.getCount();
+
+  if (index >= AHTXX_FUSION_MAX_SENSORS) return false;  //no reason to continue, group is full
+
+  if (_group.addSensor(sensor) != true) return false;   //no reason to continue, measurement in progress
+
+  _trust[index] = AHTXX_FUSION_TRUST_DEFAULT;
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    update()
+
+    Measure all sensors & fuse, return number of accepted sensors
+
+    NOTE:
+    - blocking, all conversions overlap, takes ~80msec
+      for any number of sensors
+    - 0=no trustworthy value, see "getStatus()"
+*/
+/**************************************************************************/
+uint8_t AHTxxFusion::update()
+{
+  if (_group.measure() != true) return 0;
+
+  _fuse();
+
+  return _accepted;
+}
+
+
+/**************************************************************************/
+/*
+    start()
+
+    Start measurement on all sensors & return without waiting
+
+    NOTE:
+    - call "poll()" from loop until it returns true
+    - true=started, false=no sensors or measurement in progress
+*/
+/**************************************************************************/
+bool AHTxxFusion::start()
+{
+  return _group.start();
+}
+
+
+/**************************************************************************/
+/*
+    poll()
+
+    Advance measurement of all sensors
+
+    NOTE:
+    - true=fused value is updated, false=measurement in progress
+    - sensors not completed after AHTXX_GROUP_TIMEOUT are rejected
+*/
+/**************************************************************************/
+bool AHTxxFusion::poll()
+{
+  if (_group.poll() != true) return false;
+
+  _fuse();
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    getStatus()
+
+    Return fusion status
+
+    NOTE:
+    - AHTXX_NO_ERROR=at least one sensor accepted
+    - AHTXX_ERROR=all sensors rejected or no measurement yet
+*/
+/**************************************************************************/
+uint8_t AHTxxFusion::getStatus()
+{
+  return _status;
+}
+
+
+/**************************************************************************/
+/*
+    getRawHumidity()
+
+    Return fused 20-bit raw humidity, AHTXX_RAW_ERROR if no sensor accepted
+*/
+/**************************************************************************/
+uint32_t AHTxxFusion::getRawHumidity()
+{
+  return _humidity;
+}
+
+
+/**************************************************************************/
+/*
+    getRawTemperature()
+
+    Return fused 20-bit raw temperature, AHTXX_RAW_ERROR if no sensor accepted
+*/
+/**************************************************************************/
+uint32_t AHTxxFusion::getRawTemperature()
+{
+  return _temperature;
+}
+
+
+/**************************************************************************/
+/*
+    getHumidity()
+
+    Return fused humidity, in %
+
+    NOTE:
+    - returns AHTXX_ERROR if no sensor accepted
+*/
+/**************************************************************************/
+float AHTxxFusion::getHumidity()
+{
+  if (_status != AHTXX_NO_ERROR) return AHTXX_ERROR;
+
+  return ((float)_humidity / 0x100000) * 100;
+}
+
+
+/**************************************************************************/
+/*
+    getTemperature()
+
+    Return fused temperature, in C
+
+    NOTE:
+    - returns AHTXX_ERROR if no sensor accepted
+*/
+/**************************************************************************/
+float AHTxxFusion::getTemperature()
+{
+  if (_status != AHTXX_NO_ERROR) return AHTXX_ERROR;
+
+  return ((float)_temperature / 0x100000) * 200 - 50;
+}
+
+
+/**************************************************************************/
+/*
+    getAccepted()
+
+    Return number of sensors used in last fused value
+*/
+/**************************************************************************/
+uint8_t AHTxxFusion::getAccepted()
+{
+  return _accepted;
+}
+
+
+/**************************************************************************/
+/*
+    isAccepted()
+
+    Return true if sensor was used in last fused value
+
+    NOTE:
+    - index is order of "addSensor()" calls, starts from 0
+*/
+/**************************************************************************/
+bool AHTxxFusion::isAccepted(uint8_t index)
+{
+  if (index >= _group.getCount()) return false;
+
+  return ((_acceptedMask & (1 << index)) != 0);
+}
+
+
+/**************************************************************************/
+/*
+    getTrust()
+
+    Return sensor trust score, 0..255
+
+    NOTE:
+    - accepted sample, score += (255 - score) / 8
+    - rejected sample, score /= 2
+*/
+/**************************************************************************/
+uint8_t AHTxxFusion::getTrust(uint8_t index)
+{
+  if (index >= _group.getCount()) return 0;
+
+  return _trust[index];
+}
+
+
+
+
+/**************************************************************************/
+/*
+    _fuse()
+
+    Vote & update fused value & trust scores
+
+    NOTE:
+    - median of all sensors with AHTXX_NO_ERROR status is reference,
+      outlier can't drag it unlike mean
+*/
+/**************************************************************************/
+void AHTxxFusion::_fuse()
+{
+  uint32_t humidity[AHTXX_FUSION_MAX_SENSORS];
+  uint32_t temperature[AHTXX_FUSION_MAX_SENSORS];
+  uint32_t sortedHumidity[AHTXX_FUSION_MAX_SENSORS];
+  uint32_t sortedTemperature[AHTXX_FUSION_MAX_SENSORS];
+  uint8_t  count = _group.getCount();
+  uint8_t  valid = 0;
+
+  /* collect sensors without errors */
+  for (uint8_t i = 0; i < count; i++)
+  {
+    humidity[i]    = AHTXX_RAW_ERROR;
+    temperature[i] = AHTXX_RAW_ERROR;
+
+    if (_group.getStatus(i) != AHTXX_NO_ERROR) continue; //timeout or error
+
+    humidity[i]    = _group.getSensor(i)->readRawHumidity(AHTXX_USE_READ_DATA);
+    temperature[i] = _group.getSensor(i)->readRawTemperature(AHTXX_USE_READ_DATA);
+
+    sortedHumidity[valid]    = humidity[i];
+    sortedTemperature[valid] = temperature[i];
+
+    valid++;
+  }
+
+  uint32_t medianHumidity    = _median(sortedHumidity, valid);
+  uint32_t medianTemperature = _median(sortedTemperature, valid);
+
+  /* vote */
+  uint32_t sumHumidity    = 0;
+  uint32_t sumTemperature = 0;
+
+  _acceptedMask = 0;
+  _accepted     = 0;
+
+  for (uint8_t i = 0; i < count; i++)
+  {
+    bool accepted = false;
+
+    if (humidity[i] != AHTXX_RAW_ERROR)
+    {
+      uint32_t distanceHumidity    = (humidity[i] > medianHumidity)       ? (humidity[i] - medianHumidity)       : (medianHumidity - humidity[i]);
+      uint32_t distanceTemperature = (temperature[i] > medianTemperature) ? (temperature[i] - medianTemperature) : (medianTemperature - temperature[i]);
+
+      accepted = (distanceHumidity <= _humidityThreshold) && (distanceTemperature <= _temperatureThreshold);
+    }
+
+    if (accepted == true)
+    {
+      sumHumidity    += humidity[i];                    //5 * 2^20 fits in 32-bit
+      sumTemperature += temperature[i];
+
+      _acceptedMask |= (1 << i);
+      _accepted++;
+
+      _trust[i] += (255 - _trust[i]) >> 3;
+    }
+    else
+    {
+      _trust[i] >>= 1;
+    }
+  }
+
+  if (_accepted == 0)
+  {
+    _status      = AHTXX_ERROR;
+    _humidity    = AHTXX_RAW_ERROR;
+    _temperature = AHTXX_RAW_ERROR;
+
+    return;
+  }
+
+  _status      = AHTXX_NO_ERROR;
+  _humidity    = (sumHumidity    + (_accepted >> 1)) / _accepted; //round to nearest
+  _temperature = (sumTemperature + (_accepted >> 1)) / _accepted;
+}
+
+
+/**************************************************************************/
+/*
+    _median()
+
+    Sort values in place & return median
+
+    NOTE:
+    - insertion sort, max AHTXX_FUSION_MAX_SENSORS values
+    - even count returns average of two middle values
+*/
+/**************************************************************************/
+uint32_t AHTxxFusion::_median(uint32_t *values, uint8_t count)
+{
+  if (count == 0) return AHTXX_RAW_ERROR;
+
+  for (uint8_t i = 1; i < count; i++)
+  {
+    uint32_t value = values[i];
+    uint8_t  j     = i;
+
+    while ((j > 0) && (values[j - 1] > value))
+    {
+      values[j] = values[j - 1];
+
+      j--;
+    }
+
+    values[j] = value;
+  }
+
+  if ((count & 0x01) != 0) return values[count >> 1];
+
+  return (values[(count >> 1) - 1] + values[count >> 1]) >> 1;
+}
@@ -0,0 +1,69 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Redundant sensor fusion:
+   - measures all sensors in parallel via asynchronous measurement,
+     see "AHTxxGroup.h"
+   - rejects sensors with error status or value too far from median
+   - fused value is average of accepted sensors, integer math only
+   - per-sensor trust score, grows with agreement & halves on rejection
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_FUSION_h
+#define AHTXX_FUSION_h
+
+
+#include "AHTxxGroup.h"
+
+
+#define AHTXX_FUSION_MAX_SENSORS            5      //max sensors in one group
+#define AHTXX_FUSION_HUMIDITY_THRESHOLD     31457  //max distance from median 3%RH, in raw units
+#define AHTXX_FUSION_TEMPERATURE_THRESHOLD  5243   //max distance from median 1C, in raw units
+#define AHTXX_FUSION_TRUST_DEFAULT          128    //initial trust score, 0..255
+
+
+class AHTxxFusion
+{
+  public:
+
+   AHTxxFusion(uint32_t humidityThreshold = AHTXX_FUSION_HUMIDITY_THRESHOLD, uint32_t temperatureThreshold = AHTXX_FUSION_TEMPERATURE_THRESHOLD);
+
+   bool     addSensor(AHTxx *sensor);
+   uint8_t  update();
+   bool     start();
+   bool     poll();
+   uint8_t  getStatus();
+   uint32_t getRawHumidity();
+   uint32_t getRawTemperature();
+   float    getHumidity();
+   float    getTemperature();
+   uint8_t  getAccepted();
+   bool     isAccepted(uint8_t index);
+   uint8_t  getTrust(uint8_t index);
+
+
+  private:
+   AHTxxGroup _group;
+   uint8_t    _trust[AHTXX_FUSION_MAX_SENSORS];
+   uint8_t    _acceptedMask;
+   uint8_t    _accepted;
+   uint8_t    _status;
+   uint32_t   _humidity;
+   uint32_t   _temperature;
+   uint32_t   _humidityThreshold;
+   uint32_t   _temperatureThreshold;
+
+   void     _fuse();
+   uint32_t _median(uint32_t *values, uint8_t count);
+};
+
+#endif
@@ -0,0 +1,241 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "AHTxxGroup.h"
+
+
+/**************************************************************************/
+/*
+    Constructor
+*/
+/**************************************************************************/
+AHTxxGroup::AHTxxGroup()
+{
+  _count     = 0;
+  _readyMask = 0;
+  _active    = false;
+  _measured  = false;
+  _startTime = 0;
+  _skew      = 0;
+}
+
+
+/**************************************************************************/
+/*
+    addSensor()
+
+    Add sensor to the group
+
+    NOTE:
+    - call "begin()" of every sensor before first "start()"
+    - index is order of "addSensor()" calls, starts from 0
+    - true=success, false=group is full or measurement in progress
+*/
+/**************************************************************************/
+bool AHTxxGroup::addSensor(AHTxx *sensor)
+{
+  if ((_count >= AHTXX_GROUP_MAX_SENSORS) || (_active == true)) return false; //no reason to continue
+
+  _sensors[_count] = sensor;
+
+  _count++;
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    getCount()
+
+    Return number of sensors in the group
+*/
+/**************************************************************************/
+uint8_t AHTxxGroup::getCount()
+{
+  return _count;
+}
+
+
+/**************************************************************************/
+/*
+    getSensor()
+
+    Return sensor by index, 0 if index is out of range
+*/
+/**************************************************************************/
+AHTxx *AHTxxGroup::getSensor(uint8_t index)
+{
+  if (index >= _count) return 0;
+
+  return _sensors[index];
+}
+
+
+/**************************************************************************/
+/*
+    measure()
+
+    Start measurement on all sensors & wait until all are ready or
+    timeout
+
+    NOTE:
+    - blocking, takes ~80msec for any number of sensors
+    - ESP32, gives 1 tick to other tasks while waiting
+    - true=measured, check "getStatus()" of every sensor, false=no
+      sensors or measurement in progress
+*/
+/**************************************************************************/
+bool AHTxxGroup::measure()
+{
+  if (start() != true) return false;
+
+  while (poll() != true)
+  {
+    #if defined(ESP32)
+    vTaskDelay(1);                                       //let other task & idle task run
+    #else
+    yield();                                             //ESP8266 watchdog
+    #endif
+  }
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    start()
+
+    Send measurement command to all sensors back-to-back
+
+    NOTE:
+    - nothing else is done between commands, skew is only I2C time,
+      ~400usec per sensor at 100KHz with "Wire.h" transport
+    - failed start is caught by "getStatus()"
+    - call "poll()" from loop until it returns true
+    - true=started, false=no sensors or measurement in progress
+*/
+/**************************************************************************/
+bool AHTxxGroup::start()
+{
+  if ((_count == 0) || (_active == true)) return false; //no reason to continue
+
+  uint32_t firstTime = micros();
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    _sensors[i]->startMeasurementAsync();
+  }
+
+  _skew      = micros() - firstTime;
+  _startTime = millis();
+  _readyMask = 0;
+  _active    = true;
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    poll()
+
+    Advance measurement of all sensors
+
+    NOTE:
+    - true=all sensors are ready or AHTXX_GROUP_TIMEOUT is over,
+      false=in progress
+*/
+/**************************************************************************/
+bool AHTxxGroup::poll()
+{
+  if (_active != true) return false;
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    if (_sensors[i]->updateAsync() == AHTXX_ASYNC_READY) _readyMask |= (1 << i);
+  }
+
+  bool ready = (_readyMask == (uint8_t)((1 << _count) - 1));
+
+  if ((ready != true) && ((millis() - _startTime) < AHTXX_GROUP_TIMEOUT)) return false;
+
+  _active   = false;
+  _measured = true;
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    isActive()
+
+    Return true if measurement is in progress
+*/
+/**************************************************************************/
+bool AHTxxGroup::isActive()
+{
+  return _active;
+}
+
+
+/**************************************************************************/
+/*
+    getStartTime()
+
+    Return "millis()" of last "start()"
+*/
+/**************************************************************************/
+uint32_t AHTxxGroup::getStartTime()
+{
+  return _startTime;
+}
+
+
+/**************************************************************************/
+/*
+    getSkew()
+
+    Return time between first & last measurement command, in microseconds
+*/
+/**************************************************************************/
+uint32_t AHTxxGroup::getSkew()
+{
+  return _skew;
+}
+
+
+/**************************************************************************/
+/*
+    getStatus()
+
+    Return sensor status in last measurement
+
+    NOTE:
+    - index is order of "addSensor()" calls, starts from 0
+    - AHTXX_BUSY_ERROR=sensor didn't complete before timeout or
+      measurement in progress
+    - AHTXX_ERROR=wrong index or no measurement yet
+    - doesn't call "updateAsync()", sensor state is not changed
+*/
+/**************************************************************************/
+uint8_t AHTxxGroup::getStatus(uint8_t index)
+{
+  if ((index >= _count) || (_measured != true)) return AHTXX_ERROR;
+
+  if ((_active == true) || ((_readyMask & (1 << index)) == 0)) return AHTXX_BUSY_ERROR;
+
+  return _sensors[index]->getStatus();
+}
@@ -0,0 +1,60 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Group of sensors measured together:
+   - starts asynchronous measurement of all sensors back-to-back &
+     polls them until all are ready or timeout, conversions overlap
+   - remembers which sensors completed, status getter doesn't touch
+     sensor state machines
+   - shared by "AHTxxFusion", "AHTxxSnapshot" & "AHTxxSampler"
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_GROUP_h
+#define AHTXX_GROUP_h
+
+
+#include "AHTxx.h"
+
+
+#define AHTXX_GROUP_MAX_SENSORS  8     //max sensors in one group, bits of ready mask
+#define AHTXX_GROUP_TIMEOUT      500   //max time for all sensors to complete, in milliseconds
+
+
+class AHTxxGroup
+{
+  public:
+
+   AHTxxGroup();
+
+   bool     addSensor(AHTxx *sensor);
+   uint8_t  getCount();
+   AHTxx   *getSensor(uint8_t index);
+   bool     measure();
+   bool     start();
+   bool     poll();
+   bool     isActive();
+   uint32_t getStartTime();
+   uint32_t getSkew();
+   uint8_t  getStatus(uint8_t index);
+
+
+  private:
+   AHTxx   *_sensors[AHTXX_GROUP_MAX_SENSORS];
+   uint8_t  _count;
+   uint8_t  _readyMask;
+   bool     _active;
+   bool     _measured;
+   uint32_t _startTime;
+   uint32_t _skew;
+};
+
+#endif
@@ -0,0 +1,241 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "AHTxxHistogram.h"
+
+
+/**************************************************************************/
+/*
+    Constructor
+*/
+/**************************************************************************/
+AHTxxHistogram::AHTxxHistogram()
+{
+  clear();
+}
+
+
+/**************************************************************************/
+/*
+    clear()
+
+    Reset all bucket counts to zero
+*/
+/**************************************************************************/
+void AHTxxHistogram::clear()
+{
+  for (uint16_t bucket = 0; bucket < AHTXX_HISTOGRAM_BUCKETS; bucket++)
+  {
+    _counts[bucket] = 0;
+  }
+}
+
+
+/**************************************************************************/
+/*
+    add()
+
+    Add 20-bit raw humidity or temperature value to the histogram
+
+    NOTE:
+    - use "readRawHumidity()" or "readRawTemperature()" output
+    - "weight" is 1 for sample counts, use time between samples
+      in seconds to accumulate time spent in each band
+    - AHTXX_RAW_ERROR & out of range values are ignored
+*/
+/**************************************************************************/
+void AHTxxHistogram::add(uint32_t rawValue, uint32_t weight)
+{
+  if (rawValue > 0xFFFFF) return;                    //no reason to continue, not a 20-bit value
+
+  _addCount(rawValue >> AHTXX_HISTOGRAM_SHIFT, weight);
+}
+
+
+/**************************************************************************/
+/*
+    merge()
+
+    Add bucket counts of another histogram
+*/
+/**************************************************************************/
+void AHTxxHistogram::merge(const AHTxxHistogram &histogram)
+{
+  for (uint16_t bucket = 0; bucket < AHTXX_HISTOGRAM_BUCKETS; bucket++)
+  {
+    _addCount(bucket, histogram._counts[bucket]);
+  }
+}
+
+
+/**************************************************************************/
+/*
+    merge()
+
+    Add bucket counts of serialized histogram
+
+    NOTE:
+    - see "serialize()" NOTE for data structure
+    - true=success, false=buffer too small or histogram geometry
+      doesn't match
+*/
+/**************************************************************************/
+bool AHTxxHistogram::merge(const uint8_t *buffer, uint16_t length)
+{
+  if (length < AHTXX_HISTOGRAM_SERIALIZED_SIZE)          return false; //no reason to continue, buffer too small
+  if (buffer[0] != AHTXX_HISTOGRAM_VERSION)              return false; //unknown serialized form
+  if (buffer[1] != AHTXX_HISTOGRAM_SHIFT)                return false; //different bucket width
+  if ((buffer[2] | ((uint16_t)buffer[3] << 8)) != AHTXX_HISTOGRAM_BUCKETS) return false;
+
+  buffer += AHTXX_HISTOGRAM_HEADER_SIZE;
+
+  for (uint16_t bucket = 0; bucket < AHTXX_HISTOGRAM_BUCKETS; bucket++)
+  {
+    uint32_t count   = buffer[3];                                      //little-endian 32-bit count
+             count <<= 8;
+             count  |= buffer[2];
+             count <<= 8;
+             count  |= buffer[1];
+             count <<= 8;
+             count  |= buffer[0];
+
+    _addCount(bucket, count);
+
+    buffer += 4;
+  }
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    serialize()
+
+    Write histogram to buffer & return number of written bytes
+
+    NOTE:
+    - data structure:
+      - {version, shift, buckets LSB, buckets MSB, count0 LSB..MSB, count1 LSB..MSB, ...}
+    - buffer must be at least AHTXX_HISTOGRAM_SERIALIZED_SIZE bytes,
+      otherwise 0 is returned
+*/
+/**************************************************************************/
+uint16_t AHTxxHistogram::serialize(uint8_t *buffer, uint16_t length) const
+{
+  if (length < AHTXX_HISTOGRAM_SERIALIZED_SIZE) return 0; //no reason to continue, buffer too small
+
+  *buffer++ = AHTXX_HISTOGRAM_VERSION;
+  *buffer++ = AHTXX_HISTOGRAM_SHIFT;
+  *buffer++ = AHTXX_HISTOGRAM_BUCKETS & 0xFF;
+  *buffer++ = AHTXX_HISTOGRAM_BUCKETS >> 8;
+
+  for (uint16_t bucket = 0; bucket < AHTXX_HISTOGRAM_BUCKETS; bucket++)
+  {
+    uint32_t count = _counts[bucket];
+
+    *buffer++ = count;
+    *buffer++ = count >> 8;
+    *buffer++ = count >> 16;
+    *buffer++ = count >> 24;
+  }
+
+  return AHTXX_HISTOGRAM_SERIALIZED_SIZE;
+}
+
+
+/**************************************************************************/
+/*
+    getCount()
+
+    Return bucket count, 0 if bucket doesn't exist
+*/
+/**************************************************************************/
+uint32_t AHTxxHistogram::getCount(uint16_t bucket) const
+{
+  if (bucket >= AHTXX_HISTOGRAM_BUCKETS) return 0;
+
+  return _counts[bucket];
+}
+
+
+/**************************************************************************/
+/*
+    getTotal()
+
+    Return sum of all bucket counts
+
+    NOTE:
+    - saturates at 0xFFFFFFFF
+*/
+/**************************************************************************/
+uint32_t AHTxxHistogram::getTotal() const
+{
+  uint32_t total = 0;
+
+  for (uint16_t bucket = 0; bucket < AHTXX_HISTOGRAM_BUCKETS; bucket++)
+  {
+    uint32_t count = _counts[bucket];
+
+    if (count > (0xFFFFFFFF - total)) return 0xFFFFFFFF;
+
+    total += count;
+  }
+
+  return total;
+}
+
+
+/**************************************************************************/
+/*
+    getBucketLow()
+
+    Return lowest 20-bit raw value of the bucket
+
+    NOTE:
+    - RH = (raw / 2^20) * 100%, T = (raw / 2^20) * 200 - 50C
+*/
+/**************************************************************************/
+uint32_t AHTxxHistogram::getBucketLow(uint16_t bucket) const
+{
+  return (uint32_t)bucket << AHTXX_HISTOGRAM_SHIFT;
+}
+
+
+/**************************************************************************/
+/*
+    getBucketHigh()
+
+    Return highest 20-bit raw value of the bucket
+*/
+/**************************************************************************/
+uint32_t AHTxxHistogram::getBucketHigh(uint16_t bucket) const
+{
+  return getBucketLow(bucket) | ((1UL << AHTXX_HISTOGRAM_SHIFT) - 1);
+}
+
+
+
+
+/**************************************************************************/
+/*
+    _addCount()
+
+    Add weight to bucket count without overflow
+*/
+/**************************************************************************/
+void AHTxxHistogram::_addCount(uint16_t bucket, uint32_t weight)
+{
+  if   (weight > (0xFFFFFFFF - _counts[bucket])) _counts[bucket] = 0xFFFFFFFF; //saturate
+  else                                           _counts[bucket] += weight;
+}
@@ -0,0 +1,63 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Streaming fixed-bucket histogram of 20-bit raw humidity or temperature data:
+   - bucket index is "raw >> AHTXX_HISTOGRAM_SHIFT", no float math per sample
+   - counts saturate at 0xFFFFFFFF instead of overflowing
+   - serialized form is little-endian & mergeable, so gateways can sum
+     histograms from many nodes without decoding samples
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_HISTOGRAM_h
+#define AHTXX_HISTOGRAM_h
+
+
+#include <stdint.h>
+
+
+/* histogram geometry, fixed, class layout & serialized form depend on it */
+#define AHTXX_HISTOGRAM_SHIFT            15                                     //20-bit raw >> 15 = 32 buckets, RH 3.125% & T 6.25C per bucket
+
+#define AHTXX_HISTOGRAM_BUCKETS          (1UL << (20 - AHTXX_HISTOGRAM_SHIFT))  //number of buckets
+#define AHTXX_HISTOGRAM_VERSION          0x01                                   //serialized form version
+#define AHTXX_HISTOGRAM_HEADER_SIZE      4                                      //{version, shift, buckets LSB, buckets MSB}
+#define AHTXX_HISTOGRAM_SERIALIZED_SIZE  (AHTXX_HISTOGRAM_HEADER_SIZE + (AHTXX_HISTOGRAM_BUCKETS * 4))
+
+#if (AHTXX_HISTOGRAM_SHIFT < 7) || (AHTXX_HISTOGRAM_SHIFT > 19)
+#error "AHTXX_HISTOGRAM_SHIFT must be 7..19, uint16_t bucket index & serialized size"
+#endif
+
+
+class AHTxxHistogram
+{
+  public:
+
+   AHTxxHistogram();
+
+   void     clear();
+   void     add(uint32_t rawValue, uint32_t weight = 1);
+   void     merge(const AHTxxHistogram &histogram);
+   bool     merge(const uint8_t *buffer, uint16_t length);
+   uint16_t serialize(uint8_t *buffer, uint16_t length) const;
+   uint32_t getCount(uint16_t bucket) const;
+   uint32_t getTotal() const;
+   uint32_t getBucketLow(uint16_t bucket) const;
+   uint32_t getBucketHigh(uint16_t bucket) const;
+
+
+  private:
+   uint32_t _counts[AHTXX_HISTOGRAM_BUCKETS];
+
+   void     _addCount(uint16_t bucket, uint32_t weight);
+};
+
+#endif
@@ -0,0 +1,368 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "AHTxxInterpolator.h"
+
+
+/**************************************************************************/
+/*
+    Constructor
+
+    NOTE:
+    - method, AHTXX_INTERPOLATION_LINEAR or AHTXX_INTERPOLATION_CUBIC
+    - maxExtrapolation, after this time estimate stops following last
+      slope & stays constant, in milliseconds
+*/
+/**************************************************************************/
+AHTxxInterpolator::AHTxxInterpolator(uint8_t method, uint32_t maxExtrapolation)
+{
+  _method           = method;
+  _maxExtrapolation = maxExtrapolation;
+
+  clear();
+}
+
+
+/**************************************************************************/
+/*
+    add()
+
+    Add real sample
+
+    NOTE:
+    - time, "millis()" of measurement
+    - samples must be added in time order, older or same time sample
+      is ignored
+    - AHTXX_RAW_ERROR values are ignored
+    - true=added, false=ignored
+*/
+/**************************************************************************/
+bool AHTxxInterpolator::add(uint32_t time, uint32_t rawHumidity, uint32_t rawTemperature)
+{
+  if ((rawHumidity > 0xFFFFF) || (rawTemperature > 0xFFFFF)) return false;                     //no reason to continue, not a 20-bit value
+
+  if ((_count > 0) && ((int32_t)(time - _time[_index(_count - 1)]) <= 0)) return false;         //no reason to continue, not newer than newest sample
+
+  _head = (_head + 1) % AHTXX_INTERPOLATOR_SAMPLES;
+
+  _time[_head]        = time;
+  _humidity[_head]    = rawHumidity;
+  _temperature[_head] = rawTemperature;
+
+  if (_count < AHTXX_INTERPOLATOR_SAMPLES) _count++;
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    estimate()
+
+    Calculate T/RH at given time & return estimate flag
+
+    NOTE:
+    - time, "millis()" of required estimate
+    - between samples, linear or cubic, see constructor
+    - after newest sample, last slope is followed for max
+      "maxExtrapolation" milliseconds, with 1 sample value is constant
+    - before oldest sample, oldest value
+    - read result with "getRawHumidity()" & "getRawTemperature()"
+*/
+/**************************************************************************/
+uint8_t AHTxxInterpolator::estimate(uint32_t time)
+{
+  if (_count == 0)
+  {
+    _rawHumidity    = 0xFFFFFFFF;                                                              //AHTXX_RAW_ERROR
+    _rawTemperature = 0xFFFFFFFF;
+    _flag           = AHTXX_VALUE_NONE;
+
+    return _flag;                                                                              //no reason to continue, no samples
+  }
+
+  /* after newest sample */
+  uint8_t newest = _index(_count - 1);
+  int32_t age    = (int32_t)(time - _time[newest]);
+
+  if (age >= 0)
+  {
+    uint32_t offset = (uint32_t)age;
+
+    if (offset > _maxExtrapolation) offset = _maxExtrapolation;
+
+    _rawHumidity    = _extrapolate(_humidity, offset);
+    _rawTemperature = _extrapolate(_temperature, offset);
+    _flag           = (age == 0) ? AHTXX_VALUE_REAL : AHTXX_VALUE_EXTRAPOLATED;
+
+    return _flag;
+  }
+
+  /* inside history */
+  for (int8_t segment = _count - 2; segment >= 0; segment--)
+  {
+    int32_t offset = (int32_t)(time - _time[_index(segment)]);
+
+    if (offset < 0) continue;                                                                  //older segment
+
+    if (_method == AHTXX_INTERPOLATION_CUBIC)
+    {
+      _rawHumidity    = _cubic(_humidity, segment, offset);
+      _rawTemperature = _cubic(_temperature, segment, offset);
+    }
+    else
+    {
+      _rawHumidity    = _linear(_humidity, segment, offset);
+      _rawTemperature = _linear(_temperature, segment, offset);
+    }
+
+    _flag = (offset == 0) ? AHTXX_VALUE_REAL : AHTXX_VALUE_INTERPOLATED;
+
+    return _flag;
+  }
+
+  /* before oldest sample */
+  uint8_t oldest = _index(0);
+
+  _rawHumidity    = _humidity[oldest];
+  _rawTemperature = _temperature[oldest];
+  _flag           = AHTXX_VALUE_EXTRAPOLATED;
+
+  return _flag;
+}
+
+
+/**************************************************************************/
+/*
+    clear()
+
+    Remove all samples
+*/
+/**************************************************************************/
+void AHTxxInterpolator::clear()
+{
+  _count          = 0;
+  _head           = AHTXX_INTERPOLATOR_SAMPLES - 1;
+  _rawHumidity    = 0xFFFFFFFF;
+  _rawTemperature = 0xFFFFFFFF;
+  _flag           = AHTXX_VALUE_NONE;
+}
+
+
+/**************************************************************************/
+/*
+    getRawHumidity()
+
+    Return 20-bit raw humidity of last "estimate()"
+
+    NOTE:
+    - AHTXX_RAW_ERROR if no samples
+*/
+/**************************************************************************/
+uint32_t AHTxxInterpolator::getRawHumidity() const
+{
+  return _rawHumidity;
+}
+
+
+/**************************************************************************/
+/*
+    getRawTemperature()
+
+    Return 20-bit raw temperature of last "estimate()"
+
+    NOTE:
+    - AHTXX_RAW_ERROR if no samples
+*/
+/**************************************************************************/
+uint32_t AHTxxInterpolator::getRawTemperature() const
+{
+  return _rawTemperature;
+}
+
+
+/**************************************************************************/
+/*
+    getFlag()
+
+    Return flag of last "estimate()"
+
+    NOTE:
+    - AHTXX_VALUE_REAL, AHTXX_VALUE_INTERPOLATED, AHTXX_VALUE_EXTRAPOLATED
+      or AHTXX_VALUE_NONE
+*/
+/**************************************************************************/
+uint8_t AHTxxInterpolator::getFlag() const
+{
+  return _flag;
+}
+
+
+/**************************************************************************/
+/*
+    getCount()
+
+    Return number of stored samples, max AHTXX_INTERPOLATOR_SAMPLES
+*/
+/**************************************************************************/
+uint8_t AHTxxInterpolator::getCount() const
+{
+  return _count;
+}
+
+
+
+
+/**************************************************************************/
+/*
+    _index()
+
+    Return buffer index of sample, order 0=oldest
+*/
+/**************************************************************************/
+uint8_t AHTxxInterpolator::_index(uint8_t order) const
+{
+  return (_head + AHTXX_INTERPOLATOR_SAMPLES + 1 - _count + order) % AHTXX_INTERPOLATOR_SAMPLES;
+}
+
+
+/**************************************************************************/
+/*
+    _slope()
+
+    Return secant slope of segment, in raw units per millisecond
+*/
+/**************************************************************************/
+float AHTxxInterpolator::_slope(const uint32_t *values, uint8_t segment) const
+{
+  uint8_t first  = _index(segment);
+  uint8_t second = _index(segment + 1);
+
+  return ((float)values[second] - (float)values[first]) / (_time[second] - _time[first]);
+}
+
+
+/**************************************************************************/
+/*
+    _tangent()
+
+    Return tangent at sample, in raw units per millisecond
+
+    NOTE:
+    - Fritsch-Butland, harmonic mean of neighbour slopes, 0 at local
+      min/max, so curve never overshoots samples
+    - oldest & newest samples use one-sided slope
+*/
+/**************************************************************************/
+float AHTxxInterpolator::_tangent(const uint32_t *values, uint8_t order) const
+{
+  if (order == 0)          return _slope(values, 0);
+  if (order == _count - 1) return _slope(values, _count - 2);
+
+  float before = _slope(values, order - 1);
+  float after  = _slope(values, order);
+
+  if ((before * after) <= 0) return 0;                   //local min/max or flat
+
+  return (2 * before * after) / (before + after);
+}
+
+
+/**************************************************************************/
+/*
+    _linear()
+
+    Return linear interpolation inside segment
+
+    NOTE:
+    - offset, time after segment start, in milliseconds
+*/
+/**************************************************************************/
+uint32_t AHTxxInterpolator::_linear(const uint32_t *values, uint8_t segment, uint32_t offset) const
+{
+  uint8_t  first  = _index(segment);
+  uint8_t  second = _index(segment + 1);
+  uint32_t length = _time[second] - _time[first];
+
+  int64_t change = ((int64_t)values[second] - values[first]) * offset;
+
+  return values[first] + (int32_t)(change / length);
+}
+
+
+/**************************************************************************/
+/*
+    _cubic()
+
+    Return cubic Hermite interpolation inside segment
+
+    NOTE:
+    - offset, time after segment start, in milliseconds
+    - s = offset / length
+      - h00 =  2s^3 - 3s^2 + 1
+      - h10 =   s^3 - 2s^2 + s
+      - h01 = -2s^3 + 3s^2
+      - h11 =   s^3 -  s^2
+      - y   = h00 * y1 + h10 * length * m1 + h01 * y2 + h11 * length * m2
+    - float, 24-bit mantissa covers 20-bit raw values
+*/
+/**************************************************************************/
+uint32_t AHTxxInterpolator::_cubic(const uint32_t *values, uint8_t segment, uint32_t offset) const
+{
+  uint8_t first  = _index(segment);
+  uint8_t second = _index(segment + 1);
+  float   length = _time[second] - _time[first];
+
+  float s  = offset / length;
+  float s2 = s * s;
+  float s3 = s2 * s;
+
+  float value = ( 2 * s3 - 3 * s2 + 1)   * values[first]
+              + (     s3 - 2 * s2 + s)   * length * _tangent(values, segment)
+              + (-2 * s3 + 3 * s2)       * values[second]
+              + (     s3 -     s2)       * length * _tangent(values, segment + 1);
+
+  if (value < 0)       return 0;
+  if (value > 0xFFFFF) return 0xFFFFF;
+
+  return (uint32_t)(value + 0.5);
+}
+
+
+/**************************************************************************/
+/*
+    _extrapolate()
+
+    Return linear extrapolation after newest sample
+
+    NOTE:
+    - offset, time after newest sample, in milliseconds
+    - result is clamped to 20-bit range
+*/
+/**************************************************************************/
+uint32_t AHTxxInterpolator::_extrapolate(const uint32_t *values, uint32_t offset) const
+{
+  uint8_t newest = _index(_count - 1);
+
+  if ((_count < 2) || (offset == 0)) return values[newest];
+
+  uint8_t  previous = _index(_count - 2);
+  uint32_t length   = _time[newest] - _time[previous];
+
+  int64_t value = values[newest] + (((int64_t)values[newest] - values[previous]) * offset) / length;
+
+  if (value < 0)       return 0;
+  if (value > 0xFFFFF) return 0xFFFFF;
+
+  return (uint32_t)value;
+}
@@ -0,0 +1,79 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Virtual readings between real samples:
+   - time-indexed 20-bit raw T/RH estimates for consumers faster than
+     sensor, no extra conversions & no self-heating
+   - linear or slope-limited cubic Hermite, cubic never overshoots
+     between samples
+   - every estimate is flagged real, interpolated or extrapolated
+   - last 4 samples, O(1) memory
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_INTERPOLATOR_h
+#define AHTXX_INTERPOLATOR_h
+
+
+#include <stdint.h>
+
+
+/* interpolation methods */
+#define AHTXX_INTERPOLATION_LINEAR          0x00  //straight line between samples
+#define AHTXX_INTERPOLATION_CUBIC           0x01  //monotone cubic Hermite, Fritsch-Butland tangents
+
+/* estimate flags */
+#define AHTXX_VALUE_REAL                    0x00  //time of real sample
+#define AHTXX_VALUE_INTERPOLATED            0x01  //between two real samples
+#define AHTXX_VALUE_EXTRAPOLATED            0x02  //after newest or before oldest sample
+#define AHTXX_VALUE_NONE                    0xFF  //no samples
+
+/* misc */
+#define AHTXX_INTERPOLATOR_SAMPLES          4     //history length, cubic needs 1 sample on each side of segment
+#define AHTXX_INTERPOLATOR_MAX_EXTRAPOLATION 2000 //last slope is followed max 2sec after newest sample, in milliseconds
+
+
+class AHTxxInterpolator
+{
+  public:
+
+   AHTxxInterpolator(uint8_t method = AHTXX_INTERPOLATION_LINEAR, uint32_t maxExtrapolation = AHTXX_INTERPOLATOR_MAX_EXTRAPOLATION);
+
+   bool     add(uint32_t time, uint32_t rawHumidity, uint32_t rawTemperature);
+   uint8_t  estimate(uint32_t time);
+   void     clear();
+   uint32_t getRawHumidity() const;
+   uint32_t getRawTemperature() const;
+   uint8_t  getFlag() const;
+   uint8_t  getCount() const;
+
+
+  private:
+   uint8_t  _method;
+   uint32_t _maxExtrapolation;
+   uint32_t _time[AHTXX_INTERPOLATOR_SAMPLES];
+   uint32_t _humidity[AHTXX_INTERPOLATOR_SAMPLES];
+   uint32_t _temperature[AHTXX_INTERPOLATOR_SAMPLES];
+   uint8_t  _count;
+   uint8_t  _head;
+   uint32_t _rawHumidity;
+   uint32_t _rawTemperature;
+   uint8_t  _flag;
+
+   uint8_t  _index(uint8_t order) const;
+   float    _slope(const uint32_t *values, uint8_t segment) const;
+   float    _tangent(const uint32_t *values, uint8_t order) const;
+   uint32_t _linear(const uint32_t *values, uint8_t segment, uint32_t offset) const;
+   uint32_t _cubic(const uint32_t *values, uint8_t segment, uint32_t offset) const;
+   uint32_t _extrapolate(const uint32_t *values, uint32_t offset) const;
+};
+
+#endif
@@ -0,0 +1,469 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   OpenMetrics/Prometheus text exposition of many sensors, see "AHTxxMetrics.h"
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "AHTxxMetrics.h"
+
+
+/* metric names & help text, in flash */
+static const char METRIC_UP[]           PROGMEM = "ahtxx_up";
+static const char METRIC_STATUS[]       PROGMEM = "ahtxx_status";
+static const char METRIC_TEMPERATURE[]  PROGMEM = "ahtxx_temperature_celsius";
+static const char METRIC_HUMIDITY[]     PROGMEM = "ahtxx_humidity_percent";
+static const char METRIC_INTERVAL[]     PROGMEM = "ahtxx_measurement_interval_seconds";
+static const char METRIC_TRANSACTIONS[] PROGMEM = "ahtxx_transactions";
+static const char METRIC_MEASUREMENTS[] PROGMEM = "ahtxx_measurements";
+static const char METRIC_ERRORS[]       PROGMEM = "ahtxx_errors";
+static const char METRIC_RECOVERIES[]   PROGMEM = "ahtxx_bus_recoveries";
+static const char METRIC_BLOCKING[]     PROGMEM = "ahtxx_blocking_seconds";
+static const char METRIC_LATENCY[]      PROGMEM = "ahtxx_measurement_latency_seconds";
+
+static const char HELP_UP[]             PROGMEM = "Last measurement succeeded.";
+static const char HELP_STATUS[]         PROGMEM = "Last AHTXX status code, 0=no error.";
+static const char HELP_TEMPERATURE[]    PROGMEM = "Last measured temperature.";
+static const char HELP_HUMIDITY[]       PROGMEM = "Last measured relative humidity.";
+static const char HELP_INTERVAL[]       PROGMEM = "Time between last two measurements.";
+static const char HELP_TRANSACTIONS[]   PROGMEM = "I2C transactions.";
+static const char HELP_MEASUREMENTS[]   PROGMEM = "Completed measurements.";
+static const char HELP_ERRORS[]         PROGMEM = "Failed measurements.";
+static const char HELP_RECOVERIES[]     PROGMEM = "Stuck bus recoveries.";
+static const char HELP_BLOCKING[]       PROGMEM = "Time spent blocked in read calls.";
+static const char HELP_LATENCY[]        PROGMEM = "Measurement start to data ready.";
+
+static const char TYPE_GAUGE[]          PROGMEM = "gauge";
+static const char TYPE_COUNTER[]        PROGMEM = "counter";
+static const char TYPE_HISTOGRAM[]      PROGMEM = "histogram";
+
+static const char SUFFIX_TOTAL[]        PROGMEM = "_total";
+static const char SUFFIX_BUCKET[]       PROGMEM = "_bucket";
+static const char SUFFIX_COUNT[]        PROGMEM = "_count";
+static const char SUFFIX_SUM[]          PROGMEM = "_sum";
+
+static const char TEXT_TYPE[]           PROGMEM = "# TYPE ";
+static const char TEXT_HELP[]           PROGMEM = "# HELP ";
+static const char TEXT_SENSOR[]         PROGMEM = "{sensor=\"";
+static const char TEXT_LE[]             PROGMEM = "\",le=\"";
+static const char TEXT_INF[]            PROGMEM = "+Inf";
+static const char TEXT_NAN[]            PROGMEM = "NaN";
+static const char TEXT_EOF[]            PROGMEM = "# EOF\n";
+
+
+/**************************************************************************/
+/*
+    Constructor
+*/
+/**************************************************************************/
+AHTxxMetrics::AHTxxMetrics()
+{
+  _count    = 0;
+  _buffer   = 0;
+  _size     = 0;
+  _length   = 0;
+  _overflow = false;
+}
+
+
+/**************************************************************************/
+/*
+    addSensor()
+
+    Register sensor, returns false if table is full
+
+    NOTE:
+    - name becomes label sensor="name", string is not copied & must
+      outlive this object
+    - sensors are rendered in registration order
+*/
+/**************************************************************************/
+bool AHTxxMetrics::addSensor(AHTxx *sensor, const char *name)
+{
+  if ((sensor == 0) || (name == 0) || (_count >= AHTXX_METRICS_MAX_SENSORS)) return false; //no reason to continue
+
+  _sensors[_count] = sensor;
+  _names[_count]   = name;
+
+  _count++;
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    render()
+
+    Write OpenMetrics text of all registered sensors to buffer, returns
+    length without terminating zero
+
+    NOTE:
+    - every metric family is contiguous, one sample per sensor
+    - temperature, humidity & interval are "NaN" after failed
+      measurement or before first measurement, see AHTXX_NO_DATA_ERROR,
+      "up" is 0 & "status" is 6 before first measurement
+    - fixed-point output, 0.001C, 0.001%RH, 1msec & 1usec resolution
+    - returns 0 if buffer is too small, buffer content is truncated
+*/
+/**************************************************************************/
+uint16_t AHTxxMetrics::render(char *buffer, uint16_t size)
+{
+  if ((buffer == 0) || (size == 0)) return 0;                    //no reason to continue
+
+  _buffer   = buffer;
+  _size     = size;
+  _length   = 0;
+  _overflow = false;
+
+  /* health */
+  _family(METRIC_UP, TYPE_GAUGE, HELP_UP);
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    _sample(METRIC_UP, 0, i);
+    _writeChar((_sensors[i]->getStatus() == AHTXX_NO_ERROR) ? '1' : '0');
+    _writeChar('\n');
+  }
+
+  _family(METRIC_STATUS, TYPE_GAUGE, HELP_STATUS);
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    _sample(METRIC_STATUS, 0, i);
+    _writeFixed(_sensors[i]->getStatus(), 0);
+    _writeChar('\n');
+  }
+
+  /* latest values, T = raw * 200 / 2^20 - 50C = raw * 3125 / 2^14 - 50000 mC, no 32-bit overflow for 20-bit raw */
+  _family(METRIC_TEMPERATURE, TYPE_GAUGE, HELP_TEMPERATURE);
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    uint32_t raw = _sensors[i]->readRawTemperature(AHTXX_USE_READ_DATA);
+
+    _sample(METRIC_TEMPERATURE, 0, i);
+
+    if (raw == AHTXX_RAW_ERROR) {_writeNaN();}
+    else
+    {
+      uint32_t milli = (raw * 3125) >> 14;
+
+      if (milli < 50000)
+      {
+        _writeChar('-');
+        _writeFixed(50000 - milli, 3);
+      }
+      else
+      {
+        _writeFixed(milli - 50000, 3);
+      }
+    }
+
+    _writeChar('\n');
+  }
+
+  /* RH = raw * 100 / 2^20 = raw * 3125 / 2^15 m% */
+  _family(METRIC_HUMIDITY, TYPE_GAUGE, HELP_HUMIDITY);
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    uint32_t raw = _sensors[i]->readRawHumidity(AHTXX_USE_READ_DATA);
+
+    _sample(METRIC_HUMIDITY, 0, i);
+
+    if (raw == AHTXX_RAW_ERROR) {_writeNaN();}
+    else                        {_writeFixed((raw * 3125) >> 15, 3);}
+
+    _writeChar('\n');
+  }
+
+  _family(METRIC_INTERVAL, TYPE_GAUGE, HELP_INTERVAL);
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    uint32_t interval = _sensors[i]->getMeasurementInterval();
+
+    _sample(METRIC_INTERVAL, 0, i);
+
+    if (interval == 0xFFFFFFFF) {_writeNaN();}
+    else                        {_writeFixed(interval, 3);}
+
+    _writeChar('\n');
+  }
+
+  /* driver counters */
+  _family(METRIC_TRANSACTIONS, TYPE_COUNTER, HELP_TRANSACTIONS);
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    _sample(METRIC_TRANSACTIONS, SUFFIX_TOTAL, i);
+    _writeFixed(_sensors[i]->getTransactionCount(), 0);
+    _writeChar('\n');
+  }
+
+  _family(METRIC_MEASUREMENTS, TYPE_COUNTER, HELP_MEASUREMENTS);
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    _sample(METRIC_MEASUREMENTS, SUFFIX_TOTAL, i);
+    _writeFixed(_sensors[i]->getMeasurementCount(), 0);
+    _writeChar('\n');
+  }
+
+  _family(METRIC_ERRORS, TYPE_COUNTER, HELP_ERRORS);
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    _sample(METRIC_ERRORS, SUFFIX_TOTAL, i);
+    _writeFixed(_sensors[i]->getErrorCount(), 0);
+    _writeChar('\n');
+  }
+
+  _family(METRIC_RECOVERIES, TYPE_COUNTER, HELP_RECOVERIES);
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    _sample(METRIC_RECOVERIES, SUFFIX_TOTAL, i);
+    _writeFixed(_sensors[i]->getBusRecoveryCount(), 0);
+    _writeChar('\n');
+  }
+
+  _family(METRIC_BLOCKING, TYPE_COUNTER, HELP_BLOCKING);
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    _sample(METRIC_BLOCKING, SUFFIX_TOTAL, i);
+    _writeFixed(_sensors[i]->getBlockingTime(), 6);              //usec
+    _writeChar('\n');
+  }
+
+  /* latency histogram, driver counts per bucket, exposition is cumulative */
+  _family(METRIC_LATENCY, TYPE_HISTOGRAM, HELP_LATENCY);
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    uint32_t total = 0;
+
+    for (uint8_t bucket = 0; bucket < AHTXX_LATENCY_BUCKETS; bucket++)
+    {
+      total += _sensors[i]->getLatencyCount(bucket);
+
+      _sample(METRIC_LATENCY, SUFFIX_BUCKET, i, _sensors[i]->getLatencyBound(bucket));
+      _writeFixed(total, 0);
+      _writeChar('\n');
+    }
+
+    _sample(METRIC_LATENCY, SUFFIX_COUNT, i);
+    _writeFixed(total, 0);
+    _writeChar('\n');
+
+    _sample(METRIC_LATENCY, SUFFIX_SUM, i);
+    _writeFixed(_sensors[i]->getLatencySum(), 3);                //msec
+    _writeChar('\n');
+  }
+
+  _writeFlash(TEXT_EOF);
+
+  if (_overflow == true)
+  {
+    _buffer[0] = '\0';
+
+    return 0;
+  }
+
+  _buffer[_length] = '\0';
+
+  return _length;
+}
+
+
+/**************************************************************************/
+/*
+    _family()
+
+    Write "# TYPE" & "# HELP" lines of metric family
+*/
+/**************************************************************************/
+void AHTxxMetrics::_family(const char *name, const char *type, const char *help)
+{
+  _writeFlash(TEXT_TYPE);
+  _writeFlash(name);
+  _writeChar(' ');
+  _writeFlash(type);
+  _writeChar('\n');
+
+  _writeFlash(TEXT_HELP);
+  _writeFlash(name);
+  _writeChar(' ');
+  _writeFlash(help);
+  _writeChar('\n');
+}
+
+
+/**************************************************************************/
+/*
+    _sample()
+
+    Write sample name & labels up to value, e.g. 'name_total{sensor="x"} '
+
+    NOTE:
+    - bound in msec adds label le="seconds", 0=no "le" label,
+      AHTXX_LATENCY_INF="+Inf"
+*/
+/**************************************************************************/
+void AHTxxMetrics::_sample(const char *name, const char *suffix, uint8_t index, uint16_t bound)
+{
+  _writeFlash(name);
+
+  if (suffix != 0) {_writeFlash(suffix);}
+
+  _writeFlash(TEXT_SENSOR);
+  _writeLabel(_names[index]);
+
+  if (bound != 0)
+  {
+    _writeFlash(TEXT_LE);
+
+    if (bound == AHTXX_LATENCY_INF) {_writeFlash(TEXT_INF);}
+    else                            {_writeFixed(bound, 3);}
+  }
+
+  _writeChar('"');
+  _writeChar('}');
+  _writeChar(' ');
+}
+
+
+/**************************************************************************/
+/*
+    _writeChar()
+
+    Append one character, last buffer byte is reserved for terminating zero
+*/
+/**************************************************************************/
+void AHTxxMetrics::_writeChar(char value)
+{
+  if ((uint16_t)(_length + 1) >= _size)
+  {
+    _overflow = true;
+
+    return;
+  }
+
+  _buffer[_length++] = value;
+}
+
+
+/**************************************************************************/
+/*
+    _writeFlash()
+
+    Append zero-terminated string from flash
+*/
+/**************************************************************************/
+void AHTxxMetrics::_writeFlash(const char *text)
+{
+  char value = pgm_read_byte(text);
+
+  while (value != '\0')
+  {
+    _writeChar(value);
+
+    text++;
+
+    value = pgm_read_byte(text);
+  }
+}
+
+
+/**************************************************************************/
+/*
+    _writeLabel()
+
+    Append label value from RAM, escapes '\', '"' & new line
+*/
+/**************************************************************************/
+void AHTxxMetrics::_writeLabel(const char *text)
+{
+  while (*text != '\0')
+  {
+    switch (*text)
+    {
+      case '\\':
+        _writeChar('\\');
+        _writeChar('\\');
+        break;
+
+      case '"':
+        _writeChar('\\');
+        _writeChar('"');
+        break;
+
+      case '\n':
+        _writeChar('\\');
+        _writeChar('n');
+        break;
+
+      default:
+        _writeChar(*text);
+        break;
+    }
+
+    text++;
+  }
+}
+
+
+/**************************************************************************/
+/*
+    _writeFixed()
+
+    Append unsigned fixed-point value, e.g. value=12345 & decimals=3
+    is "12.345"
+
+    NOTE:
+    - decimals 0..9
+*/
+/**************************************************************************/
+void AHTxxMetrics::_writeFixed(uint32_t value, uint8_t decimals)
+{
+  char    digits[10];                                            //uint32_t is 10 digits max
+  uint8_t length = 0;
+
+  do
+  {
+    digits[length++] = '0' + (value % 10);
+
+    value /= 10;
+  }
+  while ((value != 0) || (length <= decimals));                  //leading zero before decimal point
+
+  while (length > 0)
+  {
+    if (length == decimals) {_writeChar('.');}
+
+    _writeChar(digits[--length]);
+  }
+}
+
+
+/**************************************************************************/
+/*
+    _writeNaN()
+
+    Append "NaN", value of failed or missing measurement
+*/
+/**************************************************************************/
+void AHTxxMetrics::_writeNaN()
+{
+  _writeFlash(TEXT_NAN);
+}
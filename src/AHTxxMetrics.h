@@ -0,0 +1,69 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   OpenMetrics/Prometheus text exposition of many sensors:
+   - health, status, latest T/RH, driver counters & measurement latency
+     histogram of every registered "AHTxx", label sensor="name"
+   - rendered into caller buffer, no heap, no "printf()" & no float
+     formatting library, metric names & help text stay in flash
+   - ~2.1Kbytes for one sensor, ~1Kbyte per additional sensor with short
+     name, size buffer for longest expected output
+   - serve buffer from HTTP handler with content type
+     "application/openmetrics-text; version=1.0.0; charset=utf-8" or
+     dump with "Serial.write()"
+
+   NOTE:
+   - no I2C transfers, values of last measurement are rendered, read
+     sensors before scrape
+   - counters restart after "AHTxx::resetStatistics()", scraper treats
+     it as counter reset
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_METRICS_h
+#define AHTXX_METRICS_h
+
+
+#include "AHTxx.h"
+
+
+#define AHTXX_METRICS_MAX_SENSORS  8     //max registered sensors
+
+
+class AHTxxMetrics
+{
+  public:
+
+   AHTxxMetrics();
+
+   bool     addSensor(AHTxx *sensor, const char *name);
+   uint16_t render(char *buffer, uint16_t size);
+
+
+  private:
+   AHTxx      *_sensors[AHTXX_METRICS_MAX_SENSORS];
+   const char *_names[AHTXX_METRICS_MAX_SENSORS];
+   uint8_t     _count;
+   char       *_buffer;
+   uint16_t    _size;
+   uint16_t    _length;
+   bool        _overflow;
+
+   void _family(const char *name, const char *type, const char *help);
+   void _sample(const char *name, const char *suffix, uint8_t index, uint16_t bound = 0);
+   void _writeChar(char value);
+   void _writeFlash(const char *text);
+   void _writeLabel(const char *text);
+   void _writeFixed(uint32_t value, uint8_t decimals);
+   void _writeNaN();
+};
+
+#endif
@@ -0,0 +1,328 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "AHTxxPacket.h"
+
+
+/**************************************************************************/
+/*
+    ahtxxCrc16()
+
+    Return CRC-16/CCITT-FALSE of data
+
+    NOTE:
+    - polynomial 0x1021, initial value 0xFFFF, no reflection
+    - bitwise, no lookup table in RAM/flash, ~20 bytes per packet
+*/
+/**************************************************************************/
+uint16_t ahtxxCrc16(const uint8_t *data, uint8_t length)
+{
+  uint16_t crc = 0xFFFF;
+
+  for (uint8_t i = 0; i < length; i++)
+  {
+    crc ^= (uint16_t)data[i] << 8;
+
+    for (uint8_t bit = 0; bit < 8; bit++)
+    {
+      if (crc & 0x8000) {crc = (crc << 1) ^ 0x1021;}
+      else              {crc = (crc << 1);}
+    }
+  }
+
+  return crc;
+}
+
+
+/**************************************************************************/
+/*
+    ahtxxCobsEncode()
+
+    Consistent Overhead Byte Stuffing, return encoded length
+
+    NOTE:
+    - encoded data has no 0x00 bytes, 0x00 delimiter is not added
+    - encoded buffer must fit length + 1 bytes, length < 254
+*/
+/**************************************************************************/
+uint8_t ahtxxCobsEncode(const uint8_t *data, uint8_t length, uint8_t *encoded)
+{
+  uint8_t codeIndex = 0;                                  //position of current block code
+  uint8_t index     = 1;
+  uint8_t code      = 1;
+
+  for (uint8_t i = 0; i < length; i++)
+  {
+    if (data[i] == 0x00)
+    {
+      encoded[codeIndex] = code;                          //close block, zero is implied by code
+
+      codeIndex = index++;
+      code      = 1;
+    }
+    else
+    {
+      encoded[index++] = data[i];
+
+      code++;
+    }
+  }
+
+  encoded[codeIndex] = code;
+
+  return index;
+}
+
+
+/**************************************************************************/
+/*
+    ahtxxCobsDecode()
+
+    Reverse "ahtxxCobsEncode()", return decoded length
+
+    NOTE:
+    - encoded data without 0x00 delimiter
+    - returns 0 if data is not valid COBS
+*/
+/**************************************************************************/
+uint8_t ahtxxCobsDecode(const uint8_t *encoded, uint8_t length, uint8_t *data)
+{
+  uint8_t index = 0;
+  uint8_t size  = 0;
+
+  while (index < length)
+  {
+    uint8_t code = encoded[index++];
+
+    if ((code == 0x00) || ((index + code - 1) > length)) return 0; //no reason to continue, broken block
+
+    for (uint8_t i = 1; i < code; i++)
+    {
+      data[size++] = encoded[index++];
+    }
+
+    if (index < length) data[size++] = 0x00;             //every block except last ends with zero
+  }
+
+  return size;
+}
+
+
+/**************************************************************************/
+/*
+    ahtxxPacketEncode()
+
+    Build packet, return number of bytes to send
+
+    NOTE:
+    - buffer must fit AHTXX_PACKET_MAX_SIZE bytes
+    - output is COBS encoded & ends with 0x00 delimiter, ready for
+      "Serial.write()"
+*/
+/**************************************************************************/
+uint8_t ahtxxPacketEncode(const AHTxxPacket *packet, uint8_t *buffer)
+{
+  uint8_t data[AHTXX_PACKET_MAX_DATA];
+  uint8_t length = (packet->length > AHTXX_PACKET_MAX_FRAME) ? AHTXX_PACKET_MAX_FRAME : packet->length;
+
+  data[0]  = AHTXX_PACKET_VERSION;
+  data[1]  = packet->node;
+  data[2]  = packet->sensor;
+  data[3]  = packet->sequence;
+  data[4]  = packet->sequence >> 8;
+  data[5]  = packet->time;
+  data[6]  = packet->time >> 8;
+  data[7]  = packet->time >> 16;
+  data[8]  = packet->time >> 24;
+  data[9]  = packet->status;
+  data[10] = length;
+
+  for (uint8_t i = 0; i < length; i++)
+  {
+    data[AHTXX_PACKET_HEADER_SIZE + i] = packet->frame[i];
+  }
+
+  uint8_t  size = AHTXX_PACKET_HEADER_SIZE + length;
+  uint16_t crc  = ahtxxCrc16(data, size);
+
+  data[size++] = crc;
+  data[size++] = crc >> 8;
+
+  size = ahtxxCobsEncode(data, size, buffer);
+
+  buffer[size++] = 0x00;                                  //delimiter
+
+  return size;
+}
+
+
+/**************************************************************************/
+/*
+    ahtxxPacketParse()
+
+    Check & unpack decoded packet data
+
+    NOTE:
+    - data after "ahtxxCobsDecode()", without delimiter
+    - returns AHTXX_PACKET_OK, AHTXX_PACKET_CRC_ERROR or
+      AHTXX_PACKET_FORMAT_ERROR
+*/
+/**************************************************************************/
+uint8_t ahtxxPacketParse(const uint8_t *data, uint8_t length, AHTxxPacket *packet)
+{
+  if (length < (AHTXX_PACKET_HEADER_SIZE + 2)) return AHTXX_PACKET_FORMAT_ERROR;                      //no reason to continue, too short
+
+  uint16_t crc = data[length - 2] | ((uint16_t)data[length - 1] << 8);
+
+  if (ahtxxCrc16(data, length - 2) != crc) return AHTXX_PACKET_CRC_ERROR;                             //no reason to continue, corrupted
+
+  uint8_t frameLength = data[10];                                                                      //local copy, bound is visible to compiler
+
+  if ((data[0] != AHTXX_PACKET_VERSION) || (frameLength > AHTXX_PACKET_MAX_FRAME)) return AHTXX_PACKET_FORMAT_ERROR;
+
+  if (length != (AHTXX_PACKET_HEADER_SIZE + frameLength + 2)) return AHTXX_PACKET_FORMAT_ERROR;       //frame length doesn't match packet size
+
+  packet->node     = data[1];
+  packet->sensor   = data[2];
+  packet->sequence = data[3] | ((uint16_t)data[4] << 8);
+  packet->time     = data[5] | ((uint32_t)data[6] << 8) | ((uint32_t)data[7] << 16) | ((uint32_t)data[8] << 24);
+  packet->status   = data[9];
+  packet->length   = frameLength;
+
+  for (uint8_t i = 0; i < frameLength; i++)
+  {
+    packet->frame[i] = data[AHTXX_PACKET_HEADER_SIZE + i];
+  }
+
+  return AHTXX_PACKET_OK;
+}
+
+
+/**************************************************************************/
+/*
+    ahtxxPacketRawHumidity()
+
+    Return 20-bit raw humidity of packet frame
+
+    NOTE:
+    - same decoding as "AHTxx::readRawHumidity()"
+    - returns 0xFFFFFFFF if packet has error status or no frame
+*/
+/**************************************************************************/
+uint32_t ahtxxPacketRawHumidity(const AHTxxPacket *packet)
+{
+  if ((packet->status != 0x00) || (packet->length < 6)) return 0xFFFFFFFF;
+
+  return ((uint32_t)packet->frame[1] << 12) | ((uint32_t)packet->frame[2] << 4) | (packet->frame[3] >> 4);
+}
+
+
+/**************************************************************************/
+/*
+    ahtxxPacketRawTemperature()
+
+    Return 20-bit raw temperature of packet frame
+
+    NOTE:
+    - same decoding as "AHTxx::readRawTemperature()"
+    - returns 0xFFFFFFFF if packet has error status or no frame
+*/
+/**************************************************************************/
+uint32_t ahtxxPacketRawTemperature(const AHTxxPacket *packet)
+{
+  if ((packet->status != 0x00) || (packet->length < 6)) return 0xFFFFFFFF;
+
+  return ((uint32_t)(packet->frame[3] & 0x0F) << 16) | ((uint32_t)packet->frame[4] << 8) | packet->frame[5];
+}
+
+
+
+/**************************************************************************/
+/*
+    AHTxxPacketDecoder
+
+    Constructor
+*/
+/**************************************************************************/
+AHTxxPacketDecoder::AHTxxPacketDecoder()
+{
+  reset();
+}
+
+
+/**************************************************************************/
+/*
+    feed()
+
+    Add received byte, return decoder result
+
+    NOTE:
+    - call for every received byte, packet is decoded on 0x00 delimiter
+    - returns AHTXX_PACKET_NONE until delimiter, then AHTXX_PACKET_OK
+      & "getPacket()" or error code
+    - first packet after start in the middle of stream is reported as
+      error, next packets are fine
+*/
+/**************************************************************************/
+uint8_t AHTxxPacketDecoder::feed(uint8_t value)
+{
+  if (value != 0x00)
+  {
+    if (_length < AHTXX_PACKET_MAX_SIZE) {_buffer[_length++] = value;}
+    else                                 {_overflow = true;}  //keep dropping bytes until delimiter
+
+    return AHTXX_PACKET_NONE;
+  }
+
+  uint8_t length   = _length;
+  bool    overflow = _overflow;
+
+  reset();
+
+  if (length == 0)        return AHTXX_PACKET_NONE;                     //no reason to continue, empty frame or repeated delimiter
+  if (overflow == true)   return AHTXX_PACKET_FORMAT_ERROR;
+
+  uint8_t data[AHTXX_PACKET_MAX_SIZE];
+  uint8_t size = ahtxxCobsDecode(_buffer, length, data);
+
+  if (size == 0) return AHTXX_PACKET_COBS_ERROR;
+
+  return ahtxxPacketParse(data, size, &_packet);
+}
+
+
+/**************************************************************************/
+/*
+    reset()
+
+    Drop partially received packet
+*/
+/**************************************************************************/
+void AHTxxPacketDecoder::reset()
+{
+  _length   = 0;
+  _overflow = false;
+}
+
+
+/**************************************************************************/
+/*
+    getPacket()
+
+    Return last valid packet
+*/
+/**************************************************************************/
+const AHTxxPacket *AHTxxPacketDecoder::getPacket() const
+{
+  return &_packet;
+}
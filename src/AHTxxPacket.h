@@ -0,0 +1,87 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Binary streaming packets:
+   - raw sensor frame, driver status, node & sensor id, sequence number
+     & timestamp in 22 bytes, no text formatting on MCU
+   - CRC-16/CCITT-FALSE over packet, COBS framing, 0x00 ends every
+     packet, receiver resynchronizes after any lost byte
+   - encoder & incremental decoder are Arduino-free, same code builds
+     for host tools, see "extras/decoder"
+
+   Packet before COBS, multi-byte fields are little-endian:
+   version(1), node(1), sensor(1), sequence(2), time(4), status(1),
+   length(1), frame(length), CRC16(2)
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_PACKET_h
+#define AHTXX_PACKET_h
+
+
+#include <stdint.h>
+
+
+#define AHTXX_PACKET_VERSION        0x01  //packet layout version
+#define AHTXX_PACKET_MAX_FRAME      7     //{status, RH, RH, RH+T, T, T, CRC}
+#define AHTXX_PACKET_HEADER_SIZE    11    //version..length
+#define AHTXX_PACKET_MAX_DATA       (AHTXX_PACKET_HEADER_SIZE + AHTXX_PACKET_MAX_FRAME + 2)
+#define AHTXX_PACKET_MAX_SIZE       (AHTXX_PACKET_MAX_DATA + 2) //COBS overhead byte + 0x00 delimiter
+
+/* decoder results */
+#define AHTXX_PACKET_NONE           0x00  //packet not completed yet
+#define AHTXX_PACKET_OK             0x01  //valid packet, see "getPacket()"
+#define AHTXX_PACKET_COBS_ERROR     0x02  //broken framing, bytes lost
+#define AHTXX_PACKET_CRC_ERROR      0x03  //corrupted packet
+#define AHTXX_PACKET_FORMAT_ERROR   0x04  //unknown version, wrong length or buffer overflow
+
+
+typedef struct
+{
+  uint8_t  node;                          //sender id
+  uint8_t  sensor;                        //sensor index on sender
+  uint16_t sequence;                      //sender packet counter, gaps show lost packets
+  uint32_t time;                          //sender "millis()"
+  uint8_t  status;                        //"AHTxx::getStatus()"
+  uint8_t  length;                        //frame length, 6=AHT1x, 7=AHT2x, 0=no data
+  uint8_t  frame[AHTXX_PACKET_MAX_FRAME]; //raw sensor data, see "AHTxx::getRawData()"
+}
+AHTxxPacket;
+
+
+uint16_t ahtxxCrc16(const uint8_t *data, uint8_t length);
+uint8_t  ahtxxCobsEncode(const uint8_t *data, uint8_t length, uint8_t *encoded);
+uint8_t  ahtxxCobsDecode(const uint8_t *encoded, uint8_t length, uint8_t *data);
+uint8_t  ahtxxPacketEncode(const AHTxxPacket *packet, uint8_t *buffer);
+uint8_t  ahtxxPacketParse(const uint8_t *data, uint8_t length, AHTxxPacket *packet);
+uint32_t ahtxxPacketRawHumidity(const AHTxxPacket *packet);
+uint32_t ahtxxPacketRawTemperature(const AHTxxPacket *packet);
+
+
+class AHTxxPacketDecoder
+{
+  public:
+
+   AHTxxPacketDecoder();
+
+   uint8_t            feed(uint8_t value);
+   void               reset();
+   const AHTxxPacket *getPacket() const;
+
+
+  private:
+   uint8_t     _buffer[AHTXX_PACKET_MAX_SIZE];
+   uint8_t     _length;
+   bool        _overflow;
+   AHTxxPacket _packet;
+};
+
+#endif
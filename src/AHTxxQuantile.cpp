@@ -0,0 +1,517 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "AHTxxQuantile.h"
+
+
+/**************************************************************************/
+/*
+    Constructor
+*/
+/**************************************************************************/
+AHTxxQuantile::AHTxxQuantile()
+{
+  clear();
+}
+
+
+/**************************************************************************/
+/*
+    clear()
+
+    Drop all samples
+*/
+/**************************************************************************/
+void AHTxxQuantile::clear()
+{
+  _levels    = 1;
+  _bounds[0] = 0;
+  _bounds[1] = 0;
+  _count     = 0;
+  _min       = 0xFFFFF;
+  _max       = 0;
+  _random    = 0xACE1;                                     //any non-zero seed
+}
+
+
+/**************************************************************************/
+/*
+    add()
+
+    Add 20-bit raw value
+
+    NOTE:
+    - full level is compacted in place, ~K * log(K) operations once per
+      ~K samples, nothing else is slow
+    - true=success, false=not a 20-bit value or sketch is full after
+      ~K * 2^24 samples
+*/
+/**************************************************************************/
+bool AHTxxQuantile::add(uint32_t rawValue)
+{
+  if (rawValue > 0xFFFFF) return false;                    //no reason to continue, not a 20-bit value
+
+  if (_insert(rawValue, 0) != true) return false;
+
+  if (rawValue < _min) _min = rawValue;
+  if (rawValue > _max) _max = rawValue;
+
+  _count++;
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    merge()
+
+    Add samples of another sketch
+
+    NOTE:
+    - items keep their level, result is same as one sketch of all samples
+    - true=success, false=sketch merged into itself or sketch is full
+*/
+/**************************************************************************/
+bool AHTxxQuantile::merge(const AHTxxQuantile &sketch)
+{
+  if (&sketch == this) return false;                       //no reason to continue, items would move under iteration
+
+  for (uint8_t level = 0; level < sketch._levels; level++)
+  {
+    for (uint8_t i = sketch._bounds[level + 1]; i < sketch._bounds[level]; i++)
+    {
+      if (_insert(sketch._items[i], level) != true) return false;
+    }
+  }
+
+  if (sketch._count == 0) return true;
+
+  if (sketch._min < _min) _min = sketch._min;
+  if (sketch._max > _max) _max = sketch._max;
+
+  _count += sketch._count;
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    merge()
+
+    Add samples of serialized sketch
+
+    NOTE:
+    - see "serialize()" NOTE for data structure
+    - sketches with different K are merged too
+    - true=success, false=buffer too small, unknown serialized form or
+      sketch is full
+*/
+/**************************************************************************/
+bool AHTxxQuantile::merge(const uint8_t *buffer, uint16_t length)
+{
+  if (length < AHTXX_QUANTILE_HEADER_SIZE) return false;                   //no reason to continue, buffer too small
+  if (buffer[0] != AHTXX_QUANTILE_VERSION) return false;                   //unknown serialized form
+
+  uint8_t  levels = buffer[2];
+  uint16_t size   = 0;
+
+  if ((levels == 0) || (levels > AHTXX_QUANTILE_MAX_LEVELS) || (length < (AHTXX_QUANTILE_HEADER_SIZE + levels))) return false;
+
+  for (uint8_t level = 0; level < levels; level++)
+  {
+    size += buffer[AHTXX_QUANTILE_HEADER_SIZE + level];
+  }
+
+  if (length < (AHTXX_QUANTILE_HEADER_SIZE + levels + (size * 3))) return false;
+
+  uint32_t count = _readValue(buffer + 4, 4);
+  uint32_t min   = _readValue(buffer + 8, 4);
+  uint32_t max   = _readValue(buffer + 12, 4);
+
+  const uint8_t *item = buffer + AHTXX_QUANTILE_HEADER_SIZE + levels;
+
+  for (uint8_t level = 0; level < levels; level++)
+  {
+    for (uint8_t i = 0; i < buffer[AHTXX_QUANTILE_HEADER_SIZE + level]; i++)
+    {
+      if (_insert(_readValue(item, 3) & 0xFFFFF, level) != true) return false;
+
+      item += 3;
+    }
+  }
+
+  if (count == 0) return true;
+
+  if (min < _min) _min = min;
+  if (max > _max) _max = max;
+
+  _count += count;
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    serialize()
+
+    Write sketch to buffer & return number of written bytes
+
+    NOTE:
+    - data structure:
+      - {version, K, levels, 0, count LSB..MSB, min LSB..MSB, max LSB..MSB,
+         level0 size, level1 size, ..., item0 LSB..MSB (3 bytes), ...}
+      - items of level 0 first
+    - size is AHTXX_QUANTILE_HEADER_SIZE + levels + items * 3, up to
+      AHTXX_QUANTILE_SERIALIZED_SIZE, ~450 bytes for K=32, 0 is
+      returned if buffer is too small
+*/
+/**************************************************************************/
+uint16_t AHTxxQuantile::serialize(uint8_t *buffer, uint16_t length) const
+{
+  uint16_t size = AHTXX_QUANTILE_HEADER_SIZE + _levels + (_bounds[0] * 3);
+
+  if (length < size) return 0;                             //no reason to continue, buffer too small
+
+  const uint32_t header[3] = {_count, _min, _max};
+
+  *buffer++ = AHTXX_QUANTILE_VERSION;
+  *buffer++ = AHTXX_QUANTILE_K;
+  *buffer++ = _levels;
+  *buffer++ = 0;
+
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    *buffer++ = header[i];
+    *buffer++ = header[i] >> 8;
+    *buffer++ = header[i] >> 16;
+    *buffer++ = header[i] >> 24;
+  }
+
+  for (uint8_t level = 0; level < _levels; level++)
+  {
+    *buffer++ = _bounds[level] - _bounds[level + 1];
+  }
+
+  for (uint8_t level = 0; level < _levels; level++)
+  {
+    for (uint8_t i = _bounds[level + 1]; i < _bounds[level]; i++)
+    {
+      *buffer++ = _items[i];
+      *buffer++ = _items[i] >> 8;
+      *buffer++ = _items[i] >> 16;
+    }
+  }
+
+  return size;
+}
+
+
+/**************************************************************************/
+/*
+    getQuantile()
+
+    Return 20-bit raw value of quantile
+
+    NOTE:
+    - quantile, 0.0..1.0, e.g. 0.95 for p95
+    - 0.0=exact minimum, 1.0=exact maximum
+    - binary search over value range, no sorting & no extra RAM,
+      20 passes over retained items
+    - returns 0xFFFFFFFF if sketch is empty
+*/
+/**************************************************************************/
+uint32_t AHTxxQuantile::getQuantile(float quantile) const
+{
+  if (_count == 0) return 0xFFFFFFFF;                      //no reason to continue, no samples
+
+  if (quantile <= 0) return _min;
+  if (quantile >= 1) return _max;
+
+  uint32_t total  = _getWeight(0xFFFFF);
+  float    rank   = quantile * total;
+  uint32_t target = (uint32_t)rank;
+
+  if ((target < rank) || (target == 0)) target++;          //ceil, at least 1 sample
+
+  uint32_t low  = _min;
+  uint32_t high = _max;
+
+  while (low < high)
+  {
+    uint32_t middle = (low + high) >> 1;
+
+    if (_getWeight(middle) >= target) {high = middle;}
+    else                              {low  = middle + 1;}
+  }
+
+  return low;
+}
+
+
+/**************************************************************************/
+/*
+    getRank()
+
+    Return estimated fraction of samples <= 20-bit raw value, 0.0..1.0
+
+    NOTE:
+    - returns 0 if sketch is empty
+*/
+/**************************************************************************/
+float AHTxxQuantile::getRank(uint32_t rawValue) const
+{
+  if (_count == 0) return 0;
+
+  return (float)_getWeight(rawValue) / _getWeight(0xFFFFF);
+}
+
+
+/**************************************************************************/
+/*
+    getCount()
+
+    Return number of added samples, merged sketches included
+*/
+/**************************************************************************/
+uint32_t AHTxxQuantile::getCount() const
+{
+  return _count;
+}
+
+
+/**************************************************************************/
+/*
+    getSize()
+
+    Return number of retained items, up to AHTXX_QUANTILE_CAPACITY
+*/
+/**************************************************************************/
+uint16_t AHTxxQuantile::getSize() const
+{
+  return _bounds[0];
+}
+
+
+/**************************************************************************/
+/*
+    _insert()
+
+    Insert item with weight 2^level
+
+    NOTE:
+    - level 0 is last in "_items[]", insert there is append, merge of
+      higher levels shifts lower levels by one item
+*/
+/**************************************************************************/
+bool AHTxxQuantile::_insert(uint32_t rawValue, uint8_t level)
+{
+  if ((_bounds[0] >= AHTXX_QUANTILE_CAPACITY) && (_compress() != true)) return false;
+
+  while (level >= _levels)                                 //merge of bigger sketch, new empty top level
+  {
+    if (_levels >= AHTXX_QUANTILE_MAX_LEVELS) return false;
+
+    _levels++;
+
+    _bounds[_levels] = 0;
+  }
+
+  uint8_t position = _bounds[level];                       //end of level
+
+  for (uint8_t i = _bounds[0]; i > position; i--)
+  {
+    _items[i] = _items[i - 1];
+  }
+
+  _items[position] = rawValue;
+
+  for (uint8_t i = 0; i <= level; i++)
+  {
+    _bounds[i]++;
+  }
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    _compress()
+
+    Compact lowest level at or over its capacity
+
+    NOTE:
+    - full buffer always has such level, sum of level capacities is
+      less than AHTXX_QUANTILE_CAPACITY
+    - false=only top level can be compacted & there is no room for
+      new level
+*/
+/**************************************************************************/
+bool AHTxxQuantile::_compress()
+{
+  for (uint8_t level = 0; level < _levels; level++)
+  {
+    if ((_bounds[level] - _bounds[level + 1]) < _getCapacity(level)) continue;
+
+    if ((level == (_levels - 1)) && (_levels >= AHTXX_QUANTILE_MAX_LEVELS)) return false;
+
+    _compact(level);
+
+    return true;
+  }
+
+  return false;
+}
+
+
+/**************************************************************************/
+/*
+    _compact()
+
+    Sort level & move every second item one level up
+
+    NOTE:
+    - random odd/even choice keeps quantiles unbiased
+    - odd item stays on its level
+*/
+/**************************************************************************/
+void AHTxxQuantile::_compact(uint8_t level)
+{
+  uint8_t start = _bounds[level + 1];
+  uint8_t end   = _bounds[level];
+  uint8_t pairs = (end - start) >> 1;
+
+  if (pairs == 0) return;                                  //no reason to continue, nothing to compact
+
+  for (uint8_t i = start + 1; i < end; i++)                //insertion sort, level is small
+  {
+    uint32_t value = _items[i];
+    uint8_t  j     = i;
+
+    while ((j > start) && (_items[j - 1] > value))
+    {
+      _items[j] = _items[j - 1];
+
+      j--;
+    }
+
+    _items[j] = value;
+  }
+
+  _random ^= _random << 7;                                 //xorshift16
+  _random ^= _random >> 9;
+  _random ^= _random << 8;
+
+  uint8_t offset = _random & 0x01;
+
+  for (uint8_t i = 0; i < pairs; i++)                      //survivors, weight x2
+  {
+    _items[start + i] = _items[start + (i * 2) + offset];
+  }
+
+  if (((end - start) & 0x01) != 0) _items[start + pairs] = _items[end - 1];
+
+  for (uint8_t i = end; i < _bounds[0]; i++)               //close gap, lower levels move left
+  {
+    _items[i - pairs] = _items[i];
+  }
+
+  if (level == (_levels - 1))                              //new top level
+  {
+    _levels++;
+
+    _bounds[_levels] = 0;
+  }
+
+  _bounds[level + 1] = start + pairs;
+
+  for (uint8_t i = 0; i <= level; i++)
+  {
+    _bounds[i] -= pairs;
+  }
+}
+
+
+/**************************************************************************/
+/*
+    _getCapacity()
+
+    Return level capacity, K for top level, x2/3 per level below
+*/
+/**************************************************************************/
+uint8_t AHTxxQuantile::_getCapacity(uint8_t level) const
+{
+  uint8_t capacity = AHTXX_QUANTILE_K;
+
+  for (uint8_t depth = level + 1; depth < _levels; depth++)
+  {
+    capacity = ((uint16_t)capacity * 2) / 3;
+
+    if (capacity <= AHTXX_QUANTILE_MIN_WIDTH) return AHTXX_QUANTILE_MIN_WIDTH;
+  }
+
+  return capacity;
+}
+
+
+/**************************************************************************/
+/*
+    _getWeight()
+
+    Return estimated number of samples <= 20-bit raw value
+*/
+/**************************************************************************/
+uint32_t AHTxxQuantile::_getWeight(uint32_t rawValue) const
+{
+  uint32_t weight = 0;
+
+  for (uint8_t level = 0; level < _levels; level++)
+  {
+    uint32_t count = 0;
+
+    for (uint8_t i = _bounds[level + 1]; i < _bounds[level]; i++)
+    {
+      if (_items[i] <= rawValue) count++;
+    }
+
+    weight += count << level;
+  }
+
+  return weight;
+}
+
+
+/**************************************************************************/
+/*
+    _readValue()
+
+    Return little-endian value of 1..4 bytes
+*/
+/**************************************************************************/
+uint32_t AHTxxQuantile::_readValue(const uint8_t *buffer, uint8_t length)
+{
+  uint32_t value = 0;
+
+  while (length > 0)
+  {
+    length--;
+
+    value <<= 8;
+    value  |= buffer[length];
+  }
+
+  return value;
+}
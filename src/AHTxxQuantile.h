@@ -0,0 +1,85 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Mergeable quantile sketch of 20-bit raw humidity or temperature data:
+   - KLL compactor hierarchy, level h item stands for 2^h samples, full
+     level is sorted & every second item moves one level up
+   - fixed memory, AHTXX_QUANTILE_CAPACITY items, no heap, size doesn't
+     grow with number of samples
+   - p50/p95/p99 of any number of samples, rank error <2% for K=32,
+     ~1% for K=64
+   - serialized form is little-endian & mergeable, gateway sums sketches
+     of many nodes without raw samples, see "extras/benchmark"
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_QUANTILE_h
+#define AHTXX_QUANTILE_h
+
+
+#include <stdint.h>
+
+
+/* sketch size, build-wide flag only, class layout depends on it: pass -DAHTXX_QUANTILE_K=n to every
+   translation unit (PlatformIO "build_flags", Arduino IDE "compiler.cpp.extra_flags"), "#define" in
+   sketch resizes "_items[]" in sketch copy of class only & corrupts memory */
+#ifndef AHTXX_QUANTILE_K
+#define AHTXX_QUANTILE_K                32                                     //top level capacity, 32=~600 bytes RAM
+#endif
+
+#define AHTXX_QUANTILE_MAX_LEVELS       24                                     //up to ~K * 2^24 samples
+#define AHTXX_QUANTILE_MIN_WIDTH        2                                      //smallest level capacity
+#define AHTXX_QUANTILE_CAPACITY         (3 * AHTXX_QUANTILE_K + AHTXX_QUANTILE_MIN_WIDTH * AHTXX_QUANTILE_MAX_LEVELS)
+#define AHTXX_QUANTILE_VERSION          0x01                                   //serialized form version
+#define AHTXX_QUANTILE_HEADER_SIZE      16                                     //{version, K, levels, 0, count, min, max}
+#define AHTXX_QUANTILE_SERIALIZED_SIZE  (AHTXX_QUANTILE_HEADER_SIZE + AHTXX_QUANTILE_MAX_LEVELS + (AHTXX_QUANTILE_CAPACITY * 3))
+
+#if (AHTXX_QUANTILE_K < 8) || (AHTXX_QUANTILE_K > 64)
+#error "AHTXX_QUANTILE_K must be 8..64"
+#endif
+
+
+class AHTxxQuantile
+{
+  public:
+
+   AHTxxQuantile();
+
+   void     clear();
+   bool     add(uint32_t rawValue);
+   bool     merge(const AHTxxQuantile &sketch);
+   bool     merge(const uint8_t *buffer, uint16_t length);
+   uint16_t serialize(uint8_t *buffer, uint16_t length) const;
+   uint32_t getQuantile(float quantile) const;
+   float    getRank(uint32_t rawValue) const;
+   uint32_t getCount() const;
+   uint16_t getSize() const;
+
+
+  private:
+   uint32_t _items[AHTXX_QUANTILE_CAPACITY];    //top level first, level 0 last
+   uint8_t  _bounds[AHTXX_QUANTILE_MAX_LEVELS + 1]; //level h is "_items[_bounds[h + 1].._bounds[h] - 1]"
+   uint8_t  _levels;
+   uint32_t _count;
+   uint32_t _min;
+   uint32_t _max;
+   uint16_t _random;
+
+   bool     _insert(uint32_t rawValue, uint8_t level);
+   bool     _compress();
+   void     _compact(uint8_t level);
+   uint8_t  _getCapacity(uint8_t level) const;
+   uint32_t _getWeight(uint32_t rawValue) const;
+
+   static uint32_t _readValue(const uint8_t *buffer, uint8_t length);
+};
+
+#endif
@@ -0,0 +1,37 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Raw sample of one sensor:
+   - stored by "AHTxxSampler", kept per sensor by gateway state table
+   - no "Arduino.h" & "Wire.h", host tools include it without stand-ins
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_SAMPLE_h
+#define AHTXX_SAMPLE_h
+
+
+#include <stdint.h>
+
+
+#define AHTXX_RAW_ERROR          0xFFFFFFFF //raw data error, valid 20-bit raw data never exceeds 0xFFFFF
+
+
+typedef struct
+{
+  uint32_t time;                          //"millis()" at sweep start
+  uint32_t rawHumidity;                   //AHTXX_RAW_ERROR if error
+  uint32_t rawTemperature;                //AHTXX_RAW_ERROR if error
+  uint8_t  status;                        //"AHTxx::getStatus()"
+}
+AHTxxSample;
+
+#endif
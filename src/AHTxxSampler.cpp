@@ -0,0 +1,333 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "AHTxxSampler.h"
+
+
+#if defined(ESP32)
+#define AHTXX_MEMORY_BARRIER() __sync_synchronize()                    //writer & reader can be on different cores
+#else
+#define AHTXX_MEMORY_BARRIER() __asm__ __volatile__("" : : : "memory") //single core, stop compiler reordering only
+#endif
+
+
+/**************************************************************************/
+/*
+    Constructor
+*/
+/**************************************************************************/
+AHTxxSampler::AHTxxSampler()
+{
+  _count = 0;
+
+  for (uint8_t group = 0; group < AHTXX_SAMPLER_MAX_GROUPS; group++)
+  {
+    _sweepCount[group] = 0;
+    _sweepTime[group]  = 0;
+  }
+
+  #if defined(ESP32)
+  _period  = AHTXX_SELF_HEATING_INTERVAL;
+  _running = false;
+
+  for (uint8_t group = 0; group < AHTXX_SAMPLER_MAX_GROUPS; group++)
+  {
+    _tasks[group].sampler = this;
+    _tasks[group].group   = group;
+    _tasks[group].handle  = 0;
+  }
+  #endif
+}
+
+
+/**************************************************************************/
+/*
+    addSensor()
+
+    Add sensor to group
+
+    NOTE:
+    - all sensors of group must be on same I2C bus, see "AHTxx"
+      constructor, & every group on its own bus
+    - max AHTXX_GROUP_MAX_SENSORS per group
+    - call "begin()" of every sensor before first sweep
+    - index for "read()" is order of "addSensor()" calls, starts from 0
+    - true=success, false=group is full, wrong group or sampler
+      is running
+*/
+/**************************************************************************/
+bool AHTxxSampler::addSensor(AHTxx *sensor, uint8_t group)
+{
+  if ((_count >= AHTXX_SAMPLER_MAX_SENSORS) || (group >= AHTXX_SAMPLER_MAX_GROUPS)) return false; //no reason to continue
+
+  #if defined(ESP32)
+  if (_running == true) return false;                                    //no reason to continue, tasks read sensor list
+  #endif
+
+  if (_sensors[group].addSensor(sensor) != true) return false;           //no reason to continue, group is full
+
+  _groups[_count]         = group;
+  _slots[_count].sequence = 0;
+
+  _count++;
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    sweep()
+
+    Measure all sensors of group & store results
+
+    NOTE:
+    - blocking, all conversions overlap, takes ~80msec for any number
+      of sensors in group
+    - ESP32 tasks call it, on other boards call it from loop
+    - sensors not completed after AHTXX_GROUP_TIMEOUT are stored
+      with AHTXX_BUSY_ERROR status
+    - true=success, false=no sensors in group or wrong group
+*/
+/**************************************************************************/
+bool AHTxxSampler::sweep(uint8_t group)
+{
+  if (group >= AHTXX_SAMPLER_MAX_GROUPS) return false;                   //no reason to continue, wrong group
+
+  AHTxxGroup *sensors = &_sensors[group];
+
+  if (sensors->measure() != true) return false;                           //no reason to continue, empty group
+
+  /* store, group index is order of "addSensor()" calls within group */
+  uint8_t position = 0;
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    if (_groups[i] != group) continue;
+
+    AHTxxSample sample;
+
+    sample.time   = sensors->getStartTime();
+    sample.status = sensors->getStatus(position);
+
+    if (sample.status != AHTXX_BUSY_ERROR)
+    {
+      sample.rawHumidity    = sensors->getSensor(position)->readRawHumidity(AHTXX_USE_READ_DATA);
+      sample.rawTemperature = sensors->getSensor(position)->readRawTemperature(AHTXX_USE_READ_DATA);
+    }
+    else
+    {
+      sample.rawHumidity    = AHTXX_RAW_ERROR;                           //timeout
+      sample.rawTemperature = AHTXX_RAW_ERROR;
+    }
+
+    _store(i, &sample);
+
+    position++;
+  }
+
+  _sweepTime[group] = millis() - sensors->getStartTime();
+
+  _sweepCount[group]++;
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    read()
+
+    Copy last sample of sensor
+
+    NOTE:
+    - safe to call from any task/core while sweeps are running
+    - never blocks writer, retries if sample was updated during copy
+    - true=success, false=wrong index or no sample yet
+*/
+/**************************************************************************/
+bool AHTxxSampler::read(uint8_t index, AHTxxSample *sample)
+{
+  if (index >= _count) return false;                                      //no reason to continue, wrong index
+
+  uint32_t sequence;
+
+  do
+  {
+    sequence = _slots[index].sequence;
+
+    AHTXX_MEMORY_BARRIER();
+
+    *sample = _slots[index].sample;
+
+    AHTXX_MEMORY_BARRIER();
+  }
+  while (((sequence & 0x01) != 0) || (sequence != _slots[index].sequence));
+
+  return (sequence != 0);                                                 //0=never written
+}
+
+
+/**************************************************************************/
+/*
+    getSweepCount()
+
+    Return number of completed sweeps of group
+*/
+/**************************************************************************/
+uint32_t AHTxxSampler::getSweepCount(uint8_t group)
+{
+  if (group >= AHTXX_SAMPLER_MAX_GROUPS) return 0;
+
+  return _sweepCount[group];
+}
+
+
+/**************************************************************************/
+/*
+    getSweepTime()
+
+    Return duration of last sweep of group, in milliseconds
+*/
+/**************************************************************************/
+uint32_t AHTxxSampler::getSweepTime(uint8_t group)
+{
+  if (group >= AHTXX_SAMPLER_MAX_GROUPS) return 0;
+
+  return _sweepTime[group];
+}
+
+
+#if defined(ESP32)
+/**************************************************************************/
+/*
+    begin()
+
+    Start one sweep task per non-empty group
+
+    NOTE:
+    - period, time between sweep starts, in milliseconds, < 2000msec
+      leads to self-heating
+    - group n task is pinned to core n, single core chips run all
+      tasks on core 0
+    - true=success, false=already running or task not created
+*/
+/**************************************************************************/
+bool AHTxxSampler::begin(uint32_t period)
+{
+  if (_running == true) return false;                                     //no reason to continue, already running
+
+  _period  = period;
+  _running = true;
+
+  for (uint8_t group = 0; group < AHTXX_SAMPLER_MAX_GROUPS; group++)
+  {
+    bool found = false;
+
+    for (uint8_t i = 0; i < _count; i++)
+    {
+      if (_groups[i] == group) found = true;
+    }
+
+    if (found != true) continue;                                          //empty group
+
+    if (xTaskCreatePinnedToCore(_task, "AHTxxSampler", AHTXX_SAMPLER_STACK_SIZE, &_tasks[group], AHTXX_SAMPLER_PRIORITY, &_tasks[group].handle, group % portNUM_PROCESSORS) != pdPASS)
+    {
+      end();
+
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    end()
+
+    Stop sweep tasks
+
+    NOTE:
+    - waits for current sweep & period to finish, max ~period + 80msec
+*/
+/**************************************************************************/
+void AHTxxSampler::end()
+{
+  _running = false;
+
+  for (uint8_t group = 0; group < AHTXX_SAMPLER_MAX_GROUPS; group++)
+  {
+    while (_tasks[group].handle != 0)
+    {
+      delay(1);
+    }
+  }
+}
+
+
+/**************************************************************************/
+/*
+    _task()
+
+    Sweep task, one per group
+
+    NOTE:
+    - deletes itself after "end()"
+*/
+/**************************************************************************/
+void AHTxxSampler::_task(void *parameter)
+{
+  Task         *task     = (Task *)parameter;
+  AHTxxSampler *sampler  = task->sampler;
+  TickType_t    wakeTime = xTaskGetTickCount();
+
+  while (sampler->_running == true)
+  {
+    sampler->sweep(task->group);
+
+    vTaskDelayUntil(&wakeTime, pdMS_TO_TICKS(sampler->_period));
+  }
+
+  task->handle = 0;
+
+  vTaskDelete(NULL);
+}
+#endif
+
+
+
+
+/**************************************************************************/
+/*
+    _store()
+
+    Write sample to store
+
+    NOTE:
+    - sequence is odd during write, readers retry
+*/
+/**************************************************************************/
+void AHTxxSampler::_store(uint8_t index, const AHTxxSample *sample)
+{
+  _slots[index].sequence++;
+
+  AHTXX_MEMORY_BARRIER();
+
+  _slots[index].sample = *sample;
+
+  AHTXX_MEMORY_BARRIER();
+
+  _slots[index].sequence++;
+}
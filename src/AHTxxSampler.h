@@ -0,0 +1,88 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Parallel pipelined sweeps of sensor groups:
+   - one group per I2C bus, e.g. group 0 on "Wire" & group 1 on "Wire1"
+   - every sweep starts all sensors of the group & polls them together,
+     conversions overlap, see "AHTxxGroup.h"
+   - ESP32, every group runs in its own FreeRTOS task pinned to its own
+     core, two buses are swept at the same time
+   - other boards, call "sweep()" of every group from loop
+   - results go to lock-free store, sequence counter per sensor, reader
+     retries if sample was updated while being copied
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_SAMPLER_h
+#define AHTXX_SAMPLER_h
+
+
+#include "AHTxxGroup.h"
+#include "AHTxxSample.h"
+
+
+#define AHTXX_SAMPLER_MAX_GROUPS    2     //one group per core
+#define AHTXX_SAMPLER_MAX_SENSORS   (AHTXX_SAMPLER_MAX_GROUPS * AHTXX_GROUP_MAX_SENSORS) //all groups together
+#define AHTXX_SAMPLER_STACK_SIZE    3072  //ESP32 task stack, in bytes
+#define AHTXX_SAMPLER_PRIORITY      1     //ESP32 task priority, same as "loop()"
+
+
+class AHTxxSampler
+{
+  public:
+
+   AHTxxSampler();
+
+   bool     addSensor(AHTxx *sensor, uint8_t group = 0);
+   bool     sweep(uint8_t group);
+   bool     read(uint8_t index, AHTxxSample *sample);
+   uint32_t getSweepCount(uint8_t group);
+   uint32_t getSweepTime(uint8_t group);
+
+   #if defined(ESP32)
+   bool     begin(uint32_t period = AHTXX_SELF_HEATING_INTERVAL);
+   void     end();
+   #endif
+
+
+  private:
+   struct Slot
+   {
+     volatile uint32_t sequence;          //odd=write in progress
+     AHTxxSample       sample;
+   };
+
+   AHTxxGroup         _sensors[AHTXX_SAMPLER_MAX_GROUPS];
+   uint8_t            _groups[AHTXX_SAMPLER_MAX_SENSORS];
+   Slot               _slots[AHTXX_SAMPLER_MAX_SENSORS];
+   uint8_t            _count;
+   volatile uint32_t  _sweepCount[AHTXX_SAMPLER_MAX_GROUPS];
+   volatile uint32_t  _sweepTime[AHTXX_SAMPLER_MAX_GROUPS];
+
+   void     _store(uint8_t index, const AHTxxSample *sample);
+
+   #if defined(ESP32)
+   struct Task
+   {
+     AHTxxSampler  *sampler;
+     uint8_t        group;
+     TaskHandle_t   handle;
+   };
+
+   Task               _tasks[AHTXX_SAMPLER_MAX_GROUPS];
+   uint32_t           _period;
+   volatile bool      _running;
+
+   static void _task(void *parameter);
+   #endif
+};
+
+#endif
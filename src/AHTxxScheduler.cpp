@@ -0,0 +1,350 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "AHTxxScheduler.h"
+
+
+/**************************************************************************/
+/*
+    Constructor
+
+    NOTE:
+    - maxActive, max sensors converting at same time, 1=no overlap
+*/
+/**************************************************************************/
+AHTxxScheduler::AHTxxScheduler(uint8_t maxActive)
+{
+  _count     = 0;
+  _maxActive = (maxActive != 0) ? maxActive : 1;
+  _callback  = 0;
+}
+
+
+/**************************************************************************/
+/*
+    addSensor()
+
+    Add sensor & return its index
+
+    NOTE:
+    - call "begin()" of sensor before first "update()"
+    - period, time between measurement starts, in milliseconds,
+      < 2000msec leads to self-heating
+    - deadline, max time from scheduled start to data ready, in
+      milliseconds, 0=same as period, < 80msec is always missed
+    - first measurement is scheduled immediately
+    - AHTXX_SCHEDULER_NONE=scheduler is full or period is 0
+*/
+/**************************************************************************/
+uint8_t AHTxxScheduler::addSensor(AHTxx *sensor, uint32_t period, uint32_t deadline)
+{
+  if ((_count >= AHTXX_SCHEDULER_MAX_SENSORS) || (period == 0)) return AHTXX_SCHEDULER_NONE; //no reason to continue
+
+  Task *task = &_tasks[_count];
+
+  task->sensor       = sensor;
+  task->period       = period;
+  task->deadline     = (deadline != 0) ? deadline : period;
+  task->release      = millis();
+  task->responseTime = 0;
+  task->misses       = 0;
+  task->samples      = 0;
+  task->active       = false;
+  task->late         = false;
+
+  _count++;
+
+  return _count - 1;
+}
+
+
+/**************************************************************************/
+/*
+    setCallback()
+
+    Set function called after every completed measurement
+
+    NOTE:
+    - called from "update()", not from interrupt
+    - 0=no callback
+*/
+/**************************************************************************/
+void AHTxxScheduler::setCallback(AHTxxSchedulerCallback callback)
+{
+  _callback = callback;
+}
+
+
+/**************************************************************************/
+/*
+    begin()
+
+    Restart schedule, all sensors are released now
+
+    NOTE:
+    - measurements in progress are completed by next "update()"
+*/
+/**************************************************************************/
+void AHTxxScheduler::begin()
+{
+  uint32_t time = millis();
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    _tasks[i].release = time;
+    _tasks[i].late    = false;
+  }
+}
+
+
+/**************************************************************************/
+/*
+    update()
+
+    Advance all measurements & return number of completed
+
+    NOTE:
+    - call from loop as often as possible, doesn't wait for sensors
+    - sensors in progress & released sensors are served in order of
+      nearest absolute deadline, release + deadline
+    - completed sensor is released again after its period, releases
+      with already passed deadline are skipped & counted as misses
+*/
+/**************************************************************************/
+uint8_t AHTxxScheduler::update()
+{
+  uint8_t order[AHTXX_SCHEDULER_MAX_SENSORS];
+  uint8_t count     = _sort(order, millis());
+  uint8_t active    = 0;
+  uint8_t completed = 0;
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    if (_tasks[i].active == true) active++;
+  }
+
+  for (uint8_t i = 0; i < count; i++)
+  {
+    uint8_t index = order[i];
+    Task   *task  = &_tasks[index];
+
+    if (task->active == true)
+    {
+      if (task->sensor->updateAsync() == AHTXX_ASYNC_READY)
+      {
+        _complete(index, millis());
+
+        completed++;
+        active--;
+      }
+      else if ((task->late != true) && ((int32_t)(millis() - (task->release + task->deadline)) > 0))
+      {
+        task->late = true;                                                 //count miss now, sensor may never complete
+        task->misses++;
+      }
+
+      continue;
+    }
+
+    if (active >= _maxActive) continue;                                    //released sensor waits for free slot
+
+    if (task->sensor->startMeasurementAsync() == true)                     //false=transport queue full, try again later
+    {
+      task->active = true;
+
+      active++;
+    }
+  }
+
+  return completed;
+}
+
+
+/**************************************************************************/
+/*
+    getIdleTime()
+
+    Return time until next release, in milliseconds
+
+    NOTE:
+    - 0=measurement in progress or sensor released, keep calling "update()"
+    - MCU can sleep for this time
+*/
+/**************************************************************************/
+uint32_t AHTxxScheduler::getIdleTime()
+{
+  uint32_t time     = millis();
+  uint32_t idleTime = 0xFFFFFFFF;
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    int32_t wait = (int32_t)(_tasks[i].release - time);
+
+    if ((_tasks[i].active == true) || (wait <= 0)) return 0;               //no reason to continue
+
+    if ((uint32_t)wait < idleTime) idleTime = wait;
+  }
+
+  return idleTime;
+}
+
+
+/**************************************************************************/
+/*
+    getDeadlineMisses()
+
+    Return number of missed deadlines of sensor
+
+    NOTE:
+    - late completion & skipped releases, see "update()"
+*/
+/**************************************************************************/
+uint32_t AHTxxScheduler::getDeadlineMisses(uint8_t index)
+{
+  if (index >= _count) return 0;
+
+  return _tasks[index].misses;
+}
+
+
+/**************************************************************************/
+/*
+    getDeadlineMisses()
+
+    Return number of missed deadlines of all sensors
+*/
+/**************************************************************************/
+uint32_t AHTxxScheduler::getDeadlineMisses()
+{
+  uint32_t misses = 0;
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    misses += _tasks[i].misses;
+  }
+
+  return misses;
+}
+
+
+/**************************************************************************/
+/*
+    getSampleCount()
+
+    Return number of completed measurements of sensor, with & without
+    errors
+*/
+/**************************************************************************/
+uint32_t AHTxxScheduler::getSampleCount(uint8_t index)
+{
+  if (index >= _count) return 0;
+
+  return _tasks[index].samples;
+}
+
+
+/**************************************************************************/
+/*
+    getResponseTime()
+
+    Return time from release to completion of last measurement of
+    sensor, in milliseconds
+
+    NOTE:
+    - ~80msec if bus & sensor were free
+*/
+/**************************************************************************/
+uint32_t AHTxxScheduler::getResponseTime(uint8_t index)
+{
+  if (index >= _count) return 0;
+
+  return _tasks[index].responseTime;
+}
+
+
+
+
+/**************************************************************************/
+/*
+    _sort()
+
+    Collect active & released sensors in order of absolute deadline,
+    return their number
+
+    NOTE:
+    - insertion sort, max AHTXX_SCHEDULER_MAX_SENSORS values
+    - times are compared as signed difference, "millis()" overflow safe
+*/
+/**************************************************************************/
+uint8_t AHTxxScheduler::_sort(uint8_t *order, uint32_t time)
+{
+  uint8_t count = 0;
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    if ((_tasks[i].active != true) && ((int32_t)(time - _tasks[i].release) < 0)) continue; //not released yet
+
+    uint32_t deadline = _tasks[i].release + _tasks[i].deadline;
+    uint8_t  j        = count;
+
+    while ((j > 0) && ((int32_t)(deadline - (_tasks[order[j - 1]].release + _tasks[order[j - 1]].deadline)) < 0))
+    {
+      order[j] = order[j - 1];
+
+      j--;
+    }
+
+    order[j] = i;
+
+    count++;
+  }
+
+  return count;
+}
+
+
+/**************************************************************************/
+/*
+    _complete()
+
+    Account completed measurement, schedule next release & call callback
+*/
+/**************************************************************************/
+void AHTxxScheduler::_complete(uint8_t index, uint32_t time)
+{
+  Task *task = &_tasks[index];
+
+  task->responseTime = time - task->release;
+  task->active       = false;
+
+  task->samples++;
+
+  if ((task->late != true) && (task->responseTime > task->deadline)) task->misses++;
+
+  task->late = false;
+
+  /* next release */
+  task->release += task->period;
+
+  int32_t overdue = (int32_t)(time - (task->release + task->deadline));
+
+  if (overdue >= 0)                                                        //next deadline already passed, skip releases
+  {
+    uint32_t skipped = ((uint32_t)overdue / task->period) + 1;
+
+    task->release += skipped * task->period;
+    task->misses  += skipped;
+  }
+
+  if (_callback != 0) _callback(index, task->sensor);
+}
@@ -0,0 +1,78 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Earliest-deadline-first scheduler of many sensors:
+   - every sensor has own period & deadline, e.g. 2sec process control
+     & 5min ambient logging on same bus
+   - non-blocking, call "update()" from loop, conversions of different
+     sensors overlap
+   - triggers & reads are ordered by nearest deadline, urgent sensor
+     gets bus first
+   - deadline misses are counted per sensor
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_SCHEDULER_h
+#define AHTXX_SCHEDULER_h
+
+
+#include "AHTxx.h"
+
+
+#define AHTXX_SCHEDULER_MAX_SENSORS  16    //max sensors in scheduler
+#define AHTXX_SCHEDULER_MAX_ACTIVE   16    //max overlapping conversions, lower it if transport queue is small
+#define AHTXX_SCHEDULER_NONE         0xFF  //no sensor index
+
+
+typedef void (*AHTxxSchedulerCallback)(uint8_t index, AHTxx *sensor); //measurement completed, call "sensor->getStatus()" & "sensor->read...(AHTXX_USE_READ_DATA)"
+
+
+class AHTxxScheduler
+{
+  public:
+
+   AHTxxScheduler(uint8_t maxActive = AHTXX_SCHEDULER_MAX_ACTIVE);
+
+   uint8_t  addSensor(AHTxx *sensor, uint32_t period, uint32_t deadline = 0);
+   void     setCallback(AHTxxSchedulerCallback callback);
+   void     begin();
+   uint8_t  update();
+   uint32_t getIdleTime();
+   uint32_t getDeadlineMisses(uint8_t index);
+   uint32_t getDeadlineMisses();
+   uint32_t getSampleCount(uint8_t index);
+   uint32_t getResponseTime(uint8_t index);
+
+
+  private:
+   struct Task
+   {
+     AHTxx   *sensor;
+     uint32_t period;                    //time between releases, in milliseconds
+     uint32_t deadline;                  //max time from release to completion, in milliseconds
+     uint32_t release;                   //"millis()" of current release
+     uint32_t responseTime;              //last release to completion time, in milliseconds
+     uint32_t misses;
+     uint32_t samples;
+     bool     active;                    //measurement in progress
+     bool     late;                      //miss already counted for current release
+   };
+
+   Task                   _tasks[AHTXX_SCHEDULER_MAX_SENSORS];
+   uint8_t                _count;
+   uint8_t                _maxActive;
+   AHTxxSchedulerCallback _callback;
+
+   uint8_t  _sort(uint8_t *order, uint32_t time);
+   void     _complete(uint8_t index, uint32_t time);
+};
+
+#endif
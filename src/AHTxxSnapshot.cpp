@@ -0,0 +1,218 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "AHTxxSnapshot.h"
+
+
+/**************************************************************************/
+/*
+    Constructor
+*/
+/**************************************************************************/
+AHTxxSnapshot::AHTxxSnapshot()
+{
+}
+
+
+/**************************************************************************/
+/*
+    addSensor()
+
+    Add sensor to the snapshot
+
+    NOTE:
+    - call "begin()" of every sensor before first "trigger()"
+    - sensors on same address must be on different buses
+    - sensors in cycle mode are rejected, they measure by themselves &
+      get no measurement command, so they can't be synchronized
+    - true=success, false=snapshot is full, in progress or sensor is in
+      cycle mode
+*/
+/**************************************************************************/
+bool AHTxxSnapshot::addSensor(AHTxx *sensor)
+{
+  if (sensor->getMode() == AHTXX_CYCLE_MODE) return false; //no reason to continue
+
+  return _group.addSensor(sensor);
+}
+
+
+/**************************************************************************/
+/*
+    read()
+
+    Take snapshot & wait for all sensors
+
+    NOTE:
+    - blocking, takes ~80msec for any number of sensors
+    - true=all sensors measured without errors, false=error or any
+      sensor is in cycle mode
+*/
+/**************************************************************************/
+bool AHTxxSnapshot::read()
+{
+  if (_isCycleMode() == true) return false;             //sensor gets no command, snapshot is not synchronized
+
+  if (_group.measure() != true) return false;
+
+  for (uint8_t i = 0; i < _group.getCount(); i++)
+  {
+    if (getStatus(i) != AHTXX_NO_ERROR) return false;
+  }
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    trigger()
+
+    Send measurement command to all sensors back-to-back
+
+    NOTE:
+    - nothing else is done between commands, skew is only I2C time,
+      ~400usec per sensor at 100KHz with "Wire.h" transport
+    - nothing is started if any sensor was switched to cycle mode after
+      "addSensor()", call "setNormalMode()" of that sensor first
+    - true=started, false=no sensors, snapshot in progress or sensor is
+      in cycle mode
+*/
+/**************************************************************************/
+bool AHTxxSnapshot::trigger()
+{
+  if (_isCycleMode() == true) return false;             //sensor gets no command, snapshot is not synchronized
+
+  return _group.start();
+}
+
+
+/**************************************************************************/
+/*
+    poll()
+
+    Advance measurement of all sensors
+
+    NOTE:
+    - true=all sensors are ready or AHTXX_GROUP_TIMEOUT is over,
+      false=in progress
+*/
+/**************************************************************************/
+bool AHTxxSnapshot::poll()
+{
+  return _group.poll();
+}
+
+
+/**************************************************************************/
+/*
+    getSkew()
+
+    Return time between first & last measurement command, in microseconds
+*/
+/**************************************************************************/
+uint32_t AHTxxSnapshot::getSkew()
+{
+  return _group.getSkew();
+}
+
+
+/**************************************************************************/
+/*
+    getTime()
+
+    Return snapshot timestamp, "millis()" of last "trigger()"
+*/
+/**************************************************************************/
+uint32_t AHTxxSnapshot::getTime()
+{
+  return _group.getStartTime();
+}
+
+
+/**************************************************************************/
+/*
+    getStatus()
+
+    Return sensor status in last snapshot
+
+    NOTE:
+    - index is order of "addSensor()" calls, starts from 0
+    - AHTXX_BUSY_ERROR=sensor didn't complete before timeout or
+      snapshot in progress, call "poll()" to advance
+    - AHTXX_ERROR=wrong index or no snapshot yet
+    - pure getter, sensor state is not changed
+*/
+/**************************************************************************/
+uint8_t AHTxxSnapshot::getStatus(uint8_t index)
+{
+  return _group.getStatus(index);
+}
+
+
+/**************************************************************************/
+/*
+    getTemperature()
+
+    Return sensor temperature in last snapshot, in C
+
+    NOTE:
+    - returns AHTXX_ERROR if error occurs
+*/
+/**************************************************************************/
+float AHTxxSnapshot::getTemperature(uint8_t index)
+{
+  if (getStatus(index) != AHTXX_NO_ERROR) return AHTXX_ERROR;
+
+  return _group.getSensor(index)->readTemperature(AHTXX_USE_READ_DATA);
+}
+
+
+/**************************************************************************/
+/*
+    getHumidity()
+
+    Return sensor relative humidity in last snapshot, in %
+
+    NOTE:
+    - returns AHTXX_ERROR if error occurs
+*/
+/**************************************************************************/
+float AHTxxSnapshot::getHumidity(uint8_t index)
+{
+  if (getStatus(index) != AHTXX_NO_ERROR) return AHTXX_ERROR;
+
+  return _group.getSensor(index)->readHumidity(AHTXX_USE_READ_DATA);
+}
+
+
+/**************************************************************************/
+/*
+    _isCycleMode()
+
+    Return true if any sensor is in cycle mode
+
+    NOTE:
+    - mode may be changed after "addSensor()", e.g. by "setCycleMode()"
+      or energy mode policy
+*/
+/**************************************************************************/
+bool AHTxxSnapshot::_isCycleMode()
+{
+  for (uint8_t i = 0; i < _group.getCount(); i++)
+  {
+    if (_group.getSensor(i)->getMode() == AHTXX_CYCLE_MODE) return true;
+  }
+
+  return false;
+}
@@ -0,0 +1,57 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Synchronized snapshot of many sensors:
+   - all measurement commands are sent back-to-back before any data
+     is read, so all sensors sample within one tight window
+   - reports skew between first & last measurement command
+   - normal & command mode sensors only, cycle mode sensors measure by
+     themselves & are rejected
+   - start, poll & timeout are shared with other groups, see "AHTxxGroup.h"
+   - spatial T/RH gradients are not polluted by 80msec per sensor
+     of sequential "readTemperature()" calls
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_SNAPSHOT_h
+#define AHTXX_SNAPSHOT_h
+
+
+#include "AHTxxGroup.h"
+
+
+#define AHTXX_SNAPSHOT_MAX_SENSORS  AHTXX_GROUP_MAX_SENSORS //max sensors in one snapshot
+
+
+class AHTxxSnapshot
+{
+  public:
+
+   AHTxxSnapshot();
+
+   bool     addSensor(AHTxx *sensor);
+   bool     read();
+   bool     trigger();
+   bool     poll();
+   uint32_t getSkew();
+   uint32_t getTime();
+   uint8_t  getStatus(uint8_t index);
+   float    getTemperature(uint8_t index);
+   float    getHumidity(uint8_t index);
+
+
+  private:
+   AHTxxGroup _group;
+
+   bool     _isCycleMode();
+};
+
+#endif
@@ -0,0 +1,112 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "AHTxxStream.h"
+
+
+/**************************************************************************/
+/*
+    Constructor
+
+    NOTE:
+    - node, sender id, must be unique when host merges streams of many
+      boards
+*/
+/**************************************************************************/
+AHTxxStreamWriter::AHTxxStreamWriter(Print &output, uint8_t node)
+{
+  _output       = &output;
+  _node         = node;
+  _sequence     = 0;
+  _droppedCount = 0;
+}
+
+
+/**************************************************************************/
+/*
+    write()
+
+    Send last measurement of sensor, return number of bytes written
+
+    NOTE:
+    - call after "read...(AHTXX_FORCE_READ_DATA)" or when "updateAsync()"
+      returns AHTXX_ASYNC_READY, no I2C transfer is done here
+    - timestamp is "millis()" of this call
+    - error status is sent too, frame carries last received data
+*/
+/**************************************************************************/
+uint8_t AHTxxStreamWriter::write(uint8_t sensorIndex, AHTxx &sensor)
+{
+  return write(sensorIndex, sensor, millis());
+}
+
+
+/**************************************************************************/
+/*
+    write()
+
+    Send last measurement of sensor with own timestamp
+
+    NOTE:
+    - time, e.g. "AHTxxSampler" sample time or "micros()/1000"
+    - sequence number is advanced even if packet didn't fit output
+      buffer, host sees lost packet as gap
+*/
+/**************************************************************************/
+uint8_t AHTxxStreamWriter::write(uint8_t sensorIndex, AHTxx &sensor, uint32_t time)
+{
+  AHTxxPacket packet;
+  uint8_t     buffer[AHTXX_PACKET_MAX_SIZE];
+
+  packet.node     = _node;
+  packet.sensor   = sensorIndex;
+  packet.sequence = _sequence;
+  packet.time     = time;
+  packet.status   = sensor.getStatus();
+  packet.length   = sensor.getRawData(packet.frame);
+
+  _sequence++;
+
+  uint8_t size    = ahtxxPacketEncode(&packet, buffer);
+  uint8_t written = _output->write(buffer, size);
+
+  if (written != size) _droppedCount++;                   //partial packet fails CRC on host
+
+  return written;
+}
+
+
+/**************************************************************************/
+/*
+    getSequence()
+
+    Return sequence number of next packet
+*/
+/**************************************************************************/
+uint16_t AHTxxStreamWriter::getSequence()
+{
+  return _sequence;
+}
+
+
+/**************************************************************************/
+/*
+    getDroppedCount()
+
+    Return number of packets not fully written to output
+*/
+/**************************************************************************/
+uint32_t AHTxxStreamWriter::getDroppedCount()
+{
+  return _droppedCount;
+}
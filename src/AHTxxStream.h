@@ -0,0 +1,48 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Binary stream writer:
+   - sends raw sensor frame as 22 bytes COBS packet, see "AHTxxPacket.h",
+     instead of ~30 bytes of text & "float" formatting per sample
+   - ~500 packets/sec at 115200 baud, ~4000 packets/sec at 1Mbaud
+   - any "Print" output, "Serial", "SoftwareSerial", "WiFiClient"
+   - host decoder & gap detection, see "extras/decoder"
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_STREAM_h
+#define AHTXX_STREAM_h
+
+
+#include "AHTxx.h"
+#include "AHTxxPacket.h"
+
+
+class AHTxxStreamWriter
+{
+  public:
+
+   AHTxxStreamWriter(Print &output, uint8_t node = 0);
+
+   uint8_t  write(uint8_t sensorIndex, AHTxx &sensor);
+   uint8_t  write(uint8_t sensorIndex, AHTxx &sensor, uint32_t time);
+   uint16_t getSequence();
+   uint32_t getDroppedCount();
+
+
+  private:
+   Print   *_output;
+   uint8_t  _node;
+   uint16_t _sequence;
+   uint32_t _droppedCount;
+};
+
+#endif
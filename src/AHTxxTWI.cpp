@@ -0,0 +1,464 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "AHTxxTWI.h"
+
+#if defined(__AVR__) && defined(TWCR)
+
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+
+/* TWI status codes, TWSR & 0xF8 */
+#define AHTXX_TWI_START             0x08  //START transmitted
+#define AHTXX_TWI_REPEATED_START    0x10  //repeated START transmitted
+#define AHTXX_TWI_MT_SLA_ACK        0x18  //SLA+W transmitted, ACK received
+#define AHTXX_TWI_MT_SLA_NACK       0x20  //SLA+W transmitted, NACK received
+#define AHTXX_TWI_MT_DATA_ACK       0x28  //data transmitted, ACK received
+#define AHTXX_TWI_MT_DATA_NACK      0x30  //data transmitted, NACK received
+#define AHTXX_TWI_ARBITRATION_LOST  0x38  //arbitration lost in SLA+R/W or data
+#define AHTXX_TWI_MR_SLA_ACK        0x40  //SLA+R transmitted, ACK received
+#define AHTXX_TWI_MR_SLA_NACK       0x48  //SLA+R transmitted, NACK received
+#define AHTXX_TWI_MR_DATA_ACK       0x50  //data received, ACK returned
+#define AHTXX_TWI_MR_DATA_NACK      0x58  //data received, NACK returned
+
+#if defined(AHTXX_USE_TWI_INTERRUPT)
+#define AHTXX_TWI_TWIE              _BV(TWIE)
+#else
+#define AHTXX_TWI_TWIE              0
+#endif
+
+AHTxxTWI AHTxxTwi;
+
+
+/**************************************************************************/
+/*
+    Constructor
+*/
+/**************************************************************************/
+AHTxxTWI::AHTxxTWI()
+{
+  _head           = 0;
+  _tail           = 0;
+  _index          = 0;
+  _active         = false;
+  _result         = AHTXX_TWI_NO_ERROR;
+  _startTime      = 0;
+  _transferTime   = 0;
+  _interruptCount = 0;
+}
+
+
+/**************************************************************************/
+/*
+    begin()
+
+    Initialize TWI hardware
+
+    NOTE:
+    - enables internal pull-ups on SDA & SCL, same as "Wire.begin()"
+    - SCL = F_CPU / (16 + 2 * TWBR * prescaler), prescaler=1
+    - in polled mode call after "Wire.begin()" if both are used,
+      both share the same speed
+*/
+/**************************************************************************/
+void AHTxxTWI::begin(uint32_t speed)
+{
+  digitalWrite(SDA, HIGH);
+  digitalWrite(SCL, HIGH);
+
+  TWSR = 0;                                       //prescaler=1
+  TWBR = ((F_CPU / speed) - 16) / 2;
+
+  #if defined(AHTXX_USE_TWI_INTERRUPT)
+  TWCR = _BV(TWEN) | _BV(TWIE);
+  #else
+  TWCR = _BV(TWEN) | _BV(TWIE) | _BV(TWEA);       //"Wire.h" idle settings, TWI_vect belongs to "Wire.h"
+  #endif
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    if ((_active == false) && (_tail != _head)) _start(); //transactions queued after "end()"
+  }
+}
+
+
+/**************************************************************************/
+/*
+    end()
+
+    Disable TWI hardware & release SDA/SCL pins
+
+    NOTE:
+    - same as "Wire.end()", pins can be driven by "AHTxx::clearBus()"
+    - queued transactions are finished with AHTXX_TWI_ERROR, waiting
+      callers see error instead of waiting forever on stuck bus
+*/
+/**************************************************************************/
+void AHTxxTWI::end()
+{
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    TWCR &= ~(_BV(TWEN) | _BV(TWIE) | _BV(TWEA));
+
+    uint8_t head = _head;                           //transactions queued by callbacks below wait for "begin()"
+
+    _active = true;                                 //callbacks can't start new transfer on disabled TWI
+
+    while (_tail != head)
+    {
+      AHTXX_TWI_TRANSACTION *transaction = &_queue[_tail];
+
+      _tail   = (_tail + 1) & (AHTXX_TWI_QUEUE_SIZE - 1);
+      _result = AHTXX_TWI_ERROR;
+
+      if (transaction->callback != 0) transaction->callback(transaction->context, AHTXX_TWI_ERROR);
+    }
+
+    _active = false;
+  }
+
+  digitalWrite(SDA, LOW);                           //internal pull-ups off
+  digitalWrite(SCL, LOW);
+}
+
+
+/**************************************************************************/
+/*
+    write()
+
+    Queue write transaction, {START, SLA+W, data[0]..data[n-1], STOP}
+
+    NOTE:
+    - "data" must stay valid until callback is called
+    - callback is called with AHTXX_TWI_... result, in interrupt
+      mode from TWI_vect, keep it short
+    - true=queued, false=queue full
+*/
+/**************************************************************************/
+bool AHTxxTWI::write(uint8_t address, const uint8_t *data, uint8_t length, AHTxxTWICallback callback, void *context)
+{
+  return _submit(address << 1, (uint8_t *)data, length, callback, context);
+}
+
+
+/**************************************************************************/
+/*
+    read()
+
+    Queue read transaction, {START, SLA+R, data[0]..data[n-1], STOP}
+
+    NOTE:
+    - see "write()" NOTE
+    - length must be > 0
+*/
+/**************************************************************************/
+bool AHTxxTWI::read(uint8_t address, uint8_t *data, uint8_t length, AHTxxTWICallback callback, void *context)
+{
+  if (length == 0) return false;                  //no reason to continue, nothing to read
+
+  return _submit((address << 1) | 0x01, data, length, callback, context);
+}
+
+
+/**************************************************************************/
+/*
+    poll()
+
+    Advance transfer in polled mode
+
+    NOTE:
+    - call as often as possible, every call handles at most one
+      TWI event, ~90usec per byte at 100KHz
+    - does nothing in interrupt mode
+*/
+/**************************************************************************/
+void AHTxxTWI::poll()
+{
+  #if !defined(AHTXX_USE_TWI_INTERRUPT)
+  if ((_active == true) && ((TWCR & _BV(TWINT)) != 0)) handleInterrupt();
+  #endif
+}
+
+
+/**************************************************************************/
+/*
+    isIdle()
+
+    Return true if all queued transactions are completed
+*/
+/**************************************************************************/
+bool AHTxxTWI::isIdle()
+{
+  return (_active == false);
+}
+
+
+/**************************************************************************/
+/*
+    getResult()
+
+    Return result of last completed transaction
+*/
+/**************************************************************************/
+uint8_t AHTxxTWI::getResult()
+{
+  return _result;
+}
+
+
+/**************************************************************************/
+/*
+    getTransferTime()
+
+    Return duration of last completed transaction, in microseconds
+
+    NOTE:
+    - CPU-free time per transaction is about "getTransferTime()" minus
+      "getInterruptCount()" * ~5usec of TWI_vect at 16MHz
+*/
+/**************************************************************************/
+uint32_t AHTxxTWI::getTransferTime()
+{
+  uint32_t value;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    value = _transferTime;
+  }
+
+  return value;
+}
+
+
+/**************************************************************************/
+/*
+    getInterruptCount()
+
+    Return number of handled TWI events since last "begin()" or rollover
+*/
+/**************************************************************************/
+uint16_t AHTxxTWI::getInterruptCount()
+{
+  uint16_t value;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    value = _interruptCount;
+  }
+
+  return value;
+}
+
+
+/**************************************************************************/
+/*
+    handleInterrupt()
+
+    Advance active transaction by one TWI event
+
+    NOTE:
+    - master transmitter & master receiver state machine, see
+      ATmega328P datasheet "2-wire Serial Interface"
+*/
+/**************************************************************************/
+void AHTxxTWI::handleInterrupt()
+{
+  AHTXX_TWI_TRANSACTION *transaction = &_queue[_tail];
+
+  _interruptCount++;
+
+  switch (TWSR & 0xF8)
+  {
+    case AHTXX_TWI_START:
+    case AHTXX_TWI_REPEATED_START:
+      TWDR   = transaction->address;               //send SLA+R/W
+      _index = 0;
+
+      _control(0);
+      break;
+
+    case AHTXX_TWI_MT_SLA_ACK:
+    case AHTXX_TWI_MT_DATA_ACK:
+      if (_index < transaction->length)
+      {
+        TWDR = transaction->data[_index++];        //send next byte
+
+        _control(0);
+      }
+      else
+      {
+        _finish(AHTXX_TWI_NO_ERROR);
+      }
+      break;
+
+    case AHTXX_TWI_MR_DATA_ACK:
+      transaction->data[_index++] = TWDR;          //save byte & fall through to request next one
+
+    case AHTXX_TWI_MR_SLA_ACK:
+      if ((transaction->length - _index) > 1) _control(_BV(TWEA)); //more bytes to come, ACK next byte
+      else                                    _control(0);         //NACK last byte
+      break;
+
+    case AHTXX_TWI_MR_DATA_NACK:
+      transaction->data[_index++] = TWDR;          //last byte
+
+      _finish(AHTXX_TWI_NO_ERROR);
+      break;
+
+    case AHTXX_TWI_MT_SLA_NACK:
+    case AHTXX_TWI_MT_DATA_NACK:
+    case AHTXX_TWI_MR_SLA_NACK:
+      _finish(AHTXX_TWI_ACK_ERROR);
+      break;
+
+    case AHTXX_TWI_ARBITRATION_LOST:
+      _finish(AHTXX_TWI_ACK_ERROR);
+      break;
+
+    default:
+      _finish(AHTXX_TWI_ERROR);                   //bus error, illegal START/STOP
+      break;
+  }
+}
+
+
+
+
+/**************************************************************************/
+/*
+    _submit()
+
+    Add transaction to queue & start transfer if bus is idle
+*/
+/**************************************************************************/
+bool AHTxxTWI::_submit(uint8_t address, uint8_t *data, uint8_t length, AHTxxTWICallback callback, void *context)
+{
+  bool queued = false;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    uint8_t next = (_head + 1) & (AHTXX_TWI_QUEUE_SIZE - 1);
+
+    if (next != _tail)                              //queue is full when head catches tail of active transaction
+    {
+      AHTXX_TWI_TRANSACTION *transaction = &_queue[_head];
+
+      transaction->address  = address;
+      transaction->data     = data;
+      transaction->length   = length;
+      transaction->callback = callback;
+      transaction->context  = context;
+
+      _head  = next;
+      queued = true;
+
+      if (_active == false) _start();
+    }
+  }
+
+  return queued;
+}
+
+
+/**************************************************************************/
+/*
+    _start()
+
+    Send START for transaction at queue tail
+
+    NOTE:
+    - waits for previous STOP to complete, takes few microseconds
+*/
+/**************************************************************************/
+void AHTxxTWI::_start()
+{
+  while ((TWCR & _BV(TWSTO)) != 0);                 //previous STOP still on the bus
+
+  _active    = true;
+  _startTime = micros();
+
+  _control(_BV(TWSTA));
+}
+
+
+/**************************************************************************/
+/*
+    _control()
+
+    Write TWCR, clear TWINT to continue transfer
+*/
+/**************************************************************************/
+void AHTxxTWI::_control(uint8_t value)
+{
+  TWCR = _BV(TWEN) | _BV(TWINT) | AHTXX_TWI_TWIE | value;
+}
+
+
+/**************************************************************************/
+/*
+    _finish()
+
+    Release bus, report result & start next queued transaction
+
+    NOTE:
+    - arbitration lost, release bus without STOP
+    - in polled mode "Wire.h" TWI settings restored when queue is empty
+*/
+/**************************************************************************/
+void AHTxxTWI::_finish(uint8_t result)
+{
+  AHTXX_TWI_TRANSACTION *transaction = &_queue[_tail];
+
+  if   ((TWSR & 0xF8) == AHTXX_TWI_ARBITRATION_LOST) _control(0);
+  else                                                _control(_BV(TWSTO));
+
+  if ((result == AHTXX_TWI_NO_ERROR) && (_index != transaction->length)) result = AHTXX_TWI_DATA_ERROR;
+
+  _result       = result;
+  _transferTime = micros() - _startTime;
+  _tail         = (_tail + 1) & (AHTXX_TWI_QUEUE_SIZE - 1);
+  _active       = false;
+
+  if (transaction->callback != 0) transaction->callback(transaction->context, result); //callback may queue next transaction
+
+  if ((_active == false) && (_tail != _head))
+  {
+    _start();                                     //next queued transaction
+  }
+  #if !defined(AHTXX_USE_TWI_INTERRUPT)
+  else if (_active == false)
+  {
+    while ((TWCR & _BV(TWSTO)) != 0);
+
+    TWCR = _BV(TWEN) | _BV(TWIE) | _BV(TWEA);      //"Wire.h" idle settings
+  }
+  #endif
+}
+
+
+#if defined(AHTXX_USE_TWI_INTERRUPT)
+/**************************************************************************/
+/*
+    TWI_vect
+
+    TWI interrupt, advances active transaction
+*/
+/**************************************************************************/
+ISR(TWI_vect)
+{
+  AHTxxTwi.handleInterrupt();
+}
+#endif
+
+#endif
@@ -0,0 +1,109 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Asynchronous AVR TWI (I2C) master, for Arduino AVR only:
+   - queues write & read transactions & returns immediately
+   - completion is signaled via callback & "isIdle()"
+   - interrupt mode, build with "-DAHTXX_USE_TWI_INTERRUPT", TWI_vect
+     drives the transfer & CPU is free between bytes
+     *"Wire.h" defines its own TWI_vect, interrupt mode implies
+      "AHTXX_NO_WIRE", AHTxx runs all transfers over "AHTxxTransport"
+      & sketch must not include "Wire.h"
+   - polled mode (default), coexists with "Wire.h" by disabling TWI
+     interrupt during own transfers
+     *every "poll()" handles one TWI event, transfer stalls between
+      calls, call "poll()" at least once per byte (~90usec at 100KHz),
+      7-byte frame read needs 9 calls (START, address, 7 bytes), CPU
+      is free only between calls
+   - CPU time freed per transfer is measured on target by
+     "examples/AHTxx_TWICpuTime"
+   - both are build-wide flags, pass -D to every translation unit
+     (PlatformIO "build_flags" or arduino-cli "compiler.cpp.extra_flags"),
+     class layout of "AHTxx" depends on "AHTXX_NO_WIRE"
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_TWI_h
+#define AHTXX_TWI_h
+
+
+#include <Arduino.h>
+
+
+#if defined(AHTXX_USE_TWI_INTERRUPT) && !defined(AHTXX_NO_WIRE)
+#define AHTXX_NO_WIRE                               //TWI_vect belongs to this driver, "Wire.h" can't be linked
+#endif
+
+#if defined(__AVR__) && defined(TWCR)
+
+#define AHTXX_TWI_QUEUE_SIZE        4       //max queued transactions, power of 2
+#define AHTXX_TWI_SPEED_100KHZ      100000  //default I2C bus speed, in Hz
+
+/* TWI transfer results, same as "AHTxx.h" status codes */
+#define AHTXX_TWI_NO_ERROR          0x00    //success, no errors
+#define AHTXX_TWI_ACK_ERROR         0x02    //slave didn't return ACK or arbitration lost
+#define AHTXX_TWI_DATA_ERROR        0x03    //received data smaller than expected
+#define AHTXX_TWI_ERROR             0xFF    //bus error
+
+typedef void (*AHTxxTWICallback)(void *context, uint8_t result);
+
+
+class AHTxxTWI
+{
+  public:
+
+   AHTxxTWI();
+
+   void     begin(uint32_t speed = AHTXX_TWI_SPEED_100KHZ);
+   void     end();
+   bool     write(uint8_t address, const uint8_t *data, uint8_t length, AHTxxTWICallback callback = 0, void *context = 0);
+   bool     read(uint8_t address, uint8_t *data, uint8_t length, AHTxxTWICallback callback = 0, void *context = 0);
+   void     poll();
+   bool     isIdle();
+   uint8_t  getResult();
+   uint32_t getTransferTime();
+   uint16_t getInterruptCount();
+
+   void     handleInterrupt();                    //called from TWI_vect or "poll()", don't call directly
+
+
+  private:
+   typedef struct
+   {
+     uint8_t           address;                   //7-bit address << 1 | R/W bit
+     uint8_t          *data;
+     uint8_t           length;
+     AHTxxTWICallback  callback;
+     void             *context;
+   }
+   AHTXX_TWI_TRANSACTION;
+
+   AHTXX_TWI_TRANSACTION _queue[AHTXX_TWI_QUEUE_SIZE];
+   volatile uint8_t      _head;                   //next free slot
+   volatile uint8_t      _tail;                   //active transaction
+   volatile uint8_t      _index;                  //byte index in active transaction
+   volatile bool         _active;
+   volatile uint8_t      _result;
+   volatile uint32_t     _startTime;
+   volatile uint32_t     _transferTime;
+   volatile uint16_t     _interruptCount;
+
+   bool     _submit(uint8_t address, uint8_t *data, uint8_t length, AHTxxTWICallback callback, void *context);
+   void     _start();
+   void     _control(uint8_t value);
+   void     _finish(uint8_t result);
+};
+
+extern AHTxxTWI AHTxxTwi;                         //single hardware TWI
+
+#endif
+
+#endif
@@ -0,0 +1,215 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "AHTxx.h"
+
+
+/**************************************************************************/
+/*
+    poll()
+
+    Advance pending transfers
+
+    NOTE:
+    - called from "AHTxx::updateAsync()", override if driver needs
+      to be polled, default does nothing
+*/
+/**************************************************************************/
+void AHTxxTransport::poll()
+{
+  //empty
+}
+
+
+/**************************************************************************/
+/*
+    begin()
+
+    Initialize I2C hardware
+
+    NOTE:
+    - called from "AHTxx::begin()" & "AHTxx::clearBus()" in
+      "AHTXX_NO_WIRE" build only, override if driver owns hardware,
+      default does nothing
+    - speed, I2C bus speed, in Hz
+*/
+/**************************************************************************/
+void AHTxxTransport::begin(uint32_t)
+{
+  //empty
+}
+
+
+/**************************************************************************/
+/*
+    end()
+
+    Release SDA/SCL pins from I2C hardware
+
+    NOTE:
+    - called from "AHTxx::clearBus()" before pins are driven, see
+      "begin()" NOTE
+*/
+/**************************************************************************/
+void AHTxxTransport::end()
+{
+  //empty
+}
+
+
+#if !defined(AHTXX_NO_WIRE)
+/**************************************************************************/
+/*
+    AHTxxWireTransport Constructor
+*/
+/**************************************************************************/
+AHTxxWireTransport::AHTxxWireTransport(TwoWire &wire)
+{
+  _wire = &wire;
+}
+
+
+/**************************************************************************/
+/*
+    write()
+
+    Write n-bytes & call callback before return
+
+    NOTE:
+    - blocking, takes ~90usec per byte at 100KHz
+    - true=submitted, callback receives transfer result
+*/
+/**************************************************************************/
+bool AHTxxWireTransport::write(uint8_t address, const uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context)
+{
+  _wire->beginTransmission(address);
+
+  _wire->write(data, length);
+
+  uint8_t result = (_wire->endTransmission(true) == 0) ? AHTXX_NO_ERROR : AHTXX_ACK_ERROR; //collision on I2C bus, sensor didn't return ACK
+
+  if (callback != 0) callback(context, result);
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    read()
+
+    Read n-bytes & call callback before return
+
+    NOTE:
+    - see "write()" NOTE
+*/
+/**************************************************************************/
+bool AHTxxWireTransport::read(uint8_t address, uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context)
+{
+  #if defined(_VARIANT_ARDUINO_STM32_)
+  _wire->requestFrom(address, length);
+  #else
+  _wire->requestFrom(address, length, (uint8_t)true);  //read n-byte to "wire.h" rxBuffer, true-send stop after transmission, cast selects "uint8_t" overload
+  #endif
+
+  uint8_t result = AHTXX_NO_ERROR;
+
+  if (_wire->available() != length)
+  {
+    result = AHTXX_DATA_ERROR;                         //received data smaller than expected
+  }
+  else
+  {
+    for (uint8_t i = 0; i < length; i++)
+    {
+      data[i] = _wire->read();                         //read n-bytes from "wire.h" rxBuffer
+    }
+  }
+
+  if (callback != 0) callback(context, result);
+
+  return true;
+}
+#endif
+
+
+#if defined(__AVR__) && defined(TWCR)
+/**************************************************************************/
+/*
+    AHTxxTWITransport write()
+
+    Queue write on AVR TWI
+
+    NOTE:
+    - call "AHTxxTwi.begin()" before use, "AHTxx::begin()" does it in
+      "AHTXX_NO_WIRE" build
+    - false=queue full
+*/
+/**************************************************************************/
+bool AHTxxTWITransport::write(uint8_t address, const uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context)
+{
+  return AHTxxTwi.write(address, data, length, callback, context);
+}
+
+
+/**************************************************************************/
+/*
+    AHTxxTWITransport read()
+
+    Queue read on AVR TWI
+*/
+/**************************************************************************/
+bool AHTxxTWITransport::read(uint8_t address, uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context)
+{
+  return AHTxxTwi.read(address, data, length, callback, context);
+}
+
+
+/**************************************************************************/
+/*
+    AHTxxTWITransport poll()
+
+    Advance AVR TWI transfer in polled mode
+*/
+/**************************************************************************/
+void AHTxxTWITransport::poll()
+{
+  AHTxxTwi.poll();
+}
+
+
+/**************************************************************************/
+/*
+    AHTxxTWITransport begin()
+
+    Initialize AVR TWI
+*/
+/**************************************************************************/
+void AHTxxTWITransport::begin(uint32_t speed)
+{
+  AHTxxTwi.begin(speed);
+}
+
+
+/**************************************************************************/
+/*
+    AHTxxTWITransport end()
+
+    Disable AVR TWI & release pins
+*/
+/**************************************************************************/
+void AHTxxTWITransport::end()
+{
+  AHTxxTwi.end();
+}
+#endif
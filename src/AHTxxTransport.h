@@ -0,0 +1,84 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Asynchronous I2C transport interface for AHTxx measurement state machine:
+   - submit write/read & get result code via completion callback
+   - AHTxxWireTransport, synchronous adapter over "Wire.h", callback is
+     called before "write()/read()" return
+   - AHTxxTWITransport, interrupt-driven/polled AVR TWI, see "AHTxxTWI.h"
+   - implement "AHTxxTransport" to plug DMA/interrupt I2C drivers of
+     other platforms without touching sensor logic
+   - "-DAHTXX_NO_WIRE" build drops "Wire.h" & AHTxxWireTransport, AHTxx
+     runs blocking functions over transport of constructor too, see
+     "AHTxx::AHTxx()"
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_TRANSPORT_h
+#define AHTXX_TRANSPORT_h
+
+
+#include <Arduino.h>
+
+#include "AHTxxTWI.h"
+
+#if !defined(AHTXX_NO_WIRE)
+#include <Wire.h>
+#endif
+
+
+typedef void (*AHTxxTransportCallback)(void *context, uint8_t result); //result is "AHTXX_NO_ERROR", "AHTXX_ACK_ERROR", etc
+
+
+class AHTxxTransport
+{
+  public:
+
+   virtual     ~AHTxxTransport() {}
+   virtual bool write(uint8_t address, const uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context) = 0;
+   virtual bool read(uint8_t address, uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context) = 0;
+   virtual void poll();
+   virtual void begin(uint32_t speed);
+   virtual void end();
+};
+
+
+#if !defined(AHTXX_NO_WIRE)
+class AHTxxWireTransport : public AHTxxTransport
+{
+  public:
+
+   AHTxxWireTransport(TwoWire &wire = Wire);
+
+   bool     write(uint8_t address, const uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context);
+   bool     read(uint8_t address, uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context);
+
+
+  private:
+   TwoWire *_wire;
+};
+#endif
+
+
+#if defined(__AVR__) && defined(TWCR)
+class AHTxxTWITransport : public AHTxxTransport
+{
+  public:
+
+   bool     write(uint8_t address, const uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context);
+   bool     read(uint8_t address, uint8_t *data, uint8_t length, AHTxxTransportCallback callback, void *context);
+   void     poll();
+   void     begin(uint32_t speed);
+   void     end();
+};
+#endif
+
+#endif
@@ -0,0 +1,139 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include <math.h>
+
+#include "AHTxxUncertainty.h"
+
+
+/**************************************************************************/
+/*
+    _averaged()
+
+    Combine accuracy & repeatability of n averaged samples
+
+    NOTE:
+    - accuracy already contains repeatability, only repeatability
+      part averages down, u = sqrt(acc^2 - rep^2 + rep^2 / n)
+*/
+/**************************************************************************/
+static float _averaged(float accuracy, float repeatability, uint8_t averages)
+{
+  if (averages < 1) averages = 1;
+
+  float variance = (accuracy * accuracy) - (repeatability * repeatability) + ((repeatability * repeatability) / averages);
+
+  return sqrt(variance);
+}
+
+
+/**************************************************************************/
+/*
+    ahtxxTemperatureUncertainty()
+
+    Return temperature uncertainty, in C
+
+    NOTE:
+    - temperature, measured value in C
+    - averages, number of averaged samples or fused sensors
+    - interval, time between measurements in milliseconds, see
+      "AHTxx::getMeasurementInterval()"
+    - +-0.3C in normal range -20C..+60C, linear to +-1.0C at -40C & +85C
+*/
+/**************************************************************************/
+float ahtxxTemperatureUncertainty(float temperature, uint8_t averages, uint32_t interval)
+{
+  float accuracy = AHTXX_TEMPERATURE_ACCURACY;
+
+  if      (temperature < -20) accuracy += (AHTXX_TEMPERATURE_ACCURACY_MAX - AHTXX_TEMPERATURE_ACCURACY) * (-20 - temperature) / 20; //-40C..-20C
+  else if (temperature >  60) accuracy += (AHTXX_TEMPERATURE_ACCURACY_MAX - AHTXX_TEMPERATURE_ACCURACY) * (temperature - 60) / 25; //+60C..+85C
+
+  if (accuracy > AHTXX_TEMPERATURE_ACCURACY_MAX) accuracy = AHTXX_TEMPERATURE_ACCURACY_MAX;
+
+  float uncertainty = _averaged(accuracy, AHTXX_TEMPERATURE_REPEATABILITY, averages);
+
+  if (interval < AHTXX_SELF_HEATING_INTERVAL) uncertainty += AHTXX_SELF_HEATING_ERROR; //bias adds linearly
+
+  return uncertainty;
+}
+
+
+/**************************************************************************/
+/*
+    ahtxxHumidityUncertainty()
+
+    Return relative humidity uncertainty, in %
+
+    NOTE:
+    - humidity & temperature, measured values in % & C
+    - see "ahtxxTemperatureUncertainty()" NOTE
+    - +-2% in 20%..80%, linear to +-3% at 0% & 100%, +1% outside
+      normal temperature range
+    - self-heating bias in T shifts RH by ~6.4% of reading per 1C
+*/
+/**************************************************************************/
+float ahtxxHumidityUncertainty(float humidity, float temperature, uint8_t averages, uint32_t interval)
+{
+  float accuracy = AHTXX_HUMIDITY_ACCURACY;
+
+  if      (humidity < 20) accuracy += (AHTXX_HUMIDITY_ACCURACY_MAX - AHTXX_HUMIDITY_ACCURACY) * (20 - humidity) / 20;
+  else if (humidity > 80) accuracy += (AHTXX_HUMIDITY_ACCURACY_MAX - AHTXX_HUMIDITY_ACCURACY) * (humidity - 80) / 20;
+
+  if (accuracy > AHTXX_HUMIDITY_ACCURACY_MAX) accuracy = AHTXX_HUMIDITY_ACCURACY_MAX;
+
+  if ((temperature < -20) || (temperature > 60)) accuracy += AHTXX_HUMIDITY_RANGE_ERROR;
+
+  float uncertainty = _averaged(accuracy, AHTXX_HUMIDITY_REPEATABILITY, averages);
+
+  if (interval < AHTXX_SELF_HEATING_INTERVAL) uncertainty += humidity * 0.064 * AHTXX_SELF_HEATING_ERROR;
+
+  return uncertainty;
+}
+
+
+/**************************************************************************/
+/*
+    ahtxxDewPoint()
+
+    Return dew point & optionally its uncertainty, in C
+
+    NOTE:
+    - Magnus formula:
+      - g  = ln(RH / 100) + b * T / (c + T)
+      - Td = c * g / (b - g)
+    - uncertainty by first-order propagation, T & RH errors assumed
+      independent:
+      - dTd/dg  = b * c / (b - g)^2
+      - dg/dRH  = 1 / RH
+      - dg/dT   = b * c / (c + T)^2
+    - RH below 0.1% is clamped, dew point is undefined at 0%
+*/
+/**************************************************************************/
+float ahtxxDewPoint(float temperature, float humidity, float temperatureUncertainty, float humidityUncertainty, float *dewPointUncertainty)
+{
+  if (humidity < 0.1) humidity = 0.1;
+
+  float gamma    = log(humidity / 100) + (AHTXX_MAGNUS_B * temperature) / (AHTXX_MAGNUS_C + temperature);
+  float dewPoint = (AHTXX_MAGNUS_C * gamma) / (AHTXX_MAGNUS_B - gamma);
+
+  if (dewPointUncertainty != 0)
+  {
+    float slope        = (AHTXX_MAGNUS_B * AHTXX_MAGNUS_C) / ((AHTXX_MAGNUS_B - gamma) * (AHTXX_MAGNUS_B - gamma));
+    float uHumidity    = humidityUncertainty / humidity;
+    float uTemperature = (AHTXX_MAGNUS_B * AHTXX_MAGNUS_C * temperatureUncertainty) / ((AHTXX_MAGNUS_C + temperature) * (AHTXX_MAGNUS_C + temperature));
+
+    *dewPointUncertainty = slope * sqrt((uHumidity * uHumidity) + (uTemperature * uTemperature));
+  }
+
+  return dewPoint;
+}
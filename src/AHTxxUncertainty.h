@@ -0,0 +1,50 @@
+/***************************************************************************************************/
+/*
+   This is an Arduino library for Aosong ASAIR AHT10/AHT15/AHT20/AHT21/AHT25/AM2301B/AM2311B
+   Digital Humidity & Temperature Sensor
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   Measurement uncertainty estimate:
+   - datasheet accuracy T +-0.3C, RH +-2% inside normal operating range
+     & up to T +-1.0C, RH +-3% at the edges of maximum range
+   - repeatability T +-0.1C, RH +-0.1% averages down with sqrt(n)
+   - self-heating bias if measurements are < 2 seconds apart
+   - dew point with uncertainty propagated from T & RH
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details  - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef AHTXX_UNCERTAINTY_h
+#define AHTXX_UNCERTAINTY_h
+
+
+#include <stdint.h>
+
+
+/* datasheet accuracy */
+#define AHTXX_TEMPERATURE_ACCURACY      0.3     //typical accuracy in normal operating range, in C
+#define AHTXX_TEMPERATURE_ACCURACY_MAX  1.0     //accuracy at -40C & +85C, in C
+#define AHTXX_TEMPERATURE_REPEATABILITY 0.1     //in C
+#define AHTXX_HUMIDITY_ACCURACY         2.0     //typical accuracy RH 20%..80%, in %
+#define AHTXX_HUMIDITY_ACCURACY_MAX     3.0     //accuracy at RH 0% & 100%, in %
+#define AHTXX_HUMIDITY_REPEATABILITY    0.1     //in %
+#define AHTXX_HUMIDITY_RANGE_ERROR      1.0     //extra RH error outside normal T range -20C..+60C, in %
+
+/* self-heating */
+#define AHTXX_SELF_HEATING_INTERVAL     2000    //measurements closer than 2sec heat the sensor, in milliseconds
+#define AHTXX_SELF_HEATING_ERROR        0.1     //self-heating bias, in C
+
+/* Magnus formula coefficients, -45C..+60C */
+#define AHTXX_MAGNUS_B                  17.62
+#define AHTXX_MAGNUS_C                  243.12  //in C
+
+
+float ahtxxTemperatureUncertainty(float temperature, uint8_t averages = 1, uint32_t interval = AHTXX_SELF_HEATING_INTERVAL);
+float ahtxxHumidityUncertainty(float humidity, float temperature, uint8_t averages = 1, uint32_t interval = AHTXX_SELF_HEATING_INTERVAL);
+float ahtxxDewPoint(float temperature, float humidity, float temperatureUncertainty = 0, float humidityUncertainty = 0, float *dewPointUncertainty = 0);
+
+#endif